@@ -0,0 +1,393 @@
+#include "scene.hpp"
+#include "UI.hpp"
+#include "AnimatedTexture.hxx"
+#include "particleSystem.hxx"
+#include "spriteBatch.hxx"
+#include "profiler.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+/* Headless benchmark harness, built with `make bench`.
+ * Fills scenes with synthetic objects, times `Update()` and `Draw()` over many frames on a hidden window, and prints one JSON
+ * object per scenario on stdout:
+ *   {"scenario":"objects","items":10000,"frames":2000,"update":{...},"draw":{...}}
+ * where each timing block holds the mean, percentiles and maximum frame time in microseconds, and the throughput in items per second.
+ *
+ * Options: --frames N --warmup N --objects N --elements N --buttons N --animations N --particles N --only SCENARIO
+ */
+
+namespace
+{
+    // Generated textures are written here, relative to `TEXTURES_PATH`, and removed on exit.
+    const std::string BENCH_TEXTURES = "bench_generated";
+    const int ANIMATION_FRAMES = 8;
+
+    struct Options {
+        int frames     = 2000;
+        int warmup     = 100;
+        int objects    = 10000;
+        int elements   = 2000;
+        int buttons    = 500;
+        int animations = 500;
+        int particles  = 50000;
+        const char *only = nullptr;
+    };
+
+    /**
+     * @brief Moving sprite, standing for a typical gameplay object.
+     */
+    class BenchObject : public GameObject {
+    private:
+        const Texture2D *texture;
+        Vector2 velocity;
+    public:
+        BenchObject(const Texture2D *_texture, Transform2D _transform, Vector2 _velocity) : GameObject(_transform), texture(_texture), velocity(_velocity) {}
+
+        void Update() override
+        {
+            transform.position.x += velocity.x;
+            transform.position.y += velocity.y;
+            if (transform.position.x < 0 || transform.position.x > 1280) velocity.x = -velocity.x;
+            if (transform.position.y < 0 || transform.position.y > 720)  velocity.y = -velocity.y;
+            transform.rotation += 1.0f;
+        }
+        void Draw() const override
+        {
+            DrawSprite(*texture, Rectangle{0, 0, (float)texture->width, (float)texture->height},
+                       Rectangle{transform.position.x, transform.position.y, texture->width * transform.scale, texture->height * transform.scale},
+                       Vector2{texture->width / 2.0f, texture->height / 2.0f}, transform.rotation, WHITE);
+        }
+        bool GetBounds(Rectangle &bounds) const override
+        {
+            // Loose enough to cover any rotation
+            float radius = std::max(texture->width, texture->height) * transform.scale * 0.75f;
+            bounds = Rectangle{transform.position.x - radius, transform.position.y - radius, radius * 2, radius * 2};
+            return true;
+        }
+    };
+
+    /**
+     * @brief Same sprite as `BenchObject`, stored by value in a `Scene::Group()`.
+     */
+    struct BenchSprite {
+        const Texture2D *texture;
+        Transform2D transform;
+        Vector2 velocity;
+
+        void Update()
+        {
+            transform.position.x += velocity.x;
+            transform.position.y += velocity.y;
+            if (transform.position.x < 0 || transform.position.x > 1280) velocity.x = -velocity.x;
+            if (transform.position.y < 0 || transform.position.y > 720)  velocity.y = -velocity.y;
+            transform.rotation += 1.0f;
+        }
+        void Draw() const
+        {
+            DrawSprite(*texture, Rectangle{0, 0, (float)texture->width, (float)texture->height},
+                       Rectangle{transform.position.x, transform.position.y, texture->width * transform.scale, texture->height * transform.scale},
+                       Vector2{texture->width / 2.0f, texture->height / 2.0f}, transform.rotation, WHITE);
+        }
+    };
+
+    /**
+     * @brief Field of moving sprites kept in the scene's `TransformStore`, standing for the same workload as `BenchObject` without a
+     * virtual call per sprite.
+     */
+    class BenchField : public GameObject {
+    private:
+        const Texture2D *texture;
+        TransformStore &store;
+        std::vector<TransformStore::Handle> sprites;
+        std::vector<float> velocity_x, velocity_y; // Indexed like the store's arrays, which never reorder without parented entries.
+    public:
+        BenchField(const Texture2D *_texture, TransformStore &_store) : texture(_texture), store(_store) {}
+
+        void Add(Vector2 position, Vector2 velocity)
+        {
+            sprites.push_back(store.Create(Transform2D{position, 0, 1}, Vector2{(float)texture->width, (float)texture->height}));
+            velocity_x.push_back(velocity.x);
+            velocity_y.push_back(velocity.y);
+        }
+        void Update() override
+        {
+            float *x = store.GetLocalX(), *y = store.GetLocalY(), *rotation = store.GetLocalRotation();
+            for (size_t i = 0; i < store.Size(); i++)
+            {
+                x[i] += velocity_x[i];
+                y[i] += velocity_y[i];
+                if (x[i] < 0 || x[i] > 1280) velocity_x[i] = -velocity_x[i];
+                if (y[i] < 0 || y[i] > 720)  velocity_y[i] = -velocity_y[i];
+                rotation[i] += 1.0f;
+            }
+        }
+        void Draw() const override
+        {
+            Rectangle source = {0, 0, (float)texture->width, (float)texture->height}, dest;
+            Vector2 origin;
+            for (TransformStore::Handle sprite : sprites)
+            {
+                store.GetDrawRect(sprite, dest, origin);
+                DrawSprite(*texture, source, dest, origin, store.GetWorld(sprite).rotation, WHITE);
+            }
+        }
+    };
+
+    /**
+     * @brief Game object wrapping an `AnimatedTexture`.
+     */
+    class BenchAnimation : public GameObject {
+    private:
+        AnimatedTexture animation;
+    public:
+        BenchAnimation(Transform2D _transform, int fps) : GameObject(_transform), animation(BENCH_TEXTURES + "/anim", ANIMATION_FRAMES, fps, true) {}
+
+        AnimatedTexture &GetAnimation() { return animation; }
+        void Update() override { animation.Update(); }
+        void Draw() const override { animation.Draw(transform); }
+    };
+
+    struct Timing {
+        double mean, p50, p90, p99, max; // Microseconds per frame.
+        double items_per_second;
+    };
+
+    Timing Summarize(std::vector<double> &samples, int items)
+    {
+        std::sort(samples.begin(), samples.end());
+        double total = 0;
+        for (double sample : samples) total += sample;
+        auto percentile = [&samples](double p) { return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))]; };
+
+        Timing timing;
+        timing.mean = total / samples.size();
+        timing.p50  = percentile(0.50);
+        timing.p90  = percentile(0.90);
+        timing.p99  = percentile(0.99);
+        timing.max  = samples.back();
+        timing.items_per_second = timing.mean > 0 ? items / (timing.mean * 1e-6) : 0;
+        return timing;
+    }
+
+    void PrintTiming(const char *name, const Timing &timing)
+    {
+        std::printf("\"%s\":{\"mean_us\":%.3f,\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f,\"items_per_s\":%.1f}",
+                    name, timing.mean, timing.p50, timing.p90, timing.p99, timing.max, timing.items_per_second);
+    }
+
+    /**
+     * @brief Time `frames` update and draw cycles of the active scene of @p manager, and print the results.
+     */
+    void Run(const char *scenario, SceneManager &manager, int items, const Options &options)
+    {
+        using clock = std::chrono::steady_clock;
+        std::vector<double> update_us, draw_us;
+        update_us.reserve(options.frames);
+        draw_us.reserve(options.frames);
+
+        for (int frame = 0; frame < options.warmup + options.frames; frame++)
+        {
+            auto start = clock::now();
+            manager.Update();
+            auto middle = clock::now();
+            manager.Draw();
+            auto end = clock::now();
+
+            if (frame < options.warmup) continue;
+            update_us.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+            draw_us.push_back(std::chrono::duration<double, std::micro>(end - middle).count());
+        }
+
+        std::printf("{\"scenario\":\"%s\",\"items\":%d,\"frames\":%d,", scenario, items, options.frames);
+        PrintTiming("update", Summarize(update_us, items));
+        std::printf(",");
+        PrintTiming("draw", Summarize(draw_us, items));
+        std::printf("}\n");
+        std::fflush(stdout);
+    }
+
+    bool Selected(const Options &options, const char *scenario)
+    {
+        return !options.only || std::strcmp(options.only, scenario) == 0;
+    }
+
+    void GenerateTextures()
+    {
+        std::filesystem::create_directories(TEXTURES_PATH / BENCH_TEXTURES);
+        Image block = GenImageColor(32, 32, ORANGE);
+        ExportImage(block, (TEXTURES_PATH / BENCH_TEXTURES / "block.png").string().c_str());
+        UnloadImage(block);
+
+        const Color colors[ANIMATION_FRAMES] = {RED, ORANGE, YELLOW, GREEN, SKYBLUE, BLUE, PURPLE, PINK};
+        for (int i = 0; i < ANIMATION_FRAMES; i++)
+        {
+            Image frame = GenImageColor(24, 24, colors[i]);
+            ExportImage(frame, (TEXTURES_PATH / BENCH_TEXTURES / ("anim" + std::to_string(i + 1) + ".png")).string().c_str());
+            UnloadImage(frame);
+        }
+    }
+
+    Options ParseOptions(int argc, char **argv)
+    {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const char *flag  = argv[i];
+            const char *value = argv[i + 1];
+            if      (!std::strcmp(flag, "--frames"))     options.frames     = std::max(1, std::atoi(value));
+            else if (!std::strcmp(flag, "--warmup"))     options.warmup     = std::max(0, std::atoi(value));
+            else if (!std::strcmp(flag, "--objects"))    options.objects    = std::max(0, std::atoi(value));
+            else if (!std::strcmp(flag, "--elements"))   options.elements   = std::max(0, std::atoi(value));
+            else if (!std::strcmp(flag, "--buttons"))    options.buttons    = std::max(0, std::atoi(value));
+            else if (!std::strcmp(flag, "--animations")) options.animations = std::max(0, std::atoi(value));
+            else if (!std::strcmp(flag, "--particles"))  options.particles  = std::max(0, std::atoi(value));
+            else if (!std::strcmp(flag, "--only"))       options.only       = value;
+            else std::fprintf(stderr, "Unknown option %s\n", flag);
+        }
+        return options;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options = ParseOptions(argc, argv);
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(1280, 720, "rgame bench");
+    SetTargetFPS(0); // Never wait for the next frame
+    camera.zoom = 1.0f;
+
+    GenerateTextures();
+    TextureHandle block = resources.AcquireTexture(BENCH_TEXTURES + "/block.png");
+    std::mt19937 rng(42); // Fixed seed, so every run builds the same scenes
+    std::uniform_real_distribution<float> x_dist(0, 1280), y_dist(0, 720), speed(-2, 2);
+    std::uniform_int_distribution<int> order_dist(MIN_DRAW_ORDER, MAX_DRAW_ORDER - 1);
+
+    {
+        SceneManager manager;
+
+        if (Selected(options, "objects"))
+        {
+            Scene *scene = new Scene();
+            for (int i = 0; i < options.objects; i++)
+            {
+                scene->Emplace<BenchObject>("", &block.Get(), Transform2D{{x_dist(rng), y_dist(rng)}, 0, 1}, Vector2{speed(rng), speed(rng)});
+            }
+            manager.AddScene("objects", scene);
+            manager.LoadScene("objects");
+            Run("objects", manager, options.objects, options);
+        }
+
+        if (Selected(options, "groups"))
+        {
+            Scene *scene = new Scene();
+            ObjectGroup<BenchSprite> &group = scene->Group<BenchSprite>();
+            group.Reserve(options.objects);
+            for (int i = 0; i < options.objects; i++)
+            {
+                group.Emplace(BenchSprite{&block.Get(), Transform2D{{x_dist(rng), y_dist(rng)}, 0, 1}, Vector2{speed(rng), speed(rng)}});
+            }
+            manager.AddScene("groups", scene);
+            manager.LoadScene("groups");
+            Run("groups", manager, options.objects, options);
+        }
+
+        if (Selected(options, "transforms"))
+        {
+            Scene *scene = new Scene();
+            Scene::ObjectHandle handle = scene->Emplace<BenchField>("", &block.Get(), scene->GetTransforms());
+            BenchField &field = static_cast<BenchField&>(scene->GetObject(handle));
+            for (int i = 0; i < options.objects; i++)
+            {
+                field.Add(Vector2{x_dist(rng), y_dist(rng)}, Vector2{speed(rng), speed(rng)});
+            }
+            manager.AddScene("transforms", scene);
+            manager.LoadScene("transforms");
+            Run("transforms", manager, options.objects, options);
+        }
+
+        // Same static menu, drawn element by element and then from a cached render texture
+        for (const char *scenario : {"ui_elements", "ui_cached"})
+        {
+            if (!Selected(options, scenario)) continue;
+            Scene *scene = new Scene();
+            UIContainer *ui = new UIContainer();
+            for (int i = 0; i < options.elements; i++)
+            {
+                UIContainer::ElementHandle handle;
+                if (i % 2) handle = ui->Emplace<UI::Panel>("", Transform2D{{x_dist(rng), y_dist(rng)}, 0, 1}, Vector2{16, 16}, GRAY);
+                else       handle = ui->Emplace<UI::ImageDisplay>("", BENCH_TEXTURES + "/block.png", Transform2D{{x_dist(rng), y_dist(rng)}, 0, 1});
+                ui->GetElement(handle).SetDrawOrder(order_dist(rng));
+            }
+            ui->SetCached(std::strcmp(scenario, "ui_cached") == 0);
+            scene->AddUi("ui", ui);
+            manager.AddScene(scenario, scene);
+            manager.LoadScene(scenario);
+            Run(scenario, manager, options.elements, options);
+        }
+
+        if (Selected(options, "buttons"))
+        {
+            Scene *scene = new Scene();
+            UIContainer *ui = new UIContainer();
+            for (int i = 0; i < options.buttons; i++)
+            {
+                UIContainer::ElementHandle handle = ui->Emplace<UI::Button>("", BENCH_TEXTURES + "/block.png", Transform2D{{x_dist(rng), y_dist(rng)}, 0, 1});
+                ui->GetElement(handle).SetDrawOrder(order_dist(rng));
+            }
+            scene->AddUi("ui", ui);
+            manager.AddScene("buttons", scene);
+            manager.LoadScene("buttons");
+            Run("buttons", manager, options.buttons, options);
+        }
+
+        if (Selected(options, "animations"))
+        {
+            Scene *scene = new Scene();
+            std::vector<AnimatedTexture*> animations;
+            for (int i = 0; i < options.animations; i++)
+            {
+                Scene::ObjectHandle handle = scene->Emplace<BenchAnimation>("", Transform2D{{x_dist(rng), y_dist(rng)}, 0, 1}, 4 + i % 20);
+                BenchAnimation &object = static_cast<BenchAnimation&>(scene->GetObject(handle));
+                object.GetAnimation().Play();
+                animations.push_back(&object.GetAnimation());
+            }
+            AnimatedTexture::InitializeShared(animations);
+            manager.AddScene("animations", scene);
+            manager.LoadScene("animations");
+            Run("animations", manager, options.animations, options);
+        }
+
+        if (Selected(options, "particles"))
+        {
+            // Steady state: emitted as fast as they expire, always at the cap
+            ParticleEmitter emitter;
+            emitter.rate         = options.particles;
+            emitter.lifetime_min = 0.5f;
+            emitter.lifetime_max = 1.5f;
+            emitter.gravity      = Vector2{0, 200};
+            emitter.spin_max     = 180;
+            emitter.scale_end    = 0.25f;
+            Scene *scene = new Scene();
+            Scene::ObjectHandle handle = scene->Emplace<ParticleSystem>("", emitter, options.particles, Transform2D{{640, 360}, 0, 1});
+            ParticleSystem &particles = static_cast<ParticleSystem&>(scene->GetObject(handle));
+            particles.SetTexture(block);
+            particles.Emit(options.particles);
+            manager.AddScene("particles", scene);
+            manager.LoadScene("particles");
+            Run("particles", manager, options.particles, options);
+        }
+
+        manager.LoadScene("scene_default");
+    }
+
+    block.Reset();
+    std::filesystem::remove_all(TEXTURES_PATH / BENCH_TEXTURES);
+    CloseWindow();
+    return 0;
+}
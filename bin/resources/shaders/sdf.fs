@@ -0,0 +1,18 @@
+#version 330 core
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+out vec4 finalColor;
+
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Glyph atlases store the distance to the glyph edge in the alpha channel, with 0.5 on the edge itself
+void main()
+{
+    float dist = texture(texture0, fragTexCoord).a - 0.5;
+    // Smooth over one screen pixel, whatever size the glyph is drawn at
+    float width = length(vec2(dFdx(dist), dFdy(dist)));
+    float alpha = smoothstep(-width, width, dist);
+    finalColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;
+}
@@ -2,7 +2,11 @@
 #define ANIMATED_TEXTURE_H
 
 #include "globals.hxx"
-#include <chrono>
+#include "textureAtlas.hxx"
+#include "resourceManager.hxx"
+#include "streamingBudget.hxx"
+#include "transformStore.hxx"
+#include <memory>
 
 
 /**
@@ -15,12 +19,18 @@
  *
  * The animation system is controlled through several public methods, including:
  * - `Play()`, `Pause()`, `Stop()`, `Resume()` to control the animation playback.
- * - `Update()` to progress the animation based on elapsed time.
  * - `Draw()` to render the current frame of the animation to the screen.
+ * - `SetSpeed()` to play the animation faster or slower.
+ *
+ * The current frame is derived from `frame_clock` whenever it is needed, from the time playback started at and it's speed, so
+ * animations don't have to be updated every frame to advance, and never fall behind when the frame rate drops below their own: frames
+ * that should have been shown between two draws are simply skipped. `Update()` is only required in streaming mode.
  * 
  * Key features include:
  * - Frame-based animation with adjustable frame rate.
  * - Support for looping and pausing the animation.
+ * - Optional atlas mode, where the frames of one or more animations are packed into a single shared `TextureAtlas`.
+ * - Optional streaming mode, where only a window of frames ahead of the current one is kept on the GPU, within `streaming_budget`.
  *
  * @note This class relies on a naming convention for texture files (e.g., "texture_name_0.png", "texture_name_1.png", etc.) to load the sequence of frames.
  */
@@ -32,17 +42,39 @@
  */
 class AnimatedTexture{
 private:
-    std::vector<Texture2D> frames;                           // A vector storing the texture data of each frame.
-    std::chrono::milliseconds ms_per_frame;                  // Time between frames. Inversely proportional to `fps`.
-    std::chrono::steady_clock::time_point last_frame_change; // Time since `current_frame` was last increased.
-    int current_frame;                                       // Index of the currently active frame.
+    std::vector<TextureHandle> frames;                       // Shared handles to the texture of each frame. Unused in atlas mode, empty for evicted frames in streaming mode.
+    std::shared_ptr<TextureAtlas> atlas;                     // Atlas holding all frames, or @b nullptr if frames are separate textures.
+    std::vector<Rectangle> regions;                          // Location of each frame inside `atlas`.
+    double seconds_per_frame;                                // Time between frames. Inversely proportional to `fps`.
+    double anchor_time;                                      // `frame_clock` time at which playback was last started, paused, reset or changed speed.
+    double anchor_position;                                  // Playback position at `anchor_time`, in frames since frame 0.
+    double speed;                                            // Playback rate multiplier.
+    int current_frame;                                       // Index of the active frame as of the last `Update()`. Used by streaming mode.
     bool loop;                                               // Whether to reset the index to 0 after reaching `frames.size()`.
     bool play;                                               // Whether the animation is playing.
 
     std::string texture_names; // Auxiliary variable for texture initialization.
     bool initialized;          // Whether the texture is correctly initialized.
-    
+    mutable bool frames_ready; // Whether every frame finished loading. Only @b false while an asynchronous initialization is pending.
+
+    bool                streaming;       // Whether frames are streamed in and out instead of all being kept loaded.
+    int                 stream_window;   // Number of frames kept loaded from `current_frame` on, in streaming mode.
+    int                 displayed_frame; // Last loaded frame reached by `current_frame`, the one drawn in streaming mode.
+    std::vector<int>    streamed;        // Indices of the frames holding a texture handle, loaded or not, in streaming mode.
+    std::vector<size_t> frame_bytes;     // Bytes charged to `streaming_budget` for each frame. Zero until the frame is loaded.
+    size_t              frame_estimate;  // Size of the last loaded frame, used to check requests against `streaming_budget`.
+    StreamingCharge     charge;          // Bytes charged to `streaming_budget` for all frames.
+
     void LoadFrames(std::string texture_name, int frame_count);
+    double GetPosition() const;
+    void Anchor();
+    void QueueFrames(TextureAtlas &target, std::vector<int> &indices) const;
+    std::string FramePath(int index) const;
+    bool InWindow(int index) const;
+    void EvictFrame(int index);
+    bool EvictBehind();
+    void Stream();
+    void StopStreaming();
 public:
     /** 
      * @brief Default constructor, creates the AnimatedTextue as
@@ -61,16 +93,58 @@ public:
     /**
      * @brief Correctly cleans all memory reserved by the object.
      */
-    ~AnimatedTexture();
+    ~AnimatedTexture() = default;
 
     /**
      * @brief Initialize the texture's frames.
+     * @param use_atlas Whether to pack all frames into a single atlas texture instead of loading one texture per frame.
+     * @note Function must be called after window initialization.
+     */
+    void Initialize(bool use_atlas = false);
+    /**
+     * @brief Initialize the frames of multiple @b AnimatedTexture objects, packing all of them into one shared atlas texture.
+     * @param textures The textures to initialize. They all keep the atlas alive for as long as they exist.
+     * @note If the frames do not fit in a single atlas, every texture falls back to loading one texture per frame.
      * @note Function must be called after window initialization.
      */
-    void Initialize();
+    static void InitializeShared(const std::vector<AnimatedTexture*> &textures);
+    /**
+     * @brief Initialize the texture's frames without blocking, decoding them on `asset_loader`'s worker threads.
+     * @note The texture is not drawn until all of it's frames have been uploaded, see `IsInitialized()`.
+     * @note Function must be called after window initialization.
+     */
+    void InitializeAsync();
+    /**
+     * @brief Initialize the texture in streaming mode, for animations too long to keep all of their frames on the GPU.
+     * @param window Number of frames, starting at the current one, decoded ahead on `asset_loader`'s worker threads and kept loaded.
+     * @details Frames behind the current one are unloaded by `Update()`, except for looping animations, which keep them for the next
+     * loop for as long as `streaming_budget` is not exceeded. Frames ahead are only requested while they fit in `streaming_budget`.
+     * If playback outruns decoding, the last loaded frame keeps being drawn.
+     * @note The texture is not drawn until it's first frame has been uploaded, see `IsInitialized()`.
+     * @note Function must be called after window initialization.
+     */
+    void InitializeStreaming(int window = 8);
+    /**
+     * @brief Check whether the texture is in streaming mode, see `InitializeStreaming()`.
+     */
+    bool IsStreaming() const;
+    /**
+     * @brief Get the number of frames currently loaded, or being loaded.
+     */
+    size_t GetResidentFrameCount() const;
+    /**
+     * @brief Get the atlas holding the frames.
+     * @return The atlas, or @b nullptr if the texture is not in atlas mode.
+     */
+    const std::shared_ptr<TextureAtlas> &GetAtlas() const;
+    /**
+     * @brief Get the location of each frame inside the atlas returned by `GetAtlas()`.
+     * @return The regions, in frame order. Empty if the texture is not in atlas mode.
+     */
+    const std::vector<Rectangle> &GetRegions() const;
     /**
      * @brief Check the initialization state.
-     * @return @b True if the texture is ready to be drawn. @b False otherwise.
+     * @return @b True if the texture is ready to be drawn, i.e. initialized and with all of it's frames loaded. @b False otherwise.
      * @note If @b false, the texture will not be rendered.
      */
     bool IsInitialized() const;
@@ -98,6 +172,26 @@ public:
      * @note If the @b AnimatedTexture was previously unpaused, this function will not pause it.
      */
     void Reset();
+    /**
+     * @brief Set the playback rate multiplier.
+     * @param _speed The new multiplier. @b 1 plays the animation at it's own fps, @b 2 twice as fast... Negative values are treated as 0.
+     * @note Takes effect from the current frame on, without jumping.
+     */
+    void SetSpeed(double _speed);
+    /**
+     * @brief Get the playback rate multiplier.
+     */
+    double GetSpeed() const;
+    /**
+     * @brief Get the index of the frame that should be displayed now, according to `frame_clock`.
+     * @note Non-looping animations stay on their last frame once they reach it.
+     */
+    int  GetCurrentFrame() const;
+    /**
+     * @brief Check whether a non-looping animation played it's last frame to the end.
+     * @return @b Always @b false for looping animations.
+     */
+    bool IsFinished() const;
 
     /**
      * @brief Draw the @b AnimatedTexture.
@@ -105,7 +199,16 @@ public:
      */
     void Draw(Transform2D transform) const;
     /**
-     * @brief Update the @b AnimatedTexture. Carries out all the logic for frame changing and time calculation.
+     * @brief Draw the @b AnimatedTexture into the rectangle of a `TransformStore` entry, as of the store's last update.
+     * @param store Store holding the entry, e.g. `Scene::GetTransforms()`.
+     * @param entry Entry to draw at. It's size should be the size of a frame.
+     */
+    void Draw(const TransformStore &store, TransformStore::Handle entry) const;
+    /**
+     * @brief Update the @b AnimatedTexture. Only does something in streaming mode, where it unloads the frames left behind and requests
+     * the ones ahead.
+     * @note Time is read from `frame_clock`, so animations only advance when the clock does. Frames are derived from it when drawn, so
+     * textures outside of streaming mode can skip their updates altogether.
      */
     void Update();
 };
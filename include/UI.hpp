@@ -5,7 +5,21 @@
 #include "globals.hxx"
 #include <map>
 #include <functional>
+#include <charconv>
+#include <type_traits>
 #include "gameObject.hxx"
+#include "renderQueue.hxx"
+#include "slotMap.hxx"
+#include "objectPool.hxx"
+#include "resourceManager.hxx"
+#include "fontManager.hxx"
+#include "inputRouter.hxx"
+#include "spatialHash.hxx"
+#include "uiLayout.hxx"
+#include "memoryStats.hxx"
+
+class Profiler;
+class UIContainer;
 
 
 /**
@@ -19,6 +33,7 @@
  * ## Classes:
  * - `UIElement`: A base class for all UI elements. Handles the common properties and functionality for UI components such as draw order, visibility, and enabling/disabling update logic.
  * - `UIContainer`: A container for managing and rendering multiple `UIElement` objects. It is responsible for the centralized management of UI elements, including updating and drawing all contained elements.
+ * - `UILayout`: An optional tree of anchors, stacks and grids owned by every `UIContainer`, placing it's elements instead of absolute transforms.
  * 
  * ## UI Components in the `UI` Namespace:
  * - `Button`: A clickable button that can be pressed and released.
@@ -45,6 +60,14 @@ protected:
     int  draw_order; // Defines the drawing priority, if 2 elements have different draw orders the one with the higher order will be drawn above the other one.
     bool active;     // Determines whether the `UIElement` should be drawn.
     bool enabled;    // Determines whether the `UIElement` should update.
+
+    bool dirty;      // Whether the `UIElement` changed since it's last update. Static elements are only updated when dirty.
+    bool blocks_pointer; // Whether the `UIElement` stops the pointer from reaching what is drawn below it while shown.
+
+    UIContainer *owner; // Container holding this element. Notified when `draw_order` or the element's appearance changes.
+    SlotHandle layout_node; // Node of `owner`'s layout placing this element, or an invalid handle.
+    friend class UIContainer;
+    friend class UILayout;
 public:
     /**
      * @brief Create a new, empty UIElement.
@@ -102,7 +125,65 @@ public:
      * @return @b True if the next `Update()` call will run the update logic. @b False otherwise.
      */
     bool IsEnabled() const;
-    
+
+    /**
+     * @brief Flag the `UIElement` as changed, so it is updated on the next `UIContainer::Update()` and redrawn by cached containers.
+     * @note Called by all setters. Elements whose appearance changes on their own (e.g. during `Update()`) must call it themselves.
+     */
+    void MarkDirty();
+    /**
+     * @brief Check whether the `UIElement` changed since it's last update.
+     */
+    bool IsDirty() const;
+    /**
+     * @brief Whether the `UIElement` only needs updating after it changed.
+     * @return @b False by default. Elements returning @b true are skipped by `UIContainer::Update()` while they are not dirty.
+     */
+    virtual bool IsStatic() const { return false; }
+    /**
+     * @brief Whether the `UIElement` receives pointer events.
+     * @return @b False by default. Elements returning @b true are hit tested by their container using the bounds given by
+     * `GetBounds()`, and notified through `OnPointerEvent()`.
+     */
+    virtual bool IsInteractive() const { return false; }
+    /**
+     * @brief Make the `UIElement` stop the pointer from reaching the elements and containers drawn below it, while it is shown.
+     * @param enabled If @b true, the element is hit tested like interactive ones using the bounds given by `GetBounds()`, and captures
+     * the pointer when it is on top, e.g. for the opaque background of a modal dialog. Disabled by default.
+     * @note Non-interactive elements blocking the pointer receive no pointer events.
+     */
+    void SetBlocksPointer(bool enabled);
+    /**
+     * @brief Check whether the `UIElement` stops the pointer from reaching what is drawn below it.
+     */
+    bool BlocksPointer() const;
+    /**
+     * @brief Handle a pointer transition. Only called on interactive elements, and only when their state changes.
+     * @param event The transition.
+     */
+    virtual void OnPointerEvent(PointerEvent event) { (void)event; }
+
+    /**
+     * @brief Get the size the element wants from it's container's layout, in pixels.
+     * @return The size of the bounds given by `GetBounds()` by default, or zero for elements without bounds.
+     * @note Elements whose size changes must call `MarkDirty()`, so their layout node is measured again.
+     */
+    virtual Vector2 GetLayoutSize() const;
+    /**
+     * @brief Move the element into the rectangle computed by it's container's layout. Only called when said rectangle changes.
+     * @param rect Rectangle given to the element, in screen space.
+     * @note Moves the top left corner of the element to the rectangle's by default. Elements positioned differently (e.g. centered
+     * ones) or able to stretch override it.
+     */
+    virtual void    Place(Rectangle rect);
+
+    using GameObject::GetTransform;
+    /**
+     * @brief Get a reference to the element's `transform` data, flagging the element as dirty.
+     * @return A @b non-constant reference to the element's `transform` data.
+     */
+    Transform2D &GetTransform();
+
     /**
      * @brief Draw the `UIElement`.
      */
@@ -120,15 +201,93 @@ public:
  * pointer to an object, said object's ownership will be passed to the respective `UIContainer` for centralized memory management.
  */
 class UIContainer {
+public:
+    /**
+     * @brief Stable identifier of a `UIElement` stored in a `UIContainer`.
+     */
+    using ElementHandle = SlotHandle;
 private:
     /**
-     * @brief Container storing all `UIElement` objects and their `std::string` identifiers.
+     * @brief Type-segregated pools backing the elements created through `Emplace()`. Released all at once on destruction.
+     */
+    PoolRegistry<UIElement> element_pools;
+    /**
+     * @brief Dense storage of all `UIElement` objects. Iterated linearly by `Update()` and `Draw()`.
+     */
+    SlotMap<OwnedPtr<UIElement>> elements;
+    /**
+     * @brief Side index from `std::string` identifiers to `elements` handles. Only used by the identifier based methods.
+     */
+    HandleIndex element_ids;
+    /**
+     * @brief Stored elements sorted by draw order. Rebuilt on the next `Draw()` after an element is added, removed or reordered.
      */
-    std::map<std::string, UIElement*> elements;
+    mutable RenderQueue<UIElement> render_queue;
     /**
      * @brief Order in which the `UIContainer` will be drawn.
      */
     int draw_order;
+    /**
+     * @brief Render queue of the `Scene` holding this container. Invalidated when `draw_order` changes.
+     */
+    RenderQueue<UIContainer> *owner_queue;
+    /**
+     * @brief Profiler section names of `Update()` and `Draw()`. Set to include the container's identifier when added to a `Scene`.
+     */
+    const char *profile_update_name, *profile_draw_name;
+    /**
+     * @brief Whether the container is drawn from `cache`, see `SetCached()`.
+     */
+    bool cached;
+    /**
+     * @brief Screen sized render texture holding the last rendering of all elements, when `cached` is @b true.
+     */
+    mutable RenderTexture2D cache;
+    /**
+     * @brief Whether `cache` holds the current state of all elements.
+     */
+    mutable bool cache_valid;
+    /**
+     * @brief Bounds of the interactive elements, used to find the element under the pointer.
+     */
+    SpatialHash pointer_targets;
+    /**
+     * @brief Interactive elements being hovered and pressed. Invalid handles if there are none.
+     */
+    ElementHandle hovered, pressed;
+    /**
+     * @brief Value of `ResourceManager::GetReloadCount()` at the last update. Elements are updated again when resources were reloaded.
+     */
+    size_t resource_reloads;
+    /**
+     * @brief Layout placing some or all of the elements. Laid out at the start of every `Update()`.
+     */
+    UILayout layout;
+    friend class Scene;
+    friend class SceneFile;
+    friend class UIElement;
+
+    /**
+     * @brief Draw all visible elements in draw order.
+     */
+    void DrawElements() const;
+    /**
+     * @brief Update the bounds of @p element in `pointer_targets`. Elements at `MAX_DRAW_ORDER` are left out, as they are not drawn.
+     */
+    void IndexElement(ElementHandle handle, const UIElement &element);
+    /**
+     * @brief Find the topmost visible and enabled interactive element under @p point.
+     * @return It's handle, or an invalid handle if there is none.
+     */
+    ElementHandle HitTest(Vector2 point) const;
+    /**
+     * @brief Send the pointer transitions of this update to the hovered and pressed elements.
+     */
+    void DispatchInput();
+    /**
+     * @brief Add the container's counts and heap bytes to @p stats, and it's textures to @p textures.
+     */
+    void AccumulateMemory(MemoryStats &stats, TextureSet &textures) const;
 public:
     /**
      * @brief Default constructor. Creates an empty `UIContainer` object with no elements and a `draw_order` of zero.
@@ -143,27 +302,93 @@ public:
      * @brief Store a new `UIElement` with an identifier ` @p id `.
      * @param id String identifier of the @p _element.
      * @param _element Pointer to the `UIElement` that will be stored.
+     * @return A handle to the stored element, or an invalid handle if @p id was already in use.
      * @note Ownership of @p _element will be passed to the `UIContainer` object.
+     * @warning If @p id was already in use, @p _element is @b not stored and ownership stays with the caller.
+     */
+    ElementHandle AddElement(const std::string &id, UIElement* _element);
+    /**
+     * @brief Store a new `UIElement` without a `std::string` identifier.
+     * @param _element Pointer to the `UIElement` that will be stored.
+     * @return A handle to the stored element. This is the only way of accessing it later on.
+     * @note Ownership of @p _element will be passed to the `UIContainer` object.
+     */
+    ElementHandle AddElement(UIElement* _element);
+    /**
+     * @brief Construct a new `UIElement` of type @p T directly inside the container's pool for said type.
+     * @tparam T Type of the element to create. Must derive from `UIElement`.
+     * @param id String identifier of the new element. If empty, the element is stored without a `std::string` identifier.
+     * @param args Arguments forwarded to the constructor of @p T.
+     * @return A handle to the new element, or an invalid handle if @p id was already in use.
+     * @note Creating and removing pooled elements does not go through the global allocator.
      */
-    void AddElement(std::string id, UIElement* _element);
+    template <typename T, typename... Args>
+    ElementHandle Emplace(const std::string &id, Args&&... args);
     /**
      * @brief Remove an element given by it's unique identifier.
      * @param id String identifier of the desired `UIElement`.
      * @warning The removed element's memory will also be liberated! Plan accordingly!
      */
-    void RemoveElement(std::string id);
+    void RemoveElement(const std::string &id);
+    /**
+     * @brief Remove an element given the `StringId` of it's identifier.
+     * @param id `StringId` of the desired `UIElement`'s identifier.
+     * @warning The removed element's memory will also be liberated! Plan accordingly!
+     */
+    void RemoveElement(StringId id);
+    /**
+     * @brief Remove an element given by it's handle.
+     * @param handle Handle of the desired `UIElement`.
+     * @warning The removed element's memory will also be liberated! Plan accordingly!
+     */
+    void RemoveElement(ElementHandle handle);
     /**
      * @brief Get a reference to a stored `UIElement`.
      * @param id String identifer of the desired `UIElement`.
      * @return A @b non-constant reference to the `UIElement` identified by @p id.
      */
-    UIElement              &GetElement(std::string id);
+    UIElement              &GetElement(const std::string &id);
     /**
      * @brief Get a @b constant reference to a stored `UIElement`.
      * @param id String identifier of the desired `UIElement`.
      * @return A @b constant reference to the `UIElement` identified by @p id.
      */
-    const UIElement        &GetElement(std::string id) const;
+    const UIElement        &GetElement(const std::string &id) const;
+    /**
+     * @brief Get a reference to a stored `UIElement` without allocating nor comparing strings.
+     * @param id `StringId` of the desired `UIElement`'s identifier, e.g. `"play_button"_sid`.
+     * @return A @b non-constant reference to said `UIElement`.
+     */
+    UIElement              &GetElement(StringId id);
+    /**
+     * @brief Get a @b constant reference to a stored `UIElement` without allocating nor comparing strings.
+     * @param id `StringId` of the desired `UIElement`'s identifier.
+     * @return A @b constant reference to said `UIElement`.
+     */
+    const UIElement        &GetElement(StringId id) const;
+    /**
+     * @brief Get a reference to a stored `UIElement`.
+     * @param handle Handle of the desired `UIElement`.
+     * @return A @b non-constant reference to the `UIElement` referred to by @p handle.
+     */
+    UIElement              &GetElement(ElementHandle handle);
+    /**
+     * @brief Get a @b constant reference to a stored `UIElement`.
+     * @param handle Handle of the desired `UIElement`.
+     * @return A @b constant reference to the `UIElement` referred to by @p handle.
+     */
+    const UIElement        &GetElement(ElementHandle handle) const;
+    /**
+     * @brief Get the handle of a stored `UIElement`.
+     * @param id String identifier of the desired `UIElement`.
+     * @return The handle of said element, or an invalid handle if there is no element with identifier @p id.
+     */
+    ElementHandle           GetElementHandle(const std::string &id) const;
+    /**
+     * @brief Get the handle of the stored `UIElement` whose identifier hashes to @p id.
+     * @return The handle of said element, or an invalid handle if there is none.
+     */
+    ElementHandle           GetElementHandle(StringId id) const;
 
     /**
      * @brief Get this `UIContainer` object's `draw_order`.
@@ -179,11 +404,49 @@ public:
     void SetDrawOrder(int _order);
 
     /**
-     * @brief Calls the `Update()` method on all stored `UIElement` objects.
+     * @brief Get the container's layout, to place elements with anchors, stacks and grids instead of absolute positions.
+     * @return A @b non-constant reference to the layout.
+     * @note Only the nodes that changed are laid out again, by the next `Update()`, before the elements are updated.
+     */
+    UILayout       &GetLayout();
+    /**
+     * @brief Get a @b constant reference to the container's layout.
+     */
+    const UILayout &GetLayout() const;
+
+    /**
+     * @brief Lays out the elements that changed, calls the `Update()` method on all stored `UIElement` objects, and dispatches the
+     * pointer state sampled by `input_router`.
+     * @note Only the topmost interactive element under the pointer receives events, and only if no container updated earlier in the
+     * same update captured the pointer. `Scene` updates it's containers from the topmost to the bottommost.
      */
     void Update();
     /**
-     * @brief Calls the `Draw()` method on all stored `UIElement` objects.
+     * @brief Enable or disable drawing the container from a cached render texture.
+     * @param enabled If @b true, elements are rendered into a screen sized texture, and the container is drawn as that single texture
+     * until one of it's elements is marked dirty. Best suited to static menus.
+     * @note Cached elements are blended into a transparent texture first, so semi-transparent elements may look slightly different.
+     * @warning Elements that change their appearance without calling `UIElement::MarkDirty()` are not redrawn while cached.
+     */
+    void SetCached(bool enabled);
+    /**
+     * @brief Check whether the container is drawn from a cached render texture.
+     */
+    bool IsCached() const;
+    /**
+     * @brief Re-render the cached texture on the next `Draw()`, e.g. after something the elements depend on changed.
+     */
+    void InvalidateCache();
+
+    /**
+     * @brief Get the number of elements and the memory held by the container.
+     * @note Includes the cached render texture, and the textures elements report through `GameObject::CollectTextures()`.
+     */
+    MemoryStats GetMemoryStats() const;
+
+    /**
+     * @brief Calls the `Draw()` method on all stored `UIElement` objects, following their `draw_order`.
+     * @note Elements with a `draw_order` of `MAX_DRAW_ORDER` are not drawn, nor hit tested. Elements sharing a `draw_order` are drawn in the order they were added.
      */
     void Draw() const;
 
@@ -202,6 +465,25 @@ public:
     void SetAllVisibilityTo(bool value);
 };
 
+template <typename T, typename... Args>
+UIContainer::ElementHandle UIContainer::Emplace(const std::string &id, Args&&... args)
+{
+    static_assert(std::is_base_of<UIElement, T>::value, "UIContainer::Emplace() requires a type derived from UIElement");
+    if (!id.empty() && element_ids.Find(StringId(id)).IsValid())
+        return ElementHandle{};
+
+    ObjectPool<T, UIElement> &pool = element_pools.Get<T>();
+    T *element = pool.Create(std::forward<Args>(args)...);
+    element->owner = this;
+    render_queue.Invalidate();
+    InvalidateCache();
+
+    ElementHandle handle = elements.Insert(OwnedPtr<UIElement>{element, &pool});
+    if (!id.empty())
+        element_ids.Bind(id, handle);
+    return handle;
+}
+
 /**
  * @brief Namespace containing all child classes of `UIElement`.
  */
@@ -216,29 +498,67 @@ namespace UI
      */
     class Button : public UIElement {
     private:
-        Texture2D texture;                      /** @brief Base `Button` texture.                                                 */
+        TextureHandle texture;                  /** @brief Base `Button` texture, padded to leave room for the outline.           */
         static Color TINT_PRESS;                /** @brief Tint to apply to the texture when `Button` is pressed.                 */
+        static constexpr int TEXTURE_PADDING = 4; /** @brief Transparent pixels added around the texture for the outline.       */
         bool hover;                             /** @brief Whether the mouse is hovering over the `Button`.                       */
         bool press;                             /** @brief Whether `MOUSE_BUTTON_LEFT` is being pressed while `hover` is @b true. */
+        bool release;                           /** @brief Whether the `Button` was released during the last update.              */
         Rectangle hitbox;                       /** @brief Rectangle that defines the bounds of the `Button`                      */
         std::function<void()> callbackFunction; /** @brief Function to be called when the `Button` is released.                   */
+        float outline_size;                     /** @brief Thickness of the hover outline, in texels.                             */
+        TextureHandle hover_texture;            /** @brief Cached hovered variant of `texture`. Built by the first hovered update. */
+        TextureHandle press_texture;            /** @brief Cached pressed variant of `texture`. Built along with `hover_texture`. */
+        static bool variant_caching;            /** @brief Whether hovered buttons are drawn from cached variants.                */
         /**
          * @brief Auxiliary function for initializing `Button` parameters.
          */
-        void InitButton();   
+        void InitButton();
+        /**
+         * @brief Auxiliary function that computes `hitbox` from the `Button` object's `transform` data.
+         */
+        void UpdateHitbox();
         /**
-         * @brief Auxiliary function for initializing the `Button` texture.
+         * @brief Auxiliary function for initializing the `Button` texture from an already loaded texture.
+         * @param _texture Texture to pad. It is unloaded and replaced by the padded version.
          */    
-        void TextureSetup();
+        void TextureSetup(Texture2D _texture);
+        /**
+         * @brief Auxiliary function that adds `TEXTURE_PADDING` transparent pixels around @p img.
+         */
+        static Image PadImage(Image img);
+        /**
+         * @brief Auxiliary function that applies the effect of `button_shader` to a padded image, at `DEFAULT_OUTLINE_SIZE`.
+         * @param padded Image to outline and tint. It is unloaded.
+         * @param pressed Whether to darken the image, like a pressed button, instead of brightening it, like a hovered one.
+         */
+        static Image BuildVariant(Image padded, bool pressed);
+        /**
+         * @brief Auxiliary function building `hover_texture` and `press_texture` from the padded `texture`.
+         */
+        void BuildVariants();
+        /**
+         * @brief Auxiliary function returning the texture file `texture` was loaded from, or an empty string for buttons created from a `Texture2D`.
+         */
+        std::string GetTexturePath() const;
 
 
     public:
+        static constexpr float DEFAULT_OUTLINE_SIZE = 0.75f; /** @brief Default thickness of the hover outline, in texels. */
+
         /**
          * @brief Create a new `Button` object with a texture given by ` @p _texture `, with a transform given by ` @p _transform ` and with a default callback.
          * @param _texture Texture that defines how the `Button` object should be drawn.
          * @param _transform Transform that defines the `Button` object.
          */
         Button(Texture2D _texture, Transform2D _transform);
+        /**
+         * @brief Create a new `Button` object with a texture file shared through the `ResourceManager`.
+         * @param texture_path Path of the texture file, relative to `TEXTURES_PATH`.
+         * @param _transform Transform that defines the `Button` object.
+         * @note Buttons created from the same @p texture_path share a single padded texture.
+         */
+        Button(const std::string &texture_path, Transform2D _transform);
 
         /**
          * @brief Check whether the `Button` is being pressed.
@@ -247,8 +567,7 @@ namespace UI
         bool IsPressed() const;
         /**
          * @brief Check whether the `Button` object is no longer being pressed.
-         * @return @b True if the `Button` object is not being pressed in the
-         * current update cycle but was in the previous one. @b False otherwise.
+         * @return @b True if the `Button` object was released (and it's callback called) during the last update. @b False otherwise.
          */
         bool IsReleased() const;
         /**
@@ -265,8 +584,55 @@ namespace UI
         void DefineOnPressCallback(std::function<void()> callback);
 
         /**
-         * @brief Run the updating logic on the `Button` object. Calculates `hover` 
-         * and `press`, and determine if the `callbackFunction` should be called.
+         * @brief Set the thickness of the outline drawn around the `Button` while hovered.
+         * @param thickness The new thickness, in texels of the button texture.
+         * @note Cached variants only exist at `DEFAULT_OUTLINE_SIZE`. At any other thickness, the outline is drawn by `button_shader`.
+         */
+        void  SetOutlineSize(float thickness);
+        /**
+         * @brief Get the thickness of the hover outline, in texels.
+         */
+        float GetOutlineSize() const;
+        /**
+         * @brief Enable or disable cached variants for every `Button`. Enabled by default.
+         * @param enabled If @b true, the hovered and pressed looks of a button are rendered once into textures, shared by buttons
+         * created from the same file, and hovered buttons are then drawn as plain sprites. If @b false, they are drawn through
+         * `button_shader` every frame.
+         */
+        static void SetVariantCaching(bool enabled);
+
+        /**
+         * @brief Buttons receive pointer events from their container.
+         */
+        bool IsInteractive() const override { return true; }
+        /**
+         * @brief Get the `hitbox` of the `Button`.
+         */
+        bool GetBounds(Rectangle &bounds) const override;
+        /**
+         * @brief Update `hover` and `press`, and call `callbackFunction` when the `Button` is released.
+         */
+        void OnPointerEvent(PointerEvent event) override;
+        /**
+         * @brief Saved as `"UI::Button"`, along with it's texture path. Buttons created from a `Texture2D` can't be saved.
+         */
+        bool Save(SceneRecord &record) const override;
+        /**
+         * @brief Size of the `hitbox`, i.e. the scaled texture without the outline padding.
+         */
+        Vector2 GetLayoutSize() const override;
+        /**
+         * @brief Buttons are drawn centered on their position, so they are moved to the center of @p rect.
+         */
+        void    Place(Rectangle rect) override;
+        /**
+         * @brief Reports the padded texture and the cached variants built so far.
+         */
+        void    CollectTextures(TextureSet &textures) const override;
+
+        /**
+         * @brief Run the updating logic on the `Button` object. Recomputes `hitbox` after the `Button` moved.
+         * @note Input is not polled here, `hover` and `press` are driven by `OnPointerEvent()`.
          */
         void Update() override;
         /**
@@ -286,6 +652,7 @@ namespace UI
         Color   col;                 // Main panel colour.
         Color   edge_col;            // Panel edge colour.
         Vector2 dimensions;          // Panel dimensions.
+        Vector2 size;                // Drawn size. The dimensions, or the size of the slot the panel was placed in.
         unsigned int edge_thickness; // Panel edge thickness.
     public:
         /**
@@ -301,6 +668,27 @@ namespace UI
          * @brief Update the panel.
          */
         void Update() override;
+        /**
+         * @brief Panels only change through their setters, so they are only updated when dirty.
+         */
+        bool IsStatic() const override { return true; }
+        /**
+         * @brief Saved as `"UI::Panel"`, along with it's dimensions, colours and edge thickness.
+         */
+        bool Save(SceneRecord &record) const override;
+        /**
+         * @brief The panel's dimensions, whatever slot it was placed in.
+         */
+        Vector2 GetLayoutSize() const override;
+        /**
+         * @brief Panels are stretched over @p rect, so they can back the layout nodes they are attached to.
+         * @note Only the drawn size changes. The dimensions are kept, so a padded node measures the same every time.
+         */
+        void    Place(Rectangle rect) override;
+        /**
+         * @brief The rectangle covered by the panel, so it can block the pointer, see `SetBlocksPointer()`.
+         */
+        bool    GetBounds(Rectangle &bounds) const override;
     };
 
     // -------------------
@@ -309,6 +697,8 @@ namespace UI
     /**
      * @brief ## Label class.
      * @brief Allows for drawing text as a `UIElement`.
+     * @details Text is drawn with raylib's default font unless another one is set with `SetFont()`. Glyphs are submitted through the
+     * `sprite_batch`, so labels sharing a font and a draw order are drawn together.
      */
     class Label : public UIElement{
     public:
@@ -321,6 +711,16 @@ namespace UI
         std::string text;       // Label content.
         unsigned int text_size; // Label font size.
         ALIGNMENT alignment;    // Label text alignment.
+        FontHandle font;        // Label font. Empty for raylib's default font.
+
+        mutable std::vector<GlyphQuad> glyphs;       // Cached glyph quads, laid out from `text`, `text_size` and `font`.
+        mutable Vector2                origin;       // Cached drawing origin, measured from `text`, `text_size`, `font` and `alignment`.
+        mutable bool                   layout_valid; // Whether `glyphs` and `origin` match the current `text`, `text_size`, `font` and `alignment`.
+
+        /**
+         * @brief Flag the cached layout as outdated, and the `Label` as dirty. Must be called after writing to `text`, `text_size`, `font` or `alignment`.
+         */
+        void InvalidateLayout();
     public:
         /**
          * @brief Creates a new, empty `Label` object with default parameters.
@@ -376,14 +776,34 @@ namespace UI
          */
         void               SetTextColor(Color color);
 
+        /**
+         * @brief Get the `Label` object's font.
+         * @return A @b constant reference to the font handle. Empty if raylib's default font is used.
+         */
+        const FontHandle  &GetFont() const;
+        /**
+         * @brief Change the `Label` object's font.
+         * @param _font The new font, usually from `fonts.Acquire()`. Pass an empty handle to go back to raylib's default font.
+         */
+        void               SetFont(FontHandle _font);
+
         /**
          * @brief Overriden update method. Does nothing.
          */
         void Update() override = 0;
         /**
          * @brief Draw the `Label` object.
+         * @note The text is only laid out again after it's content, size, font or alignment changed.
          */
         void Draw() const override;
+        /**
+         * @brief Size of the text, as measured with the current font and size.
+         */
+        Vector2 GetLayoutSize() const override;
+        /**
+         * @brief Labels are moved to the left edge, center or right edge of @p rect, following their alignment, and centered vertically.
+         */
+        void    Place(Rectangle rect) override;
 
     };
 
@@ -396,7 +816,7 @@ namespace UI
      */
     class ImageDisplay : public UIElement {
     private:
-        Texture2D image;  // Image to display.
+        TextureHandle image; // Image to display.
         Vector2   origin; // Point of origin. Set to {`image`.width / 2.0f, `image`.height / 2.0f} to have the image centered around `transform.position`.
         Rectangle sr, dr; // Auxiliary rectangles for the `Draw()` method.
     public:
@@ -409,9 +829,12 @@ namespace UI
          */
         ImageDisplay(Texture2D texture, Transform2D _transform = {}, Vector2 _origin = {});
         /**
-         * @brief Safely clean up texture data.
+         * @brief Create an `ImageDisplay` object from a texture file shared through the `ResourceManager`.
+         * @param texture_path Path of the texture file, relative to `TEXTURES_PATH`.
+         * @param _transform New object's transform. Determines position, scale and rotation.
+         * @param _origin Point of reference from which to draw the texture.
          */
-        ~ImageDisplay();
+        ImageDisplay(const std::string &texture_path, Transform2D _transform = {}, Vector2 _origin = {});
 
         /**
          * @brief Automatically calculate the center of the `image` and set the `origin` to that point.
@@ -422,6 +845,30 @@ namespace UI
          * @brief Update logic. Calculates where to draw the image using the object's `transform` data.
          */
         void Update() override;
+        /**
+         * @brief Images only change through their setters, so they are only updated when dirty.
+         */
+        bool IsStatic() const override { return true; }
+        /**
+         * @brief Saved as `"UI::ImageDisplay"`, along with it's texture path and origin. Images created from a `Texture2D` can't be saved.
+         */
+        bool Save(SceneRecord &record) const override;
+        /**
+         * @brief Size of the scaled image.
+         */
+        Vector2 GetLayoutSize() const override;
+        /**
+         * @brief Moves the image so it's top left corner lands on @p rect's, whatever it's origin.
+         */
+        void    Place(Rectangle rect) override;
+        /**
+         * @brief The rectangle covered by the unrotated image, so it can block the pointer, see `SetBlocksPointer()`.
+         */
+        bool    GetBounds(Rectangle &bounds) const override;
+        /**
+         * @brief Reports the displayed image.
+         */
+        void    CollectTextures(TextureSet &textures) const override;
         /**
          * @brief Draw the object.
          */
@@ -435,12 +882,16 @@ namespace UI
      * @brief ## Variable Display class
      * @brief Allows for having a label with a variable value in it. The value will automatically update when the `Update()` method is called.
      * @note This class stores a constant pointer to the variable it displays. Ownership of the object is not passed to this class.
-     * @warning This template class is compatible with all data types compatible with the `std::to_string()` method of the STL.
+     * @warning This template class is compatible with all arithmetic types (the ones supported by the `std::to_string()` method of the STL).
+     * @note `VariableDisplay<Profiler>` (aka `ProfilerOverlay`) is specialized to show the profiler's statistics instead.
      */
     template <typename T>
     class VariableDisplay : public Label{
     private:
         const T *variable; // Pointer to the variable to be displayed.
+        // Value shown by `text`. Non arithmetic types (e.g. `Profiler`) specialize `Update()` and do not need it.
+        std::conditional_t<std::is_arithmetic<T>::value, T, char> last_value;
+        bool has_value; // Whether `text` shows a value yet.
     public:
         /**
          * @brief Create a new `VariableDisplay` object with default parameters.
@@ -460,12 +911,13 @@ namespace UI
 
         /**
          * @brief Update the display to have the most recent value stored in `variable`.
+         * @note The text is only rebuilt when the value changed since the last update, and formatting it does not allocate.
          */
         void Update() override;
     };
 
     template <typename T>
-    UI::VariableDisplay<T>::VariableDisplay(const T *_variable, Transform2D _transform, unsigned int _text_size, Color _text_col, ALIGNMENT _alignment) : variable(_variable)
+    UI::VariableDisplay<T>::VariableDisplay(const T *_variable, Transform2D _transform, unsigned int _text_size, Color _text_col, ALIGNMENT _alignment) : variable(_variable), last_value{}, has_value(false)
     {
         transform = _transform;
         text_size = _text_size;
@@ -476,13 +928,48 @@ namespace UI
     template <typename T>
     inline const T &VariableDisplay<T>::GetVariable() const
     {
-        return variable;
+        return *variable;
     }
 
     template <typename T>
     inline void VariableDisplay<T>::Update()
     {
-        text = std::to_string(*variable);
+        if (has_value && *variable == last_value) return;
+        last_value = *variable;
+        has_value  = true;
+
+        // Same output as `std::to_string()`, written into a stack buffer and then into the existing `text` storage
+        char buffer[64];
+        std::to_chars_result result;
+        if constexpr (std::is_same<T, bool>::value)
+            result = std::to_chars(buffer, buffer + sizeof(buffer), (int)last_value);
+        else if constexpr (std::is_floating_point<T>::value)
+            result = std::to_chars(buffer, buffer + sizeof(buffer), last_value, std::chars_format::fixed, 6);
+        else
+            result = std::to_chars(buffer, buffer + sizeof(buffer), last_value);
+        if (result.ec != std::errc())
+        {
+            text = std::to_string(last_value); // Huge floating point values that do not fit in the buffer
+        }
+        else
+        {
+            text.assign(buffer, result.ptr);
+        }
+        InvalidateLayout();
     }
+
+    /**
+     * @brief ## Profiler Overlay
+     * @brief Label showing the rolling min/avg/p99 frame time of every section recorded by a `Profiler`, one per line, followed by the
+     * number of `GameObject` objects allocated with @b new and the video memory of the textures cached by `resources`.
+     * @note Create it with a pointer to the global `profiler`, e.g. `UI::ProfilerOverlay(&profiler, {{10, 10}, 0, 1}, 10, GREEN)`.
+     */
+    using ProfilerOverlay = VariableDisplay<Profiler>;
+
+    /**
+     * @brief Update the overlay text with the most recent profiler statistics.
+     */
+    template <>
+    void VariableDisplay<Profiler>::Update();
 }
 #endif // UI_H
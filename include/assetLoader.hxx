@@ -0,0 +1,82 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "globals.hxx"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @file assetLoader.hxx
+ * @brief This file contains the declaration of the `AssetLoader` class.
+ * @details
+ * The `AssetLoader` decodes image files on a pool of worker threads, and hands the decoded images back to the main thread, where they
+ * can be uploaded to the GPU. Uploading is done by `ProcessUploads()` within a time budget, so that a big batch of assets is spread
+ * over several frames instead of stalling a single one.
+ *
+ * The loader is mostly used through `ResourceManager::AcquireTextureAsync()`, `AnimatedTexture::InitializeAsync()` and
+ * `SceneManager::PreloadScene()`.
+ */
+
+
+/**
+ * @brief ## Asset loader class
+ * @brief Decodes images on worker threads and uploads them on the main thread.
+ */
+class AssetLoader {
+private:
+    struct Request {
+        std::string                path;      // Full path of the image file.
+        std::function<void(Image)> on_loaded; // Called on the main thread with the decoded image.
+        Image                      image;     // Decoded image, once done.
+    };
+
+    std::vector<std::thread> workers;  // Decoding threads. Started on the first request.
+    std::deque<Request>      queued;   // Requests waiting to be decoded.
+    std::deque<Request>      decoded;  // Requests waiting to be uploaded.
+    mutable std::mutex       mutex;    // Protects `queued`, `decoded`, `in_flight` and `stopping`.
+    std::condition_variable  wake;     // Signals workers when a request is queued or the loader stops.
+    size_t                   in_flight; // Requests currently being decoded.
+    bool                     stopping;  // Whether workers should exit.
+
+    void WorkerLoop();
+public:
+    /**
+     * @brief Create an idle loader. Worker threads are only started once something is queued.
+     */
+    AssetLoader();
+    /**
+     * @brief Stops and joins all worker threads. Images not yet uploaded are discarded.
+     */
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&)            = delete;
+    AssetLoader &operator=(const AssetLoader&) = delete;
+
+    /**
+     * @brief Queue an image file to be decoded on a worker thread.
+     * @param path Full path of the image file.
+     * @param on_loaded Function called from `ProcessUploads()` (so on the main thread) with the decoded image. It becomes owner of said image.
+     * @note If decoding fails, @p on_loaded is still called, with an invalid image.
+     */
+    void QueueImage(const std::string &path, std::function<void(Image)> on_loaded);
+    /**
+     * @brief Hand decoded images to their callbacks until the time budget runs out.
+     * @param budget_ms Maximum time to spend, in milliseconds. At least one image is processed if any is ready.
+     * @warning Function must be called from the main thread, since callbacks usually upload the images to the GPU.
+     */
+    void ProcessUploads(double budget_ms);
+    /**
+     * @brief Get the number of requests not yet handed to their callbacks.
+     */
+    size_t GetPendingCount() const;
+};
+
+/**
+ * @brief Global asset loader used by the `ResourceManager`.
+ */
+extern AssetLoader asset_loader;
+
+#endif // ASSET_LOADER_H
@@ -0,0 +1,76 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file fileWatcher.hxx
+ * @brief This file contains the declaration of the `FileWatcher` class.
+ * @details
+ * The `FileWatcher` scans a directory tree on a background thread and remembers which files were modified or created since the last
+ * scan, by comparing their last write times. Changes are collected by `Poll()` whenever the owner is ready to act on them.
+ *
+ * Polling the file system works the same on every platform the project builds for, and scanning a resources directory a couple of
+ * times per second costs next to nothing.
+ */
+
+
+/**
+ * @brief ## File watcher class
+ * @brief Detects modified files in a directory tree from a background thread.
+ */
+class FileWatcher {
+private:
+    std::filesystem::path                                             root;     // Watched directory.
+    std::chrono::milliseconds                                         interval; // Time between two scans.
+    std::unordered_map<std::string, std::filesystem::file_time_type> times;    // Last write time of every known file. Only used by `thread`.
+    std::set<std::string>                                             changed;  // Files changed since the last `Poll()`, relative to `root`.
+    std::thread                                                       thread;   // Scanning thread.
+    std::mutex                                                        mutex;    // Protects `changed` and `stopping`.
+    std::condition_variable                                           wake;     // Signals the scanning thread to stop.
+    bool                                                              stopping; // Whether the scanning thread should exit.
+
+    void Scan(bool record);
+    void ThreadLoop();
+public:
+    FileWatcher();
+    /**
+     * @brief Stops the scanning thread.
+     */
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&)            = delete;
+    FileWatcher &operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Start watching @p _root, stopping any previous watch first.
+     * @param _root Directory to watch, recursively.
+     * @param interval_ms Time between two scans, in milliseconds.
+     * @note Files already present are not reported, only the ones written to after this call.
+     */
+    void Start(const std::filesystem::path &_root, int interval_ms = 500);
+    /**
+     * @brief Stop watching. Changes not yet polled are discarded.
+     */
+    void Stop();
+    /**
+     * @brief Check whether a directory is being watched.
+     */
+    bool IsRunning() const;
+
+    /**
+     * @brief Collect the files changed since the last call.
+     * @param paths Vector the paths are appended to, relative to the watched directory and with `/` separators.
+     * @return @b True if any file changed. @b False otherwise.
+     */
+    bool Poll(std::vector<std::string> &paths);
+};
+
+#endif // FILE_WATCHER_H
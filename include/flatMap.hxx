@@ -0,0 +1,183 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @file flatMap.hxx
+ * @brief This file contains the `FlatMap` template class.
+ * @details
+ * A `FlatMap` is an open addressing hash map storing it's entries in a single array, probed linearly. A lookup hashes the key once and
+ * then reads consecutive entries of the array, instead of following the node pointers of a `std::unordered_map`, and inserting only
+ * allocates when the array grows. Erasing shifts the following entries back, so no tombstones are left behind.
+ *
+ * Used with `StringId` keys to look up objects, containers and scenes by identifier.
+ */
+
+
+/**
+ * @brief ## Flat map class
+ * @brief Hash map with linear probing over a flat array.
+ * @tparam Key Type of the keys. Must be default constructible and comparable with `==`.
+ * @tparam Value Type of the values. Must be default constructible and movable.
+ * @tparam Hash Hash function of the keys. Hashes are mixed again, so identity hashes of integers work.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatMap {
+private:
+    static constexpr size_t MIN_CAPACITY = 8;
+
+    struct Slot {
+        Key   key;
+        Value value;
+        bool  used;   // Whether the slot holds an entry.
+    };
+
+    std::vector<Slot> slots; // Power of two sized array of entries, or empty.
+    size_t            count; // Number of entries.
+    unsigned          shift; // 64 minus the log2 of the size of `slots`, to keep the top bits of the mixed hash.
+
+    size_t Home(const Key &key) const
+    {
+        // Fibonacci hashing spreads poor hashes (e.g. consecutive integers) over the whole array
+        return (size_t)(((uint64_t)Hash{}(key) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+    size_t Locate(const Key &key) const
+    {
+        if (count == 0) return slots.size();
+        size_t mask = slots.size() - 1;
+        for (size_t i = Home(key);; i = (i + 1) & mask)
+        {
+            if (!slots[i].used)     return slots.size();
+            if (slots[i].key == key) return i;
+        }
+    }
+    void Rehash(size_t capacity)
+    {
+        std::vector<Slot> previous(capacity);
+        previous.swap(slots);
+        shift = 64;
+        for (size_t size = capacity; size > 1; size >>= 1) shift--;
+        size_t mask = slots.size() - 1;
+        for (Slot &slot : previous)
+        {
+            if (!slot.used) continue;
+            size_t i = Home(slot.key);
+            while (slots[i].used) i = (i + 1) & mask;
+            slots[i] = std::move(slot);
+        }
+    }
+    // Slot where @p key is stored or would be inserted, growing the array if needed
+    size_t Claim(const Key &key)
+    {
+        size_t found = Locate(key);
+        if (found < slots.size()) return found;
+        // At most three quarters full, so probe sequences stay short
+        if ((count + 1) * 4 > slots.size() * 3) Rehash(slots.empty() ? MIN_CAPACITY : slots.size() * 2);
+        size_t mask = slots.size() - 1, i = Home(key);
+        while (slots[i].used) i = (i + 1) & mask;
+        slots[i].key   = key;
+        slots[i].value = Value{};
+        slots[i].used  = true;
+        count++;
+        return i;
+    }
+public:
+    /**
+     * @brief Create an empty map. Nothing is allocated until the first insertion.
+     */
+    FlatMap() : count(0), shift(64) {}
+
+    /**
+     * @brief Insert an entry.
+     * @return @b True if it was inserted. @b False if @p key was already in use, in which case nothing changes.
+     */
+    bool Insert(const Key &key, Value value)
+    {
+        size_t before = count;
+        size_t i      = Claim(key);
+        if (count == before) return false;
+        slots[i].value = std::move(value);
+        return true;
+    }
+    /**
+     * @brief Get the value of @p key, inserting a default constructed one if it has none.
+     * @warning The reference is invalidated by any later insertion or erasure.
+     */
+    Value &operator[](const Key &key) { return slots[Claim(key)].value; }
+    /**
+     * @brief Look up the value of @p key.
+     * @return A pointer to the value, or @b nullptr if @p key is unknown. Invalidated by any later insertion or erasure.
+     */
+    Value       *Find(const Key &key)
+    {
+        size_t i = Locate(key);
+        return i < slots.size() ? &slots[i].value : nullptr;
+    }
+    /**
+     * @brief Look up the value of @p key.
+     * @return A @b constant pointer to the value, or @b nullptr if @p key is unknown.
+     */
+    const Value *Find(const Key &key) const
+    {
+        size_t i = Locate(key);
+        return i < slots.size() ? &slots[i].value : nullptr;
+    }
+    /**
+     * @brief Remove the entry of @p key.
+     * @return @b True if an entry was removed. @b False if @p key was unknown.
+     */
+    bool Erase(const Key &key)
+    {
+        size_t hole = Locate(key);
+        if (hole >= slots.size()) return false;
+        // Following entries are moved back into the hole, unless that would put them before their home slot
+        size_t mask = slots.size() - 1;
+        for (size_t next = (hole + 1) & mask; slots[next].used; next = (next + 1) & mask)
+        {
+            size_t home = Home(slots[next].key);
+            if (((next - home) & mask) < ((next - hole) & mask)) continue;
+            slots[hole] = std::move(slots[next]);
+            hole = next;
+        }
+        slots[hole] = Slot{};
+        count--;
+        return true;
+    }
+    /**
+     * @brief Remove every entry, keeping the array allocated.
+     */
+    void Clear()
+    {
+        for (Slot &slot : slots) slot = Slot{};
+        count = 0;
+    }
+    /**
+     * @brief Reserve room for @p capacity entries, so inserting up to that many does not reallocate.
+     */
+    void Reserve(size_t capacity)
+    {
+        size_t size = MIN_CAPACITY;
+        while (size * 3 < capacity * 4) size *= 2;
+        if (size > slots.size()) Rehash(size);
+    }
+
+    /**
+     * @brief Get the number of entries.
+     */
+    size_t Size()  const { return count; }
+    /**
+     * @brief Check whether there are no entries.
+     */
+    bool   Empty() const { return count == 0; }
+    /**
+     * @brief Get the number of bytes reserved by the map's array, used or not.
+     */
+    size_t ReservedBytes() const { return slots.capacity() * sizeof(Slot); }
+};
+
+#endif // FLAT_MAP_H
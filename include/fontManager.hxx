@@ -0,0 +1,102 @@
+#ifndef FONT_MANAGER_H
+#define FONT_MANAGER_H
+
+#include "globals.hxx"
+#include "resourceManager.hxx"
+#include <string>
+
+/**
+ * @file fontManager.hxx
+ * @brief This file contains the `FontManager` class and the `GlyphQuad` struct.
+ * @details
+ * Fonts are cached by the `ResourceManager`, which rasterizes every glyph of a font once into a single atlas texture. The `FontManager`
+ * turns text into quads sampling from said atlas and submits them through the `sprite_batch`, so a whole block of text (or several
+ * labels sharing a font and a layer) ends up in a single draw call.
+ *
+ * Fonts loaded in SDF mode store signed distance fields instead of coverage. They are drawn with the `sdf.fs` shader, which rebuilds
+ * sharp edges at any size, so a single atlas serves every text size.
+ *
+ * Layout is split from drawing: `Layout()` computes the quads of a string relative to it's top left corner, and `Submit()` places them
+ * on screen. Callers drawing the same text every frame (e.g. `UI::Label`) only need to lay it out again when it changes.
+ */
+
+
+/**
+ * @brief ## Glyph quad struct
+ * @brief A laid out glyph.
+ */
+struct GlyphQuad {
+    Rectangle source; ///< Region of the font atlas holding the glyph.
+    Rectangle dest;   ///< Location of the glyph, relative to the top left corner of the text.
+};
+
+/**
+ * @brief ## Font manager class
+ * @brief Lays out text and draws it through the `sprite_batch`.
+ */
+class FontManager {
+public:
+    static constexpr int   SDF_BASE_SIZE = 48;   ///< Default size SDF glyphs are rasterized at.
+    static constexpr float LINE_SPACING  = 2.0f; ///< Extra space between lines, in pixels. Same as raylib's default.
+private:
+    ShaderHandle sdf_shader; // Shader used to draw SDF fonts. Loaded on first use.
+public:
+    /**
+     * @brief Get a handle to a font in SDF mode.
+     * @param path Path of the TTF/OTF file, relative to `FONTS_PATH`.
+     * @param base_size Size the distance fields are rasterized at. Larger sizes keep finer details.
+     * @note Shorthand for `resources.AcquireFont(path, base_size, true)`.
+     */
+    FontHandle Acquire(const std::string &path, int base_size = SDF_BASE_SIZE);
+    /**
+     * @brief Get a handle to a font rasterized at a fixed size, for pixel exact text drawn at that size.
+     * @param path Path of the TTF/OTF file, relative to `FONTS_PATH`.
+     * @param size Size the glyphs are rasterized at.
+     * @note Shorthand for `resources.AcquireFont(path, size, false)`.
+     */
+    FontHandle AcquireBitmap(const std::string &path, int size);
+    /**
+     * @brief Get raylib's default font.
+     * @warning Must be called after window initialization.
+     */
+    const FontAsset &GetDefault() const;
+
+    /**
+     * @brief Lay out @p text as glyph quads.
+     * @param font Font to lay the text out with.
+     * @param text UTF-8 text. Line breaks start new lines.
+     * @param size Font size, in pixels.
+     * @param spacing Extra space between glyphs, in pixels.
+     * @param quads Vector the quads are written to. It's previous content is discarded, but it's capacity is reused.
+     * @return The size of the laid out text.
+     */
+    Vector2 Layout(const FontAsset &font, const std::string &text, float size, float spacing, std::vector<GlyphQuad> &quads) const;
+    /**
+     * @brief Measure @p text without laying it out.
+     * @return The size `Layout()` would return.
+     */
+    Vector2 Measure(const FontAsset &font, const std::string &text, float size, float spacing) const;
+    /**
+     * @brief Submit laid out glyphs to the `sprite_batch`.
+     * @param font Font the quads were laid out with.
+     * @param quads Quads returned by `Layout()`.
+     * @param position Position of the text.
+     * @param origin Point of the text placed at @p position, and rotated around. Relative to the top left corner of the text.
+     * @param rotation Rotation, in degrees.
+     * @param tint Text colour.
+     * @note If the batch is not active, the text is batched and drawn on it's own.
+     */
+    void    Submit(const FontAsset &font, const std::vector<GlyphQuad> &quads, Vector2 position, Vector2 origin, float rotation, Color tint);
+    /**
+     * @brief Lay out and submit @p text in one go. Takes the same parameters as raylib's `DrawTextPro()`.
+     * @note Prefer caching the result of `Layout()` for text drawn every frame.
+     */
+    void    Draw(const FontAsset &font, const std::string &text, Vector2 position, Vector2 origin, float rotation, float size, float spacing, Color tint);
+};
+
+/**
+ * @brief Global font manager used by `UI::Label`.
+ */
+extern FontManager fonts;
+
+#endif // FONT_MANAGER_H
@@ -0,0 +1,69 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <cstdint>
+
+/**
+ * @file frameClock.hxx
+ * @brief This file contains the declaration of the `FrameClock` class.
+ * @details
+ * The `FrameClock` is the single source of time for everything updated by a `Scene`. It is advanced by the `SceneManager` once per
+ * simulation step, so all objects updated during a step read the same time, and a fixed step rate makes the simulation deterministic.
+ *
+ * Time-dependent code (e.g. `AnimatedTexture`) should read `frame_clock` instead of querying the system clock on it's own.
+ */
+
+
+/**
+ * @brief ## Frame clock class
+ * @brief Simulation time, advanced once per update step.
+ */
+class FrameClock {
+private:
+    double   time;  // Simulation time, in seconds.
+    double   delta; // Duration of the last step, in seconds.
+    uint64_t steps; // Number of steps so far.
+    float    alpha; // Fraction of a step between the last simulated state and the rendered frame.
+public:
+    /**
+     * @brief Create a clock at time zero.
+     */
+    FrameClock();
+
+    /**
+     * @brief Advance the clock by one step.
+     * @param dt Duration of the step, in seconds.
+     */
+    void     Advance(double dt);
+    /**
+     * @brief Set the interpolation factor used while drawing.
+     * @param _alpha A value in the [0, 1] range.
+     */
+    void     SetAlpha(float _alpha);
+
+    /**
+     * @brief Get the simulation time, in seconds.
+     */
+    double   GetTime() const;
+    /**
+     * @brief Get the duration of the last step, in seconds.
+     */
+    double   GetDelta() const;
+    /**
+     * @brief Get the number of steps the clock has been advanced by.
+     */
+    uint64_t GetStep() const;
+    /**
+     * @brief Get the interpolation factor of the frame being drawn.
+     * @return How far, as a fraction of a step, the rendered frame is past the last simulated state. Objects that keep their
+     * previous state can draw `previous + (current - previous) * alpha` for smooth motion at any frame rate.
+     */
+    float    GetAlpha() const;
+};
+
+/**
+ * @brief Global frame clock, advanced by `SceneManager`.
+ */
+extern FrameClock frame_clock;
+
+#endif // FRAME_CLOCK_H
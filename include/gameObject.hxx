@@ -3,6 +3,9 @@
 
 #include "globals.hxx"
 
+struct SceneRecord;
+class TextureSet;
+
 /**
  * @file GameObject.hxx
  * @brief This file contains the declaration of the GameObject class.
@@ -52,11 +55,78 @@ public:
 
     /**
      * @brief Pure virtual function to be overriden in child classes.
+     * @note Objects stored in a `Scene` or `UIContainer` are drawn while `sprite_batch` is active. Textures should be drawn with
+     * `DrawSprite()`, and anything drawn directly through raylib must be preceded by a `sprite_batch.Flush()` call.
      */
     virtual void Draw() const = 0;
     /**
      * @brief Pure virtual function to be overriden in child classes.
      */
     virtual void Update()     = 0;
+
+    /**
+     * @brief Name under which the object's `Update()` and `Draw()` calls are timed by the profiler.
+     * @return @b nullptr by default, meaning the object is not profiled. Override it to opt a type in, returning a string literal.
+     * @note All objects returning the same name are accumulated into the same profiler section.
+     */
+    virtual const char *GetProfileName() const { return nullptr; }
+    /**
+     * @brief Whether the object's `Update()` may run on a worker thread, concurrently with other thread-safe objects.
+     * @return @b False by default. Override it to return @b true for objects whose `Update()` only touches their own state, and does not
+     * call raylib or read input.
+     * @note Only used by scenes with parallel updates enabled, see `Scene::SetParallelUpdate()`. `Draw()` always runs on the main thread.
+     */
+    virtual bool IsThreadSafe() const { return false; }
+    /**
+     * @brief Get the world space rectangle the object draws into.
+     * @param bounds Where to write the bounds.
+     * @return @b False by default, meaning the object has no known bounds. Override it to return @b true and fill @p bounds.
+     * @note Objects with bounds are culled by `Scene::Draw()` when off camera, and found by `Scene::QueryRect()` and `Scene::QueryRadius()`.
+     * Objects without bounds are always drawn, and are found by their `transform` position instead.
+     * @note Scenes only poll the bounds of objects that had some when added, see `Scene::ReindexObject()`.
+     */
+    virtual bool GetBounds(Rectangle &bounds) const { (void)bounds; return false; }
+    /**
+     * @brief Describe the object to be written to a scene file by `SceneFile::Save()`.
+     * @param record Record to fill. It's `transform` and `draw_order` are already set, the type name must be set, and the resource
+     * path and payload are optional.
+     * @return @b False by default, meaning the object can't be saved. Override it to return @b true, and register a matching factory
+     * in `scene_types` so the object can be loaded back.
+     */
+    virtual bool Save(SceneRecord &record) const { (void)record; return false; }
+    /**
+     * @brief Add the textures the object draws with to @p textures, so they are counted by `Scene::GetMemoryStats()`.
+     * @note Does nothing by default. Override it in types holding their own textures.
+     */
+    virtual void CollectTextures(TextureSet &textures) const { (void)textures; }
+
+    /**
+     * @brief Allocation function used by @b new for every `GameObject` type. Keeps count of the live objects and their size.
+     */
+    static void *operator new(size_t size);
+    /**
+     * @brief Deallocation function matching the counting `operator new()`.
+     */
+    static void  operator delete(void *pointer) noexcept;
+    /**
+     * @brief Placement form, used by object pools to construct objects in their own storage. Nothing is counted.
+     */
+    static void *operator new(size_t size, void *place) noexcept { (void)size; return place; }
+    static void  operator delete(void *pointer, void *place) noexcept { (void)pointer; (void)place; }
+
+    /**
+     * @brief Get the number of `GameObject` objects currently allocated with @b new, in any scene or none.
+     * @note Comparing it with the objects held by all scenes and containers helps finding leaked objects.
+     */
+    static size_t GetHeapCount();
+    /**
+     * @brief Get the number of bytes taken by the `GameObject` objects currently allocated with @b new, allocation headers included.
+     */
+    static size_t GetHeapBytes();
+    /**
+     * @brief Get the number of bytes taken by an object allocated with @b new, allocation header included.
+     * @warning @p object must have been allocated with @b new, e.g. not by an `ObjectPool` nor on the stack.
+     */
+    static size_t GetAllocationSize(const GameObject &object);
 };
 #endif
\ No newline at end of file
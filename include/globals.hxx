@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <vector>
 #include <iostream>
+#include <cstring>
 
 /**
  * @file globals.hxx
@@ -28,7 +29,9 @@
 const std::filesystem::path EXECUTABLE_PATH = std::filesystem::current_path(),  ///< The path to the executable file.
                             RESOURCES_PATH  = EXECUTABLE_PATH / "resources",    ///< The path to the resources directory.
                             TEXTURES_PATH   = RESOURCES_PATH  / "textures",     ///< The path to the textures directory.
-                            SHADERS_PATH    = RESOURCES_PATH  / "shaders";      ///< The path to the shaders directory.
+                            SHADERS_PATH    = RESOURCES_PATH  / "shaders",      ///< The path to the shaders directory.
+                            FONTS_PATH      = RESOURCES_PATH  / "fonts",        ///< The path to the fonts directory.
+                            SCENES_PATH     = RESOURCES_PATH  / "scenes";       ///< The path to the scene files directory.
 
 
 /**
@@ -83,6 +86,78 @@ extern Camera2D camera; ///< Main camera to be used for rendering.
  * - If the button is @b being @b pressed, it's texture will appear with a dark tint and a white outline.
  */
 extern Shader button_shader;
+
+/**
+ * @brief ## Shader uniform class
+ * @brief Caches the location of a shader uniform and the last value uploaded to it.
+ * @tparam T Type of the uniform value.
+ * @tparam UNIFORM_TYPE raylib's `ShaderUniformDataType` matching @p T.
+ * @details Locations are resolved once by `Resolve()` instead of being looked up by name on every upload, and `Set()` skips the upload
+ * altogether when the value did not change since the last one.
+ */
+template <typename T, int UNIFORM_TYPE>
+class ShaderUniform {
+private:
+    int  location; // Uniform location, or -1 if the shader does not have it.
+    T    value;    // Last uploaded value.
+    bool uploaded; // Whether `value` holds what the shader currently has.
+public:
+    ShaderUniform() : location(-1), value{}, uploaded(false) {}
+
+    /**
+     * @brief Look up the location of the uniform and forget the last uploaded value.
+     * @param shader Shader the uniform belongs to.
+     * @param name Name of the uniform in the shader source.
+     */
+    void Resolve(Shader shader, const char *name)
+    {
+        location = GetShaderLocation(shader, name);
+        uploaded = false;
+    }
+    /**
+     * @brief Upload a new value to the uniform, unless it is the one that was last uploaded.
+     * @param shader Shader the uniform belongs to. Must be the one passed to `Resolve()`.
+     * @param _value Value to upload.
+     */
+    void Set(Shader shader, const T &_value)
+    {
+        if (location < 0) return;
+        if (uploaded && std::memcmp(&value, &_value, sizeof(T)) == 0) return;
+        value    = _value;
+        uploaded = true;
+        SetShaderValue(shader, location, &value, UNIFORM_TYPE);
+    }
+};
+
+/**
+ * @brief ## Button shader parameters struct
+ * @brief Cached uniforms of `button_shader`.
+ */
+struct ButtonShaderParams {
+    ShaderUniform<int,     SHADER_UNIFORM_INT>   hover;        ///< Whether to draw the outline.
+    ShaderUniform<float,   SHADER_UNIFORM_FLOAT> outlineSize;  ///< Thickness of the outline.
+    ShaderUniform<Vector2, SHADER_UNIFORM_VEC2>  texSize;      ///< On screen size of the texture.
+    ShaderUniform<Vector4, SHADER_UNIFORM_VEC4>  outlineColor; ///< Colour of the outline.
+    ShaderUniform<Vector4, SHADER_UNIFORM_VEC4>  tintCol;      ///< Tint applied to the texture.
+
+    /**
+     * @brief Resolve the location of every uniform.
+     * @param shader The button shader.
+     */
+    void Resolve(Shader shader)
+    {
+        hover.Resolve(shader, "hover");
+        outlineSize.Resolve(shader, "outlineSize");
+        texSize.Resolve(shader, "texSize");
+        outlineColor.Resolve(shader, "outlineColor");
+        tintCol.Resolve(shader, "tintCol");
+    }
+};
+
+/**
+ * @brief Uniforms of `button_shader`, resolved by `InitButtonShader()`.
+ */
+extern ButtonShaderParams button_shader_params;
 /**
  * @brief Default thickness value for the button outline.
  */
@@ -99,5 +174,26 @@ void InitButtonShader();
  * @param thickness Size of the outline.
  */
 void ConfigButtonShader(bool outline, float thickness = BUTTON_SHADER_OUTLINE_THICKNESS_DEFAULT);
+/**
+ * @brief Auxiliary function used internally by the `Button` class.
+ * @param outline Whether to show the white outline or not.
+ * @param thickness Size of the outline.
+ * @param texSize On screen size of the button texture.
+ * @param tint Tint to apply to the button texture.
+ * @note Only the values that changed since the last call are uploaded to the shader.
+ */
+void ConfigButtonShader(bool outline, float thickness, Vector2 texSize, Vector4 tint);
+
+/**
+ * @brief Start drawing into @p target, like raylib's `BeginTextureMode()`, but nestable.
+ * @param target Render texture to draw into until the matching `EndRenderTarget()`.
+ * @note raylib's texture mode always goes back to the screen when it ends. Targets begun through this function go back to the
+ * enclosing target instead, so e.g. `UIContainer` caches can be rebuilt while a scene is rendered into a transition texture.
+ */
+void BeginRenderTarget(RenderTexture2D target);
+/**
+ * @brief Stop drawing into the target of the last `BeginRenderTarget()` call, and go back to the enclosing target or the screen.
+ */
+void EndRenderTarget();
 
 #endif // GLOBALS_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef INPUT_ROUTER_H
+#define INPUT_ROUTER_H
+
+#include "globals.hxx"
+
+/**
+ * @file inputRouter.hxx
+ * @brief This file contains the `InputRouter` class, the `PointerState` struct and the `PointerEvent` enum.
+ * @details
+ * The `InputRouter` reads the mouse from raylib once per update, and `UIContainer` objects dispatch the result to their elements.
+ * Every container keeps a spatial index of it's interactive elements, and of the ones blocking the pointer (see
+ * `UIElement::SetBlocksPointer()`), so finding the element under the pointer is a single lookup,
+ * and elements are only notified through `UIElement::OnPointerEvent()` when their hover or press state actually changes.
+ *
+ * Containers are dispatched from the topmost to the bottommost. The first one with an element under the pointer captures it, so
+ * overlapping elements (in the same container or in different ones) never receive the same event.
+ *
+ * `SceneManager` samples and consumes input on it's own. Code updating containers by hand must call `Sample()` before updating them
+ * and `Consume()` afterwards.
+ */
+
+
+/**
+ * @brief Pointer transitions sent to interactive `UIElement` objects.
+ */
+enum class PointerEvent {
+    ENTER,   ///< The pointer started hovering the element.
+    LEAVE,   ///< The pointer stopped hovering the element. Also cancels a press.
+    PRESS,   ///< `MOUSE_BUTTON_LEFT` was pressed over the element.
+    RELEASE  ///< `MOUSE_BUTTON_LEFT` was released over the element it was pressed on.
+};
+
+/**
+ * @brief ## Pointer state struct
+ * @brief State of the mouse for the current update.
+ */
+struct PointerState {
+    Vector2 position; ///< Mouse position, in screen coordinates.
+    bool    down;     ///< Whether `MOUSE_BUTTON_LEFT` is held.
+    bool    pressed;  ///< Whether `MOUSE_BUTTON_LEFT` was pressed since the last `InputRouter::Consume()`.
+    bool    released; ///< Whether `MOUSE_BUTTON_LEFT` was released since the last `InputRouter::Consume()`.
+};
+
+/**
+ * @brief ## Input router class
+ * @brief Samples pointer input once per update and tracks which container captured it.
+ */
+class InputRouter {
+private:
+    PointerState pointer;  // Last sampled state.
+    bool         captured; // Whether a container already has an element under the pointer in this update.
+public:
+    InputRouter();
+
+    /**
+     * @brief Read the mouse state from raylib.
+     * @note Presses and releases are kept until `Consume()`, so they are not lost when a frame runs no update.
+     */
+    void Sample();
+    /**
+     * @brief Clear the presses and releases that were dispatched, and release the capture.
+     */
+    void Consume();
+    /**
+     * @brief Get the last sampled state.
+     */
+    const PointerState &GetPointer() const;
+
+    /**
+     * @brief Check whether a container above the current one has an element under the pointer.
+     */
+    bool IsCaptured() const;
+    /**
+     * @brief Claim the pointer, hiding it from the containers dispatched afterwards.
+     */
+    void Capture();
+};
+
+/**
+ * @brief Global input router used by `SceneManager` and `UIContainer`.
+ */
+extern InputRouter input_router;
+
+#endif // INPUT_ROUTER_H
@@ -0,0 +1,90 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file jobSystem.hxx
+ * @brief This file contains the declaration of the `JobSystem` class.
+ * @details
+ * The `JobSystem` is a pool of worker threads running chunks of parallel loops. Every worker owns a queue of chunks: it takes work from
+ * the front of it's own queue, and when said queue runs dry it steals from the back of the other workers' queues, so uneven chunks keep
+ * every thread busy. The thread that starts a loop also runs chunks until the whole loop is done.
+ *
+ * It is used by `Scene::Update()` when parallel updates are enabled, see `Scene::SetParallelUpdate()`.
+ */
+
+
+/**
+ * @brief ## Job system class
+ * @brief Work-stealing thread pool for data parallel loops.
+ */
+class JobSystem {
+private:
+    struct Group;
+    struct Task {
+        Group *group; // Loop the chunk belongs to.
+        size_t begin; // First index of the chunk.
+        size_t end;   // One past the last index of the chunk.
+    };
+    struct Queue {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    const size_t                        worker_count; // Number of worker threads, not counting the calling thread.
+    std::vector<std::thread>            workers;      // Worker threads. Started on the first loop.
+    std::vector<std::unique_ptr<Queue>> queues;       // One queue per worker.
+    std::once_flag                      started;      // Guards the start of `workers`.
+    std::mutex                          mutex;        // Protects `stopping`, and orders `pending` changes with waiting workers.
+    std::condition_variable             wake;         // Signals workers when chunks are queued or the system stops.
+    std::atomic<size_t>                 pending;      // Chunks queued but not yet taken.
+    std::atomic<size_t>                 next_queue;   // Queue that receives the next chunk.
+    bool                                stopping;     // Whether workers should exit.
+
+    void Start();
+    void WorkerLoop(size_t index);
+    bool TryRun(size_t first_queue);
+    static void Run(const Task &task);
+public:
+    /**
+     * @brief Create an idle job system. Worker threads are only started once a loop is run.
+     */
+    JobSystem();
+    /**
+     * @brief Stops and joins all worker threads.
+     * @warning No loop may be running when the job system is destroyed.
+     */
+    ~JobSystem();
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem &operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Run @p job over the [0, @p count) range in parallel, and wait for it to finish.
+     * @param count Number of indices.
+     * @param chunk_size Number of consecutive indices given to a single call of @p job.
+     * @param job Function called with the [begin, end) range of each chunk. May be called concurrently from any thread.
+     * @note If @p job throws, the first exception is rethrown on the calling thread once all chunks are done.
+     */
+    void ParallelFor(size_t count, size_t chunk_size, const std::function<void(size_t, size_t)> &job);
+    /**
+     * @brief Get the number of threads that run chunks, the calling thread included.
+     */
+    size_t GetThreadCount() const;
+};
+
+/**
+ * @brief Global job system used by `Scene::Update()`.
+ */
+extern JobSystem job_system;
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,73 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/**
+ * @file mappedFile.hxx
+ * @brief This file contains the `MappedFile` class.
+ * @details
+ * A `MappedFile` maps a whole file into memory as read only, with `mmap()` on POSIX systems and `MapViewOfFile()` on Windows. Pages are
+ * only read from disk when they are first touched, and no copy of the file is made, so large files can be parsed in place.
+ */
+
+
+/**
+ * @brief ## Mapped file class
+ * @brief Read only memory mapping of a file.
+ */
+class MappedFile {
+private:
+    const uint8_t *data; // Start of the mapping, or @b nullptr if nothing is mapped.
+    size_t         size; // Size of the mapping, in bytes.
+#ifdef _WIN32
+    void *file;          // File handle.
+    void *mapping;       // File mapping handle.
+#else
+    int   file;          // File descriptor.
+#endif
+public:
+    /**
+     * @brief Create an empty mapping.
+     */
+    MappedFile();
+    /**
+     * @brief Map @p path into memory. Check `IsOpen()` to know whether it worked.
+     * @param path Path of the file to map.
+     */
+    explicit MappedFile(const std::filesystem::path &path);
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map @p path into memory, unmapping the previous file first.
+     * @param path Path of the file to map.
+     * @return @b True if the file was mapped. @b False otherwise, e.g. if it does not exist or is empty.
+     */
+    bool Open(const std::filesystem::path &path);
+    /**
+     * @brief Unmap the file, leaving the mapping empty.
+     */
+    void Close();
+    /**
+     * @brief Check whether a file is mapped.
+     */
+    bool IsOpen() const { return data != nullptr; }
+
+    /**
+     * @brief Get the start of the mapped bytes. Page aligned.
+     */
+    const uint8_t *Data() const { return data; }
+    /**
+     * @brief Get the number of mapped bytes.
+     */
+    size_t         Size() const { return size; }
+};
+
+#endif // MAPPED_FILE_H
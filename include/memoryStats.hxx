@@ -0,0 +1,82 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include "globals.hxx"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file memoryStats.hxx
+ * @brief This file contains the `MemoryStats` struct and the `TextureSet` class.
+ * @details
+ * `MemoryStats` describe the memory held by a `UIContainer`, a `Scene` or all the scenes of a `SceneManager`, see
+ * `UIContainer::GetMemoryStats()`, `Scene::GetMemoryStats()` and `SceneManager::GetMemoryStats()`. `SceneManager::DumpMemoryStats()`
+ * writes all of them to a file, along with every texture cached by the `ResourceManager`.
+ *
+ * Heap bytes count the objects allocated with @b new (measured by `GameObject`'s allocation functions), the blocks of the object pools
+ * and the storage of the containers holding them. Texture bytes are estimated from the size and format of every distinct texture the
+ * objects report through `GameObject::CollectTextures()`, so textures shared by many objects are only counted once.
+ *
+ * Memory allocated by the objects themselves (strings, vectors...) is not counted.
+ */
+
+
+/**
+ * @brief ## Memory stats struct
+ * @brief Object counts, CPU and GPU memory held by a container of objects.
+ */
+struct MemoryStats {
+    size_t objects         = 0; ///< `GameObject` objects, pooled or not. Does not include `ui_elements`.
+    size_t heap_objects    = 0; ///< Part of `objects` and `ui_elements` allocated with @b new rather than in a pool.
+    size_t grouped_objects = 0; ///< Objects stored by value in `ObjectGroup` groups.
+    size_t ui_containers   = 0; ///< `UIContainer` objects.
+    size_t ui_elements     = 0; ///< `UIElement` objects of said containers.
+    size_t heap_bytes      = 0; ///< CPU memory held by the objects, their pools and their containers.
+    size_t textures        = 0; ///< Distinct textures referenced, render targets included.
+    size_t texture_bytes   = 0; ///< Estimated video memory of said textures.
+
+    /**
+     * @brief Add the counts of @p other. Texture counts are summed too, so textures shared by both sides are counted twice.
+     */
+    MemoryStats &operator+=(const MemoryStats &other);
+};
+
+
+/**
+ * @brief ## Texture set class
+ * @brief Distinct textures referenced by some objects, used to compute their video memory without counting shared textures twice.
+ */
+class TextureSet {
+private:
+    mutable std::vector<Texture2D> textures; // Every added texture. May hold duplicates until `sorted` is set.
+    mutable bool                   sorted;   // Whether `textures` is sorted by id, without duplicates.
+
+    void Normalize() const;
+public:
+    TextureSet() : sorted(true) {}
+
+    /**
+     * @brief Add a texture. Textures with an id of zero (not loaded) are ignored, and adding the same one twice has no effect.
+     */
+    void   Add(Texture2D texture);
+    /**
+     * @brief Get the number of distinct textures.
+     */
+    size_t Count() const;
+    /**
+     * @brief Get the estimated video memory of all distinct textures, in bytes.
+     */
+    size_t Bytes() const;
+    /**
+     * @brief Remove all textures.
+     */
+    void   Clear();
+
+    /**
+     * @brief Estimate the video memory used by a texture, mipmaps included.
+     * @return The size of the texture's pixel data, in bytes.
+     */
+    static size_t TextureBytes(Texture2D texture);
+};
+
+#endif // MEMORY_STATS_H
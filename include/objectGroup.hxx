@@ -0,0 +1,185 @@
+#ifndef OBJECT_GROUP_H
+#define OBJECT_GROUP_H
+
+#include "globals.hxx"
+#include "slotMap.hxx"
+#include "renderQueue.hxx"
+#include "profiler.hxx"
+#include <utility>
+
+/**
+ * @file objectGroup.hxx
+ * @brief This file contains the `ObjectGroupBase` class and the `ObjectGroup` template class.
+ * @details
+ * An `ObjectGroup` stores many objects of a single type @b by @b value, densely in a `SlotMap`, and updates and draws them by calling
+ * `T::Update()` and `T::Draw()` on the concrete type. Those calls are resolved at compile time and can be inlined, so large amounts
+ * of small objects (particles, bullets...) are processed without a virtual call nor a pointer dereference per object. Only the group
+ * itself is updated and drawn through the virtual `ObjectGroupBase` interface.
+ *
+ * Groups are owned by a `Scene`, one per type, see `Scene::Group()`. They are drawn in world space, ordered by their draw order
+ * around the scene's `GameObject` objects: groups with a negative draw order are drawn before them, the others after them.
+ *
+ * @note Grouped objects are neither culled nor found by `Scene` queries, and their types don't have to derive from `GameObject`.
+ */
+
+
+/**
+ * @brief ## Object group base class
+ * @brief Type erased interface through which a `Scene` updates and draws it's groups.
+ */
+class ObjectGroupBase {
+protected:
+    int                          draw_order;   // Position of the group in it's scene's draw order.
+    RenderQueue<ObjectGroupBase> *owner_queue; // Queue of the scene owning the group, invalidated when `draw_order` changes.
+    const char                  *profile_name; // Name of the group's profiler sections, or @b nullptr.
+    friend class Scene;
+public:
+    ObjectGroupBase() : draw_order(0), owner_queue(nullptr), profile_name(nullptr) {}
+    virtual ~ObjectGroupBase() = default;
+    ObjectGroupBase(const ObjectGroupBase&)            = delete;
+    ObjectGroupBase &operator=(const ObjectGroupBase&) = delete;
+
+    /**
+     * @brief Update every object of the group.
+     */
+    virtual void   UpdateAll()     = 0;
+    /**
+     * @brief Draw every object of the group.
+     */
+    virtual void   DrawAll() const = 0;
+    /**
+     * @brief Get the number of objects in the group.
+     */
+    virtual size_t Size() const    = 0;
+    /**
+     * @brief Get the number of bytes reserved by the group's storage.
+     */
+    virtual size_t ReservedBytes() const = 0;
+
+    /**
+     * @brief Set the group's draw order.
+     * @param _order New draw order, clamped to the [`MIN_DRAW_ORDER`, `MAX_DRAW_ORDER`] range. Negative values draw the group before
+     * the scene's `GameObject` objects.
+     */
+    void SetDrawOrder(int _order)
+    {
+        draw_order = _order;
+        if (draw_order < MIN_DRAW_ORDER) draw_order = MIN_DRAW_ORDER;
+        if (draw_order > MAX_DRAW_ORDER) draw_order = MAX_DRAW_ORDER;
+        if (owner_queue) owner_queue->Invalidate();
+    }
+    /**
+     * @brief Get the group's draw order.
+     */
+    int  GetDrawOrder() const { return draw_order; }
+    /**
+     * @brief Time the group's updates and draws with the profiler, under @p name.
+     * @param name A string literal, or @b nullptr to stop profiling the group.
+     */
+    void SetProfileName(const char *name) { profile_name = name; }
+    /**
+     * @brief Get the name the group is profiled under, or @b nullptr if it is not profiled.
+     */
+    const char *GetProfileName() const { return profile_name; }
+};
+
+
+/**
+ * @brief ## Object group class
+ * @brief Objects of a single type, stored by value and updated and drawn without virtual calls.
+ * @tparam T Type of the objects. Must provide `void Update()` and `void Draw() const`, and be movable.
+ */
+template <typename T>
+class ObjectGroup : public ObjectGroupBase {
+public:
+    /**
+     * @brief Stable identifier of an object stored in the group.
+     */
+    using Handle = SlotHandle;
+private:
+    SlotMap<T> objects; // Densely stored objects.
+public:
+    /**
+     * @brief Construct a new object at the end of the group.
+     * @param args Arguments forwarded to the constructor of @p T.
+     * @return A handle to the new object.
+     */
+    template <typename... Args>
+    Handle Emplace(Args&&... args)
+    {
+        return objects.Insert(T(std::forward<Args>(args)...));
+    }
+    /**
+     * @brief Remove an object. The last object of the group is moved into it's place.
+     * @return @b True if an object was removed. @b False if @p handle did not refer to one.
+     */
+    bool   Remove(Handle handle) { return objects.Erase(handle); }
+    /**
+     * @brief Remove every object for which @p predicate returns @b true, e.g. expired particles.
+     * @param predicate Callable taking a `const T&`.
+     * @return The number of removed objects.
+     */
+    template <typename Predicate>
+    size_t RemoveIf(Predicate predicate)
+    {
+        size_t removed = 0;
+        // Backwards, so the objects moved into the freed positions were already checked
+        for (size_t i = objects.Size(); i-- > 0;)
+        {
+            if (!predicate(objects.begin()[i])) continue;
+            objects.Erase(objects.HandleAt(i));
+            removed++;
+        }
+        return removed;
+    }
+    /**
+     * @brief Remove all objects. Every handle given out so far is invalidated.
+     */
+    void   Clear() { objects.Clear(); }
+    /**
+     * @brief Reserve storage for @p count objects, so adding up to that many does not reallocate.
+     */
+    void   Reserve(size_t count) { objects.Reserve(count); }
+    /**
+     * @brief Check whether @p handle refers to an object of the group.
+     */
+    bool   Contains(Handle handle) const { return objects.Contains(handle); }
+    /**
+     * @brief Get a pointer to an object.
+     * @return A pointer to the object, or @b nullptr if @p handle does not refer to one.
+     * @warning The pointer is invalidated by any later `Emplace()` or `Remove()` call. Keep the handle instead.
+     */
+    T       *Get(Handle handle)       { return objects.Get(handle); }
+    /**
+     * @brief Get a @b constant pointer to an object.
+     * @return A @b constant pointer to the object, or @b nullptr if @p handle does not refer to one.
+     */
+    const T *Get(Handle handle) const { return objects.Get(handle); }
+    size_t   Size() const override    { return objects.Size(); }
+    size_t   ReservedBytes() const override { return objects.ReservedBytes(); }
+
+    void UpdateAll() override
+    {
+        PROFILE_SCOPE(profile_name);
+        // Qualified calls, so virtual members of @p T are still bound at compile time
+        for (T &object : objects)
+        {
+            object.T::Update();
+        }
+    }
+    void DrawAll() const override
+    {
+        PROFILE_SCOPE(profile_name);
+        for (const T &object : objects)
+        {
+            object.T::Draw();
+        }
+    }
+
+    typename SlotMap<T>::iterator       begin()       { return objects.begin(); }
+    typename SlotMap<T>::iterator       end()         { return objects.end();   }
+    typename SlotMap<T>::const_iterator begin() const { return objects.begin(); }
+    typename SlotMap<T>::const_iterator end()   const { return objects.end();   }
+};
+
+#endif // OBJECT_GROUP_H
@@ -0,0 +1,193 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file objectPool.hxx
+ * @brief This file contains the `ObjectPool` and `PoolRegistry` template classes, and the `OwnedPtr` struct.
+ * @details
+ * An `ObjectPool` hands out storage for objects of a single type from fixed size blocks, recycling freed slots through an intrusive
+ * free list. Creating or destroying an object is O(1) and only touches the global allocator when a new block is needed.
+ *
+ * A `PoolRegistry` keeps one `ObjectPool` per concrete type, so every container (e.g. a `Scene`) can own type-segregated pools for all
+ * the types emplaced into it. All blocks are released at once when the registry is destroyed.
+ *
+ * An `OwnedPtr` remembers whether an object came from a pool or from @b new, so containers can free both kinds uniformly.
+ */
+
+
+/**
+ * @brief ## Pool base class
+ * @brief Type erased interface of an `ObjectPool`, as seen from the base class of the pooled objects.
+ * @tparam Base Common base class of the pooled objects.
+ */
+template <typename Base>
+class PoolBase {
+public:
+    virtual ~PoolBase() = default;
+
+    /**
+     * @brief Destroy an object created by this pool and recycle it's storage.
+     * @param object Object to destroy.
+     */
+    virtual void   Destroy(Base *object) = 0;
+    /**
+     * @brief Get the number of live objects created by this pool.
+     */
+    virtual size_t LiveCount() const     = 0;
+    /**
+     * @brief Get the number of bytes reserved by this pool's blocks.
+     */
+    virtual size_t ReservedBytes() const = 0;
+};
+
+
+/**
+ * @brief ## Object pool class
+ * @brief Free-list pool of objects of type @p T.
+ * @tparam T Type of the pooled objects.
+ * @tparam Base Common base class through which pooled objects are destroyed.
+ */
+template <typename T, typename Base>
+class ObjectPool : public PoolBase<Base> {
+private:
+    static constexpr size_t BLOCK_SIZE = 64; // Number of objects per block.
+
+    union Node {
+        Node *next;                                   // Next free node, while the node is free.
+        alignas(T) unsigned char storage[sizeof(T)];  // Object storage, while the node is in use.
+    };
+
+    std::vector<std::unique_ptr<Node[]>> blocks;    // All reserved blocks.
+    Node                                *free_list; // First free node.
+    size_t                               live;      // Number of objects currently alive.
+
+    void Grow()
+    {
+        blocks.emplace_back(new Node[BLOCK_SIZE]);
+        Node *block = blocks.back().get();
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+        {
+            block[i].next = free_list;
+            free_list = &block[i];
+        }
+    }
+public:
+    ObjectPool() : free_list(nullptr), live(0) {}
+    ObjectPool(const ObjectPool&)            = delete;
+    ObjectPool &operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Construct a new object inside the pool.
+     * @param args Arguments forwarded to the constructor of @p T.
+     * @return A pointer to the new object.
+     */
+    template <typename... Args>
+    T *Create(Args&&... args)
+    {
+        if (!free_list) Grow();
+        Node *node = free_list;
+        free_list  = node->next;
+        T *object;
+        try {
+            object = new (node->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            node->next = free_list;
+            free_list  = node;
+            throw;
+        }
+        live++;
+        return object;
+    }
+
+    void Destroy(Base *object) override
+    {
+        T *typed = static_cast<T*>(object);
+        typed->~T();
+        Node *node = reinterpret_cast<Node*>(typed);
+        node->next = free_list;
+        free_list  = node;
+        live--;
+    }
+
+    size_t LiveCount()     const override { return live; }
+    size_t ReservedBytes() const override { return blocks.size() * BLOCK_SIZE * sizeof(Node); }
+};
+
+
+/**
+ * @brief ## Pool registry class
+ * @brief Owns one `ObjectPool` per concrete type derived from @p Base.
+ * @tparam Base Common base class of the pooled objects.
+ * @warning Pools do @b not destroy objects still alive when the registry is destroyed, they only release their memory.
+ */
+template <typename Base>
+class PoolRegistry {
+private:
+    std::unordered_map<std::type_index, std::unique_ptr<PoolBase<Base>>> pools;
+public:
+    /**
+     * @brief Get the pool for objects of type @p T, creating it if needed.
+     * @tparam T Concrete type of the pooled objects.
+     * @return A reference to said pool.
+     */
+    template <typename T>
+    ObjectPool<T, Base> &Get()
+    {
+        auto &pool = pools[std::type_index(typeid(T))];
+        if (!pool) pool.reset(new ObjectPool<T, Base>());
+        return static_cast<ObjectPool<T, Base>&>(*pool);
+    }
+
+    /**
+     * @brief Get the number of bytes reserved by all pools.
+     */
+    size_t ReservedBytes() const
+    {
+        size_t bytes = 0;
+        for (auto &pool : pools) bytes += pool.second->ReservedBytes();
+        return bytes;
+    }
+};
+
+
+/**
+ * @brief ## Owned pointer struct
+ * @brief Owning pointer to an object allocated either by an `ObjectPool` or by @b new.
+ * @tparam Base Type through which the object is accessed and destroyed.
+ */
+template <typename Base>
+struct OwnedPtr {
+    Base           *object; ///< The owned object.
+    PoolBase<Base> *pool;   ///< Pool that created `object`, or @b nullptr if it was allocated with @b new.
+
+    Base *operator->() const { return object; }
+
+    /**
+     * @brief Destroy the object and free it's memory.
+     */
+    void Destroy()
+    {
+        if (pool) pool->Destroy(object);
+        else      delete object;
+    }
+    /**
+     * @brief Destroy the object, leaving pooled memory to be released together with it's pool.
+     * @note Used on teardown, where the whole pool is about to be released anyway.
+     */
+    void Finalize()
+    {
+        if (pool) object->~Base();
+        else      delete object;
+    }
+};
+
+#endif // OBJECT_POOL_H
@@ -0,0 +1,172 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include "gameObject.hxx"
+#include "resourceManager.hxx"
+#include "textureAtlas.hxx"
+#include <memory>
+#include <random>
+#include <vector>
+
+class AnimatedTexture;
+
+/**
+ * @file particleSystem.hxx
+ * @brief This file contains the `ParticleEmitter` struct and the `ParticleSystem` class.
+ * @details
+ * A `ParticleSystem` is a single `GameObject` simulating up to a fixed number of short-lived sprites. Particle state is kept as a
+ * structure of arrays allocated once, at the maximum particle count, so emitting and expiring particles never allocates and the
+ * cost of a frame is bounded by said count.
+ *
+ * Particles are updated in contiguous chunks on `job_system`'s workers when there are enough of them, and all particles are drawn
+ * from the same texture (usually a `TextureAtlas`) in a single pass through raylib's render batch, so the whole system ends up in as
+ * few draw calls as the batch allows.
+ *
+ * Particles are emitted at the system's position, and then move in world space on their own: moving the system does not drag it's
+ * live particles along.
+ */
+
+
+/**
+ * @brief ## Particle emitter struct
+ * @brief Describes how a `ParticleSystem` emits particles, and how they change over their lifetime.
+ */
+struct ParticleEmitter {
+    float   rate         = 50;                  ///< Particles emitted per second, while emitting.
+    float   lifetime_min = 1;                   ///< Shortest lifetime of a particle, in seconds.
+    float   lifetime_max = 1;                   ///< Longest lifetime of a particle, in seconds.
+    float   speed_min    = 50;                  ///< Lowest initial speed, in units per second.
+    float   speed_max    = 100;                 ///< Highest initial speed, in units per second.
+    float   direction    = -90;                 ///< Mean direction particles are emitted in, in degrees. -90 points up.
+    float   spread       = 360;                 ///< Angle around `direction` particles are emitted in, in degrees.
+    float   spawn_radius = 0;                   ///< Radius of the disc around the system's position particles appear in.
+    Vector2 gravity      = {0, 0};              ///< Acceleration applied to every particle, in units per second squared.
+    float   drag         = 0;                   ///< Fraction of it's velocity a particle loses every second.
+    float   spin_min     = 0;                   ///< Lowest angular velocity, in degrees per second.
+    float   spin_max     = 0;                   ///< Highest angular velocity, in degrees per second.
+    float   scale_start  = 1;                   ///< Scale of a particle when emitted.
+    float   scale_end    = 1;                   ///< Scale of a particle when it expires.
+    Color   color_start  = WHITE;               ///< Tint of a particle when emitted.
+    Color   color_end    = {255, 255, 255, 0};  ///< Tint of a particle when it expires.
+    float   frame_rate   = 0;                   ///< Frames per second of animated particles. Zero plays all frames once over the lifetime.
+};
+
+
+/**
+ * @brief ## Particle system class
+ * @brief Emits, simulates and draws a bounded number of particles.
+ */
+class ParticleSystem : public GameObject {
+private:
+    ParticleEmitter emitter;  // Emission and lifetime settings.
+    size_t capacity;          // Maximum number of live particles.
+    size_t count;             // Number of live particles. They are the first `count` entries of every array.
+    bool   emitting;          // Whether particles are emitted continuously.
+    double emit_carry;        // Fraction of a particle left over from the last emission.
+
+    std::vector<float> position_x, position_y; // Position of every particle.
+    std::vector<float> velocity_x, velocity_y; // Velocity of every particle.
+    std::vector<float> rotation, spin;         // Rotation and angular velocity of every particle, in degrees.
+    std::vector<float> age, lifetime;          // Time since emission, and total lifetime, of every particle.
+
+    TextureHandle                 texture; // Texture particles are drawn with, unless `atlas` is set.
+    std::shared_ptr<TextureAtlas> atlas;   // Atlas particles are drawn from, or @b nullptr.
+    std::vector<Rectangle>        frames;  // Regions of the texture particles cycle through. Empty means the whole texture.
+
+    Rectangle    bounds;     // Area covered by the live particles, as of the last `Update()`.
+    std::minstd_rand random; // Generator used for emission. Only used on the main thread.
+
+    float RandomRange(float min, float max);
+    void  Spawn(size_t amount);
+    void  Simulate(size_t begin, size_t end, float dt);
+    void  Compact();
+    void  ComputeBounds();
+public:
+    static constexpr size_t PARALLEL_THRESHOLD = 4096; ///< Particle count from which `Update()` runs on `job_system`.
+    static constexpr size_t PARALLEL_CHUNK     = 1024; ///< Number of particles simulated by a single job.
+
+    /**
+     * @brief Create an empty particle system.
+     * @param _emitter Emission and lifetime settings.
+     * @param max_particles Hard cap on the number of live particles. Emission stops while it is reached.
+     * @param _transform Position particles are emitted at. Rotation and scale are unused.
+     * @note Particles are drawn with the texture given to `SetTexture()`, `SetAtlas()` or `SetAnimation()`. Nothing is drawn until then.
+     */
+    ParticleSystem(const ParticleEmitter &_emitter, size_t max_particles, Transform2D _transform = {});
+
+    /**
+     * @brief Draw particles with a whole texture.
+     */
+    void SetTexture(const TextureHandle &_texture);
+    /**
+     * @brief Draw particles with regions of an atlas.
+     * @param _atlas The atlas, kept alive by the system.
+     * @param regions Regions of the atlas particles cycle through over their lifetime, see `ParticleEmitter::frame_rate`. If empty,
+     * particles are drawn with the whole atlas texture.
+     */
+    void SetAtlas(std::shared_ptr<TextureAtlas> _atlas, std::vector<Rectangle> regions);
+    /**
+     * @brief Draw particles with the frames of an animation.
+     * @param animation An animation initialized in atlas mode, see `AnimatedTexture::Initialize()`.
+     * @return @b True if the frames were taken. @b False if @p animation is not in atlas mode, in which case nothing changes.
+     */
+    bool SetAnimation(const AnimatedTexture &animation);
+
+    /**
+     * @brief Start or stop emitting particles continuously. Live particles keep going either way.
+     */
+    void SetEmitting(bool enabled);
+    /**
+     * @brief Check whether particles are emitted continuously.
+     */
+    bool IsEmitting() const;
+    /**
+     * @brief Emit a burst of particles right away.
+     * @param amount Number of particles. Limited by the room left below the particle cap.
+     */
+    void Emit(size_t amount);
+    /**
+     * @brief Remove all live particles.
+     */
+    void Clear();
+
+    /**
+     * @brief Get a reference to the emission settings, which may be changed at any time.
+     */
+    ParticleEmitter       &GetEmitter();
+    /**
+     * @brief Get a @b constant reference to the emission settings.
+     */
+    const ParticleEmitter &GetEmitter() const;
+    /**
+     * @brief Get the number of live particles.
+     */
+    size_t GetCount() const;
+    /**
+     * @brief Get the maximum number of live particles.
+     */
+    size_t GetCapacity() const;
+
+    /**
+     * @brief Emit new particles, move the live ones and expire the old ones.
+     * @note Time is read from `frame_clock`.
+     */
+    void Update() override;
+    /**
+     * @brief Draw every live particle in one pass.
+     * @note Flushes `sprite_batch` first, so the particles are drawn above everything submitted before them.
+     */
+    void Draw() const override;
+    /**
+     * @brief Get the area covered by the live particles.
+     * @return @b False if there are no live particles.
+     */
+    bool GetBounds(Rectangle &_bounds) const override;
+    /**
+     * @brief Reports the texture or atlas particles are drawn with.
+     */
+    void CollectTextures(TextureSet &textures) const override;
+    const char *GetProfileName() const override { return "ParticleSystem"; }
+};
+
+#endif // PARTICLE_SYSTEM_H
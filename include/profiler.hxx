@@ -0,0 +1,202 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "globals.hxx"
+#include "ringBuffer.hxx"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @file profiler.hxx
+ * @brief This file contains the `Profiler` class, the `ProfileScope` class and the `PROFILE_SCOPE` macro.
+ * @details
+ * Timed sections are delimited with `PROFILE_SCOPE(name)`, which measures the time until the end of the enclosing scope. Samples are
+ * pushed to a lock-free ring buffer, so sections can be timed on any thread, and they are collected by `Profiler::EndFrame()` once per frame.
+ *
+ * For every section, the profiler keeps the total time spent in it over the last `Profiler::HISTORY` frames, from which
+ * `Profiler::GetStats()` computes the minimum, average and 99th percentile. These can be shown on screen with a `UI::ProfilerOverlay`.
+ * Raw samples can also be captured and exported as a Chrome trace file (open it in `chrome://tracing` or https://ui.perfetto.dev).
+ *
+ * `SceneManager`, `Scene` and `UIContainer` are instrumented out of the box. `GameObject` types opt in by overriding
+ * `GameObject::GetProfileName()`.
+ *
+ * Define `RGAME_DISABLE_PROFILER` when compiling to remove all `PROFILE_SCOPE` instrumentation from the build.
+ */
+
+
+/**
+ * @brief ## Profile sample struct
+ * @brief A single timed section run.
+ */
+struct ProfileSample {
+    const char *name;        ///< Section name. Must outlive the profiler.
+    int64_t     start_ns;    ///< Start time, in nanoseconds since the profiler was created.
+    int64_t     duration_ns; ///< Duration, in nanoseconds.
+    uint32_t    thread;      ///< Small integer identifying the thread that ran the section.
+};
+
+/**
+ * @brief ## Profile stats struct
+ * @brief Rolling statistics of a section, in milliseconds per frame.
+ */
+struct ProfileStats {
+    std::string name;   ///< Section name.
+    float       min_ms; ///< Fastest frame.
+    float       avg_ms; ///< Average over the history.
+    float       p99_ms; ///< 99th percentile.
+};
+
+/**
+ * @brief ## Profiler class
+ * @brief Collects timed sections and keeps rolling per-frame statistics about them.
+ */
+class Profiler {
+public:
+    static constexpr size_t HISTORY     = 120;     ///< Number of frames statistics are computed over.
+    static constexpr size_t CAPACITY    = 1 << 14; ///< Maximum number of samples between two `EndFrame()` calls.
+    static constexpr size_t MAX_CAPTURE = 1 << 20; ///< Maximum number of samples kept by a capture.
+private:
+    struct Section {
+        float  history[HISTORY]; // Per-frame totals, in milliseconds. Circular.
+        size_t next;             // Next position to write in `history`.
+        size_t count;            // Number of valid values in `history`.
+        int64_t frame_ns;        // Accumulated time during the current frame.
+        bool   hit;              // Whether the section ran during the current frame.
+    };
+
+    RingBuffer<ProfileSample, CAPACITY> samples; // Samples pushed since the last `EndFrame()`.
+    std::atomic<bool>   enabled;                 // Whether scopes record anything.
+    std::atomic<size_t> dropped;                 // Samples lost because `samples` was full.
+    const std::chrono::steady_clock::time_point epoch;
+    int64_t last_frame_ns;                       // End time of the previous frame.
+
+    std::map<std::string, Section>               sections; // Statistics by section name.
+    std::unordered_map<const char*, Section*>    lookup;   // Section by name pointer, to avoid string comparisons.
+    std::vector<ProfileSample>                   capture;  // Samples recorded during a capture.
+    bool                                         capturing;
+
+    std::mutex                      names_mutex; // Protects `names`.
+    std::unordered_set<std::string> names;       // Names returned by `Intern()`.
+
+    Section &FindSection(const char *name);
+public:
+    Profiler();
+    Profiler(const Profiler&)            = delete;
+    Profiler &operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Enable or disable recording at runtime. Enabled by default.
+     */
+    void SetEnabled(bool _enabled);
+    /**
+     * @brief Check whether scopes are being recorded.
+     */
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    /**
+     * @brief Get the current time, in nanoseconds since the profiler was created.
+     */
+    int64_t Now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count(); }
+
+    /**
+     * @brief Record a timed section. Safe to call from any thread.
+     * @param name Section name. Must be a string literal or a string returned by `Intern()`.
+     * @param start_ns Start time, as returned by `Now()`.
+     * @param duration_ns Duration, in nanoseconds.
+     */
+    void Record(const char *name, int64_t start_ns, int64_t duration_ns);
+    /**
+     * @brief Get a copy of @p name that lives as long as the profiler, to be used as a section name.
+     * @param name Section name.
+     * @return A pointer to the stored copy. Interning the same name twice returns the same pointer.
+     */
+    const char *Intern(const std::string &name);
+
+    /**
+     * @brief Collect the samples of the current frame and update the statistics. Also records the `"Frame"` section.
+     * @note Called by `SceneManager::Draw()`.
+     * @warning Must always be called from the same thread.
+     */
+    void EndFrame();
+    /**
+     * @brief Get the statistics of every section seen so far, sorted by name.
+     */
+    std::vector<ProfileStats> GetStats() const;
+    /**
+     * @brief Get the number of samples lost because too many were recorded in a single frame.
+     */
+    size_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Start keeping every collected sample, to be exported by `EndCapture()`.
+     */
+    void BeginCapture();
+    /**
+     * @brief Stop capturing and write the captured samples as a Chrome trace JSON file.
+     * @param path Path of the file to write.
+     * @return @b True if the file was written. @b False otherwise.
+     */
+    bool EndCapture(const std::filesystem::path &path);
+    /**
+     * @brief Check whether a capture is in progress.
+     */
+    bool IsCapturing() const { return capturing; }
+};
+
+/**
+ * @brief Global profiler used by `PROFILE_SCOPE`.
+ */
+extern Profiler profiler;
+
+
+/**
+ * @brief ## Profile scope class
+ * @brief Records the time between its construction and destruction as a section of the global `profiler`.
+ * @note Prefer the `PROFILE_SCOPE` macro, which can be compiled out.
+ */
+class ProfileScope {
+private:
+    const char *name;  // Section name, or @b nullptr if nothing is recorded.
+    int64_t     start; // Start time.
+public:
+    /**
+     * @brief Start timing a section.
+     * @param _name Section name. Must be a string literal or a string returned by `Profiler::Intern()`. If @b nullptr, nothing is recorded.
+     */
+    explicit ProfileScope(const char *_name) : name(_name), start(0)
+    {
+        if (!name || !profiler.IsEnabled())
+        {
+            name = nullptr;
+            return;
+        }
+        start = profiler.Now();
+    }
+    ~ProfileScope()
+    {
+        if (name)
+            profiler.Record(name, start, profiler.Now() - start);
+    }
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope &operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef RGAME_DISABLE_PROFILER
+/**
+ * @brief Time the rest of the enclosing scope as the section @p name.
+ * @note @p name is only evaluated while the profiler is enabled, so it may be a virtual call such as `GameObject::GetProfileName()`.
+ */
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(profiler.IsEnabled() ? (name) : nullptr)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
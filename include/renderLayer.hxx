@@ -0,0 +1,44 @@
+#ifndef RENDER_LAYER_H
+#define RENDER_LAYER_H
+
+#include "globals.hxx"
+#include <cstdint>
+
+/**
+ * @file renderLayer.hxx
+ * @brief This file contains the `RenderLayer` struct.
+ * @details
+ * A scene without render layers draws all of it's objects once, through the global `camera`. Adding layers with `Scene::AddLayer()`
+ * replaces that single pass: every layer draws the objects matching it's mask through it's own camera, culled against the scene's
+ * spatial index, in the order the layers were added. This covers split-screen views, minimaps and parallax backgrounds without drawing
+ * the whole scene several times.
+ *
+ * Cached layers draw into their own render texture, which is then stretched over their viewport. The texture is only redrawn when
+ * the layer's camera or size changes, when an object of the layer is added, removed or has it's bounds changed, when the scene's
+ * groups are updated (for layers drawing them), or when `Scene::InvalidateLayer()` is called; and at most once per `refresh_interval`.
+ * Objects whose look changes without their bounds changing (e.g. animations) must invalidate their layer themselves.
+ *
+ * `UIContainer` objects are not part of any layer, and are always drawn after all of them.
+ */
+
+
+/**
+ * @brief ## Render layer struct
+ * @brief A view of a scene's objects, drawn through it's own camera to a part of the screen.
+ */
+struct RenderLayer {
+    static constexpr uint32_t ALL_OBJECTS = 0xFFFFFFFFu; ///< Mask matching the objects of every layer.
+
+    Camera2D  camera           = Camera2D{Vector2{0, 0}, Vector2{0, 0}, 0.0f, 1.0f}; ///< Camera the layer is drawn through. It's offset is relative to the screen, or to the render texture of cached layers.
+    Rectangle viewport         = Rectangle{0, 0, 0, 0}; ///< Part of the screen the layer is drawn to, in pixels. The whole screen if it has no size.
+    uint32_t  mask             = 1;       ///< Object layers drawn, matched against `Scene::SetObjectLayers()`. Objects are in layer 1 by default.
+    bool      draw_groups      = true;    ///< Whether the scene's `ObjectGroup` groups are drawn too.
+    bool      visible          = true;    ///< Whether the layer is drawn at all.
+    bool      cached           = false;   ///< Whether the layer is drawn into a render texture, which is only redrawn when it's out of date.
+    int       target_width     = 0;       ///< Width of the render texture of a cached layer, in pixels. The viewport's width if zero.
+    int       target_height    = 0;       ///< Height of the render texture of a cached layer, in pixels. The viewport's height if zero.
+    double    refresh_interval = 0.0;     ///< Minimum simulation time between two redraws of a cached layer, in seconds. Zero redraws as soon as needed.
+    Color     clear            = BLANK;   ///< Color the layer is cleared to before drawing. Transparent layers let the ones below show through.
+};
+
+#endif // RENDER_LAYER_H
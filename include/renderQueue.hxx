@@ -0,0 +1,92 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "globals.hxx"
+#include <array>
+
+/**
+ * @file renderQueue.hxx
+ * @brief This file contains the `RenderQueue` template class.
+ * @details
+ * A `RenderQueue` keeps a list of drawable pointers already ordered by their draw order, so containers can draw all of their
+ * items in a single linear pass instead of scanning every item once per possible draw order.
+ *
+ * The queue is never rebuilt on its own. The owning container calls `Invalidate()` whenever an item is added, removed or changes
+ * it's draw order, and rebuilds the queue on the next draw. Rebuilding is a stable counting sort over the
+ * [`MIN_DRAW_ORDER`, `MAX_DRAW_ORDER`] range, so items sharing a draw order keep the order in which the container stores them.
+ */
+
+
+/**
+ * @brief ## Render queue class
+ * @brief Stores non-owning pointers to drawable items sorted by draw order.
+ * @tparam T Type of the stored items. Must provide an `int GetDrawOrder() const` method.
+ */
+template <typename T>
+class RenderQueue {
+private:
+    static constexpr int BUCKET_COUNT = MAX_DRAW_ORDER - MIN_DRAW_ORDER + 1;
+
+    std::vector<T*> queue; // Items sorted by draw order.
+    bool dirty;            // Whether `queue` no longer reflects the container's contents.
+public:
+    /**
+     * @brief Create an empty, invalidated queue.
+     */
+    RenderQueue() : dirty(true) {}
+
+    /**
+     * @brief Mark the queue as outdated. It will be rebuilt by the next `Rebuild()` call.
+     */
+    void Invalidate() { dirty = true; }
+    /**
+     * @brief Check whether the queue needs to be rebuilt.
+     * @return @b True if `Invalidate()` was called since the last rebuild. @b False otherwise.
+     */
+    bool IsDirty() const { return dirty; }
+
+    /**
+     * @brief Rebuild the queue from a range of items, if it was invalidated.
+     * @param begin Iterator to the first item of the owning container.
+     * @param end Iterator past the last item of the owning container.
+     * @param get Callable that turns a dereferenced iterator into a `T*`.
+     * @param last_order Highest draw order that will be queued. Items above it are left out of the queue.
+     */
+    template <typename Iterator, typename Getter>
+    void Rebuild(Iterator begin, Iterator end, Getter get, int last_order = MAX_DRAW_ORDER)
+    {
+        if (!dirty) return;
+
+        std::array<size_t, BUCKET_COUNT + 1> offsets{};
+        size_t count = 0;
+        for (Iterator it = begin; it != end; ++it)
+        {
+            int order = get(*it)->GetDrawOrder();
+            if (order > last_order) continue;
+            offsets[order - MIN_DRAW_ORDER + 1]++;
+            count++;
+        }
+        for (int i = 1; i <= BUCKET_COUNT; i++)
+        {
+            offsets[i] += offsets[i - 1];
+        }
+
+        queue.resize(count);
+        for (Iterator it = begin; it != end; ++it)
+        {
+            T *item = get(*it);
+            int order = item->GetDrawOrder();
+            if (order > last_order) continue;
+            queue[offsets[order - MIN_DRAW_ORDER]++] = item;
+        }
+        dirty = false;
+    }
+
+    /**
+     * @brief Get the sorted items.
+     * @return A @b constant reference to the items, from the lowest to the highest draw order.
+     */
+    const std::vector<T*> &Items() const { return queue; }
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,280 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include "globals.hxx"
+#include "fileWatcher.hxx"
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file resourceManager.hxx
+ * @brief This file contains the `ResourceManager` class and the `ResourceHandle` template class.
+ * @details
+ * The `ResourceManager` is a shared cache of GPU resources (textures, shaders and fonts) keyed by their path. Loading the same path twice
+ * returns a handle to the already loaded resource instead of loading it again.
+ *
+ * Handles are reference counted: copying a handle adds a reference, destroying it removes one, and the resource is unloaded as soon as
+ * the last handle referring to it is gone.
+ *
+ * Texture paths are relative to `TEXTURES_PATH`, shader paths are relative to `SHADERS_PATH` and font paths are relative to `FONTS_PATH`.
+ *
+ * With hot reloading enabled, `RESOURCES_PATH` is watched for changes and modified textures and shaders are reloaded in place by
+ * `ProcessReloads()`, so existing handles keep referring to the up to date resource. Fonts and textures created by `AdoptTexture()` are
+ * not reloaded.
+ */
+
+
+class ResourceManager;
+
+/**
+ * @brief ## Font asset struct
+ * @brief A font whose glyphs are packed into a single atlas texture.
+ */
+struct FontAsset {
+    Font font; ///< The font. It's texture holds the glyph atlas.
+    bool sdf;  ///< Whether the atlas holds signed distance fields, which must be drawn with `FontManager`'s SDF shader.
+};
+
+/**
+ * @brief ## Resource entry struct
+ * @brief Cache entry shared by all the handles to the same resource.
+ * @tparam T Type of the cached resource.
+ */
+template <typename T>
+struct ResourceEntry {
+    T                resource;   ///< The cached resource.
+    int              references; ///< Number of live handles to this entry.
+    std::string      key;        ///< Cache key.
+    bool             loaded;     ///< Whether loading finished. Only @b false while an asynchronous load is pending.
+    ResourceManager *owner;      ///< Manager holding the entry, or @b nullptr once said manager is gone.
+};
+
+/**
+ * @brief ## Resource handle class
+ * @brief Reference counted handle to a resource cached by the `ResourceManager`.
+ * @tparam T Type of the referred resource.
+ */
+template <typename T>
+class ResourceHandle {
+private:
+    ResourceEntry<T> *entry; // Shared entry, or @b nullptr for empty handles.
+public:
+    /**
+     * @brief Create an empty handle.
+     */
+    ResourceHandle() : entry(nullptr) {}
+    /**
+     * @brief Create a handle to @p _entry, adding a reference to it.
+     */
+    explicit ResourceHandle(ResourceEntry<T> *_entry) : entry(_entry) { if (entry) entry->references++; }
+    ResourceHandle(const ResourceHandle &other) : entry(other.entry) { if (entry) entry->references++; }
+    ResourceHandle(ResourceHandle &&other) noexcept : entry(other.entry) { other.entry = nullptr; }
+    ResourceHandle &operator=(ResourceHandle other) noexcept { std::swap(entry, other.entry); return *this; }
+    /**
+     * @brief Remove this handle's reference. Unloads the resource if it was the last one.
+     */
+    ~ResourceHandle() { Reset(); }
+
+    /**
+     * @brief Drop the referred resource, leaving the handle empty.
+     */
+    void Reset();
+    /**
+     * @brief Check whether the handle refers to a resource.
+     */
+    bool IsValid() const { return entry != nullptr; }
+    /**
+     * @brief Check whether the referred resource finished loading.
+     * @return @b True if the handle is valid and it's resource is not waiting on an asynchronous load. @b False otherwise.
+     */
+    bool IsReady() const { return entry && entry->loaded; }
+    /**
+     * @brief Get the cache key of the referred resource, e.g. the path it was loaded from.
+     * @return The key, or an empty string if the handle is empty.
+     */
+    const std::string &GetKey() const
+    {
+        static const std::string empty;
+        return entry ? entry->key : empty;
+    }
+    /**
+     * @brief Get the referred resource.
+     * @return A @b constant reference to the resource, or to a zero initialized resource if the handle is empty.
+     */
+    const T &Get() const
+    {
+        static const T empty{};
+        return entry ? entry->resource : empty;
+    }
+};
+
+using TextureHandle = ResourceHandle<Texture2D>; ///< Handle to a cached `Texture2D`.
+using ShaderHandle  = ResourceHandle<Shader>;    ///< Handle to a cached `Shader`.
+using FontHandle    = ResourceHandle<FontAsset>; ///< Handle to a cached `FontAsset`.
+
+
+/**
+ * @brief ## Texture usage struct
+ * @brief Memory used by a texture cached by the `ResourceManager`, see `ResourceManager::GetTextureUsage()`.
+ */
+struct TextureUsage {
+    std::string key;        ///< Cache key, e.g. the path the texture was loaded from.
+    int         width;      ///< Width of the texture, in pixels.
+    int         height;     ///< Height of the texture, in pixels.
+    size_t      bytes;      ///< Estimated video memory, mipmaps included.
+    int         references; ///< Number of live handles to the texture.
+};
+
+
+/**
+ * @brief ## Resource manager class
+ * @brief Deduplicating, reference counted cache of textures, shaders and fonts.
+ * @warning All resources must be acquired after window initialization.
+ */
+class ResourceManager {
+private:
+    std::unordered_map<std::string, ResourceEntry<Texture2D>*> textures; // Cached textures by key.
+    std::unordered_map<std::string, ResourceEntry<Shader>*>    shaders;  // Cached shaders by key.
+    std::unordered_map<std::string, ResourceEntry<FontAsset>*> fonts;    // Cached fonts by key.
+    size_t adopted_count;                                                // Number of textures adopted so far, used to generate their keys.
+
+    struct Derived {
+        std::string            source; // Texture file the generated texture is built from, relative to `TEXTURES_PATH`.
+        std::function<Image()> build;  // Function building the generated texture's image.
+    };
+    std::map<std::string, Derived>           derived;      // Generated textures depending on a texture file, by key. Ordered, so a texture derived from another one by extending it's key is rebuilt after it.
+    FileWatcher                              watcher;      // Watches `RESOURCES_PATH` while hot reloading is enabled.
+    std::vector<std::string>                 reload_paths; // Auxiliary vector used by `ProcessReloads()`.
+    size_t                                   reload_count; // Number of `ProcessReloads()` calls that reloaded something.
+
+    bool ReloadTexture(ResourceEntry<Texture2D> *entry, Image image);
+    bool ReloadShader(ResourceEntry<Shader> *entry);
+
+    template <typename T> friend class ResourceHandle;
+    void Release(ResourceEntry<Texture2D> *entry);
+    void Release(ResourceEntry<Shader>    *entry);
+    void Release(ResourceEntry<FontAsset> *entry);
+public:
+    ResourceManager();
+    /**
+     * @brief Detaches all remaining entries. Resources still referenced by handles are left for said handles to release.
+     */
+    ~ResourceManager();
+    ResourceManager(const ResourceManager&)            = delete;
+    ResourceManager &operator=(const ResourceManager&) = delete;
+
+    /**
+     * @brief Get a handle to a texture file, loading it if it is not cached yet.
+     * @param path Path of the texture file, relative to `TEXTURES_PATH`.
+     * @return A handle to the texture.
+     */
+    TextureHandle AcquireTexture(const std::string &path);
+    /**
+     * @brief Get a handle to a texture generated from an image, building it if it is not cached yet.
+     * @param key Unique key of the generated texture. Must not collide with any texture file path.
+     * @param build Function returning the image to upload. Only called on a cache miss. The image is unloaded afterwards.
+     * @param source Texture file @p build reads from, relative to `TEXTURES_PATH`. If not empty, the texture is built again when said
+     * file is hot reloaded.
+     * @return A handle to the texture.
+     * @note Useful to share preprocessed variants of a texture file (e.g. padded `UI::Button` textures) without redoing the work.
+     */
+    TextureHandle AcquireTexture(const std::string &key, const std::function<Image()> &build, const std::string &source = "");
+    /**
+     * @brief Get a handle to a texture file, decoding it in the background if it is not cached yet.
+     * @param path Path of the texture file, relative to `TEXTURES_PATH`.
+     * @return A handle to the texture. It holds an empty texture until `IsReady()` returns @b true.
+     * @note The file is decoded by `asset_loader` and uploaded during a later `AssetLoader::ProcessUploads()` call.
+     */
+    TextureHandle AcquireTextureAsync(const std::string &path);
+    /**
+     * @brief Wrap an already loaded texture in a handle so it gets unloaded when it's last handle is gone.
+     * @param texture The texture to adopt. Ownership is passed to the manager.
+     * @return A handle to the texture. Adopted textures are never shared through the cache.
+     */
+    TextureHandle AdoptTexture(Texture2D texture);
+    /**
+     * @brief Get a handle to a shader program, loading it if it is not cached yet.
+     * @param vs_path Path of the vertex shader, relative to `SHADERS_PATH`. If empty, raylib's default vertex shader is used.
+     * @param fs_path Path of the fragment shader, relative to `SHADERS_PATH`. If empty, raylib's default fragment shader is used.
+     * @return A handle to the shader.
+     */
+    ShaderHandle  AcquireShader(const std::string &vs_path, const std::string &fs_path);
+    /**
+     * @brief Get a handle to a font file rasterized at a given size, loading it if it is not cached yet.
+     * @param path Path of the TTF/OTF file, relative to `FONTS_PATH`.
+     * @param base_size Size the glyphs are rasterized at, in pixels.
+     * @param sdf Whether to rasterize the glyphs as signed distance fields, which stay sharp at any drawing size.
+     * @return A handle to the font. If the file can't be loaded, it holds raylib's default font instead.
+     * @note Only the printable ASCII glyphs are loaded.
+     */
+    FontHandle    AcquireFont(const std::string &path, int base_size, bool sdf);
+
+    /**
+     * @brief Enable or disable hot reloading of textures and shaders.
+     * @param enabled If @b true, `RESOURCES_PATH` is scanned for modified files on a background thread.
+     * @param interval_ms Time between two scans, in milliseconds.
+     * @note Meant for development builds, scanning costs a little CPU time on the background thread.
+     */
+    void   SetHotReload(bool enabled, int interval_ms = 500);
+    /**
+     * @brief Check whether hot reloading is enabled.
+     */
+    bool   IsHotReloading() const;
+    /**
+     * @brief Reload the cached textures and shaders whose files changed since the last call.
+     * @return The number of reloaded resources.
+     * @note Called at the start of every frame by `SceneManager::Update()` and `SceneManager::Tick()`. Textures keeping their size and
+     * format are updated without changing their id. Shaders that fail to compile are kept as they were.
+     * @warning Function must be called from the main thread.
+     */
+    size_t ProcessReloads();
+    /**
+     * @brief Get the number of `ProcessReloads()` calls that reloaded something. Lets users of the resources know when they changed.
+     */
+    size_t GetReloadCount() const;
+
+    /**
+     * @brief Get the number of textures currently cached.
+     */
+    size_t GetTextureCount() const;
+    /**
+     * @brief Get the estimated video memory used by all cached textures, in bytes.
+     */
+    size_t GetTextureBytes() const;
+    /**
+     * @brief Get the size and reference count of every cached texture, largest first.
+     * @note Textures waiting on an asynchronous load are left out.
+     */
+    std::vector<TextureUsage> GetTextureUsage() const;
+    /**
+     * @brief Get the number of shaders currently cached.
+     */
+    size_t GetShaderCount() const;
+    /**
+     * @brief Get the number of fonts currently cached.
+     */
+    size_t GetFontCount() const;
+};
+
+/**
+ * @brief Global resource cache used by `AnimatedTexture`, `UI::Button` and `UI::ImageDisplay`.
+ */
+extern ResourceManager resources;
+
+
+template <typename T>
+void ResourceHandle<T>::Reset()
+{
+    if (!entry) return;
+    if (--entry->references == 0)
+    {
+        if (entry->owner) entry->owner->Release(entry);
+        else              delete entry;
+    }
+    entry = nullptr;
+}
+
+#endif // RESOURCE_MANAGER_H
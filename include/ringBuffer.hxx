@@ -0,0 +1,92 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file ringBuffer.hxx
+ * @brief This file contains the `RingBuffer` template class.
+ * @details
+ * The `RingBuffer` is a bounded, lock-free queue that any number of threads can push to, and a single thread can pop from. Every slot
+ * carries a sequence number that tells producers whether it is free and tells the consumer whether it has been published, so neither side
+ * ever blocks: pushing to a full buffer simply fails.
+ */
+
+
+/**
+ * @brief ## Ring buffer class
+ * @brief Bounded multi-producer, single-consumer lock-free queue.
+ * @tparam T Type of the stored values. Must be trivially copyable.
+ * @tparam CAPACITY Number of slots. Must be a power of two.
+ */
+template <typename T, size_t CAPACITY>
+class RingBuffer {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "RingBuffer capacity must be a power of two");
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence; // Equals the slot position when free, and the position + 1 once published.
+        T                     value;
+    };
+
+    Slot                  slots[CAPACITY];
+    alignas(64) std::atomic<uint64_t> head; // Next position to push to. Shared by all producers.
+    alignas(64) uint64_t              tail; // Next position to pop from. Only touched by the consumer.
+public:
+    RingBuffer() : head(0), tail(0)
+    {
+        for (size_t i = 0; i < CAPACITY; i++)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    RingBuffer(const RingBuffer&)            = delete;
+    RingBuffer &operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Push a value. Safe to call from any thread.
+     * @param value Value to push.
+     * @return @b True if the value was pushed. @b False if the buffer was full.
+     */
+    bool Push(const T &value)
+    {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[position & (CAPACITY - 1)];
+            int64_t diff = (int64_t)slot.sequence.load(std::memory_order_acquire) - (int64_t)position;
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                position = head.load(std::memory_order_relaxed);
+        }
+    }
+    /**
+     * @brief Pop the oldest published value.
+     * @param value Where to write the popped value.
+     * @return @b True if a value was popped. @b False if the buffer was empty.
+     * @warning Must only be called from a single thread at a time.
+     */
+    bool Pop(T &value)
+    {
+        Slot &slot = slots[tail & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+            return false;
+        value = slot.value;
+        slot.sequence.store(tail + CAPACITY, std::memory_order_release);
+        tail++;
+        return true;
+    }
+};
+
+#endif // RING_BUFFER_H
@@ -4,6 +4,20 @@
 #include "globals.hxx"
 #include "UI.hpp"
 #include "gameObject.hxx"
+#include "slotMap.hxx"
+#include "objectPool.hxx"
+#include "resourceManager.hxx"
+#include "spatialHash.hxx"
+#include "transformStore.hxx"
+#include "objectGroup.hxx"
+#include "renderLayer.hxx"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <typeindex>
+
+class AnimatedTexture;
 
 /**
  * @file scene.hxx
@@ -11,6 +25,11 @@
  * @details
  * This file defines the `Scene` class, which acts as a container for `GameObject` and `UIContainer` objects that should be displayed in the same location.
  * It also defines the `SceneManager` class, which is responsible for managing and switching between scenes.
+ *
+ * Scenes can be switched instantly with `SceneManager::LoadScene()`, or through a timed transition with `SceneManager::TransitionTo()`,
+ * during which the outgoing and incoming scenes are both rendered into textures and composited. Removed scenes are not destroyed on the
+ * spot: their objects are destroyed on the main thread over the following frames, within a time budget, and the memory left behind is
+ * released on a background thread.
  */
 
  
@@ -20,15 +39,177 @@
  * @note Once given a pointer to a `GameObject` or `UIContainer`, this class becomes owner of said object and will liberate their memory on it's own.
  */
 class Scene {
+public:
+    /**
+     * @brief Stable identifier of a `GameObject` stored in a `Scene`.
+     */
+    using ObjectHandle = SlotHandle;
 private:
     /**
      * @brief Map containing all the `UIContainer` objects stored in the scene.
      */
     std::map<std::string, UIContainer*> interfaces;
     /**
-     * @brief Map containing all `GameObject` objects stored in the scene.
+     * @brief Entries of `interfaces` by the `StringId` of their identifier.
      */
-    std::map<std::string, GameObject*>  objects;
+    FlatMap<StringId, std::map<std::string, UIContainer*>::iterator> interface_ids;
+    /**
+     * @brief Type-segregated pools backing the objects created through `Emplace()`. Released all at once on destruction.
+     */
+    PoolRegistry<GameObject>            object_pools;
+    /**
+     * @brief Dense storage of all `GameObject` objects stored in the scene. Iterated linearly by `Update()` and `Draw()`.
+     */
+    SlotMap<OwnedPtr<GameObject>>       objects;
+    /**
+     * @brief Side index from `std::string` identifiers to `objects` handles. Only used by the identifier based methods.
+     */
+    HandleIndex                         object_ids;
+    /**
+     * @brief Stored `UIContainer` objects sorted by draw order. Rebuilt on the next `Draw()` after a container is added, removed or reordered.
+     */
+    mutable RenderQueue<UIContainer> ui_queue;
+    /**
+     * @brief Texture files to load when the scene is preloaded, relative to `TEXTURES_PATH`.
+     */
+    std::vector<std::string>      preload_paths;
+    /**
+     * @brief Animations to initialize when the scene is preloaded. Not owned by the scene.
+     */
+    std::vector<AnimatedTexture*> preload_animations;
+    /**
+     * @brief Handles keeping the preloaded textures alive for as long as the scene exists.
+     */
+    std::vector<TextureHandle>    preloaded;
+    /**
+     * @brief Whether `Preload()` was called already, so registered assets are only requested once.
+     */
+    bool                          preload_started;
+    /**
+     * @brief Whether thread-safe objects are updated on `job_system`'s workers.
+     */
+    bool   parallel_update;
+    /**
+     * @brief Number of objects updated by a single job when `parallel_update` is enabled.
+     */
+    size_t parallel_chunk_size;
+    /**
+     * @brief Scratch list of the thread-safe objects, rebuilt on every parallel `Update()`.
+     */
+    std::vector<GameObject*> parallel_objects;
+    /**
+     * @brief Spatial index of all objects, by their `GameObject::GetBounds()`. Refreshed after every `Update()`.
+     */
+    SpatialHash spatial_index;
+    /**
+     * @brief Objects that had bounds when last indexed. Only these are polled by `RefreshSpatialIndex()`.
+     */
+    std::vector<ObjectHandle> bounded_objects;
+    /**
+     * @brief Position of every object in `bounded_objects`, by slot index, or `SlotHandle::INVALID_INDEX` if it is not in it.
+     */
+    std::vector<uint32_t>     bounded_positions;
+    /**
+     * @brief Dense indices of the objects without bounds, sorted. Rebuilt by the next culled `Draw()` once `unbounded_dirty` is set.
+     */
+    mutable std::vector<size_t> unbounded_order;
+    /**
+     * @brief Whether `unbounded_order` is out of date, because objects gained or lost their bounds.
+     */
+    mutable bool                unbounded_dirty;
+    /**
+     * @brief Whether `Draw()` skips objects whose bounds are outside of the camera's view.
+     */
+    bool culling;
+    /**
+     * @brief Scratch list of the dense indices of the objects to draw, rebuilt on every culled `Draw()`.
+     */
+    mutable std::vector<size_t> visible_objects;
+    /**
+     * @brief Transforms of the objects opting in to batched transform updates. Updated after all objects, before `spatial_index`.
+     */
+    TransformStore transforms;
+    /**
+     * @brief Entry of `transforms` giving the bounds of every object, by slot index, or an invalid handle. See `BindTransform()`.
+     */
+    std::vector<TransformStore::Handle> object_transforms;
+    /**
+     * @brief Groups of objects stored by value, one per type, created through `Group()`.
+     */
+    std::unordered_map<std::type_index, std::unique_ptr<ObjectGroupBase>> groups;
+    /**
+     * @brief Stored groups sorted by draw order. Rebuilt on the next `Draw()` after a group is added or reordered.
+     */
+    mutable RenderQueue<ObjectGroupBase> group_queue;
+
+    /**
+     * @brief A `RenderLayer` along with the render texture caching it.
+     */
+    struct Layer {
+        RenderLayer             settings;
+        mutable RenderTexture2D target;       // Render texture of a cached layer, or none yet.
+        mutable Camera2D        drawn_camera; // Camera `target` was last drawn through.
+        mutable double          drawn_at;     // Simulation time `target` was last drawn at.
+        mutable bool            dirty;        // Whether `target` is out of date.
+    };
+    /**
+     * @brief Render layers, in drawing order. If empty, the scene is drawn once through the global `camera`.
+     */
+    std::vector<Layer>    layers;
+    /**
+     * @brief Object layers of every object, by slot index. See `SetObjectLayers()`.
+     */
+    std::vector<uint32_t> object_layers;
+    /**
+     * @brief Object layers of the objects added, removed or moved since the last `Render()`.
+     */
+    mutable uint32_t      changed_layers;
+    /**
+     * @brief Whether groups were updated since the last `Render()`.
+     */
+    mutable bool          groups_changed;
+    /**
+     * @brief Color the screen is cleared to before drawing the scene.
+     */
+    Color                 clear_color;
+
+    /**
+     * @brief Give a newly inserted object the default object layer, and index it.
+     */
+    void TrackObject(ObjectHandle handle);
+    /**
+     * @brief Insert or move an object in `spatial_index`, flagging it's layers as changed if it's bounds did.
+     */
+    void IndexObject(ObjectHandle handle, const GameObject &object);
+    /**
+     * @brief Index an object with @p bounds, or without bounds if @b nullptr, keeping `bounded_objects` and `unbounded_order` in sync.
+     */
+    void IndexBounds(ObjectHandle handle, const Rectangle *bounds);
+    /**
+     * @brief Draw the groups and the objects matching @p mask through @p view_camera, culled to the area it shows of @p view.
+     * @param view Rectangle of the current target covered by the view, in pixels.
+     */
+    void DrawWorld(const Camera2D &view_camera, Rectangle view, uint32_t mask, bool draw_groups) const;
+    /**
+     * @brief Draw a layer to it's viewport, redrawing it's render texture first if it is cached and out of date.
+     */
+    void DrawLayer(const Layer &layer) const;
+    /**
+     * @brief Unload the render textures of all layers, and remove them.
+     */
+    void ReleaseLayers();
+    /**
+     * @brief Destroy the scene's containers, groups, preloaded textures and objects, for at most @p budget_ms milliseconds.
+     * @return @b True once everything was destroyed, and only memory is left to release by deleting the scene.
+     * @note Resumes where the previous call stopped. Must run on the main thread, since destructors may release GPU resources.
+     */
+    bool Teardown(double budget_ms);
+    /**
+     * @brief Add the scene's counts and heap bytes to @p stats, and it's textures to @p textures, containers included.
+     */
+    void AccumulateMemory(MemoryStats &stats, TextureSet &textures) const;
+    friend class SceneFile;
+    friend class SceneManager;
 public:
     /**
      * @brief Default constructor. Creates a completely empty scene.
@@ -39,6 +220,7 @@ public:
      * @warning The `Scene` object is owner of all pointers given to it to facilitate centralized memory cleanups. This means the user is not
      * required to call the @b delete function on all of the `Scene` object's elements as the parent object will take care of it upon it's
      * destruction.
+     * @note Objects created through `Emplace()` are destroyed in place, and their pools are released in one go afterwards.
      */
     ~Scene();
     
@@ -55,19 +237,66 @@ public:
      * @warning This will also free the memory occupied by the object with identifier `id`! Plan accordingly!
      */
     void RemoveUI(const     std::string &id);
+    /**
+     * @brief Remove a `UIContainer` element given the `StringId` of it's identifier.
+     * @warning This will also free the memory occupied by the object! Plan accordingly!
+     */
+    void RemoveUI(StringId id);
     /**
      * @brief Add a new `GameObject` to the scene.
      * @param id Text associated with the inserted `_object`. This std::string will be the identifier of `_object`.
-     * @param _ui The GameObject to add to the `Scene`.
+     * @param _object The GameObject to add to the `Scene`.
+     * @return A handle to the stored object, or an invalid handle if @p id was already in use.
+     * @note Ownership of `_object` will be given to the `Scene` object for more centralized memory management.
+     * @warning If @p id was already in use, @p _object is @b not stored and ownership stays with the caller.
+     */
+    ObjectHandle AddObject(const std::string &id, GameObject *_object);
+    /**
+     * @brief Add a new `GameObject` to the scene without a `std::string` identifier.
+     * @param _object The GameObject to add to the `Scene`.
+     * @return A handle to the stored object. This is the only way of accessing it later on.
      * @note Ownership of `_object` will be given to the `Scene` object for more centralized memory management.
      */
-    void AddObject(const    std::string &id, GameObject *_object);
+    ObjectHandle AddObject(GameObject *_object);
+    /**
+     * @brief Construct a new `GameObject` of type @p T directly inside the scene's pool for said type.
+     * @tparam T Type of the object to create. Must derive from `GameObject`.
+     * @param id Identifier of the new object. If empty, the object is stored without a `std::string` identifier.
+     * @param args Arguments forwarded to the constructor of @p T.
+     * @return A handle to the new object, or an invalid handle if @p id was already in use.
+     * @note Creating and removing pooled objects does not go through the global allocator, which makes it suitable for objects
+     * that are spawned and despawned every frame (e.g. bullets or particles).
+     */
+    template <typename T, typename... Args>
+    ObjectHandle Emplace(const std::string &id, Args&&... args);
+    /**
+     * @brief Get the scene's group of objects of type @p T, creating it if needed.
+     * @tparam T Type of the grouped objects. Must provide `void Update()` and `void Draw() const`.
+     * @return A reference to the group, which lives as long as the scene.
+     * @note Grouped objects are stored by value and updated and drawn without virtual calls, which suits types with thousands of
+     * instances (e.g. bullets or particles). Groups are updated after all `GameObject` objects, and drawn before them if their draw
+     * order is negative, after them otherwise.
+     */
+    template <typename T>
+    ObjectGroup<T> &Group();
     /**
      * @brief Remove a `GameObject` element given it's identifier.
      * @param id Identifier of the element to remove.
      * @warning This will also free the memory occupied by the object with identifier `id`! Plan accordingly!
      */
     void RemoveObject(const std::string &id);
+    /**
+     * @brief Remove a `GameObject` element given the `StringId` of it's identifier.
+     * @warning This will also free the memory occupied by the object! Plan accordingly!
+     */
+    void RemoveObject(StringId id);
+    /**
+     * @brief Remove a `GameObject` element given it's handle.
+     * @param handle Handle of the element to remove.
+     * @warning This will also free the memory occupied by the object referred to by `handle`! Plan accordingly!
+     * @note The remaining objects keep their drawing order, so this is linear in the number of objects.
+     */
+    void RemoveObject(ObjectHandle handle);
 
     /**
      * @brief Get a reference to the `GameObject` with identifier `id`.
@@ -81,6 +310,41 @@ public:
      * @return A @b constant reference to the `GameObject` stored with the identifier `id`.
      */
     const GameObject  &GetObject(const std::string &id) const;
+    /**
+     * @brief Get a reference to the `GameObject` whose identifier hashes to @p id, without allocating nor comparing strings.
+     * @param id `StringId` of the desired object's identifier, e.g. `"player"_sid`.
+     * @return A @b non-constant reference to said `GameObject`.
+     */
+    GameObject        &GetObject(StringId id);
+    /**
+     * @brief Get a @b constant reference to the `GameObject` whose identifier hashes to @p id.
+     * @param id `StringId` of the desired object's identifier.
+     * @return A @b constant reference to said `GameObject`.
+     */
+    const GameObject  &GetObject(StringId id) const;
+    /**
+     * @brief Get a reference to the `GameObject` referred to by `handle`.
+     * @param handle Desired object's handle.
+     * @return A @b non-constant reference to the `GameObject` referred to by `handle`.
+     */
+    GameObject        &GetObject(ObjectHandle handle);
+    /**
+     * @brief Get a @b constant reference to the `GameObject` referred to by `handle`.
+     * @param handle Desired object's handle.
+     * @return A @b constant reference to the `GameObject` referred to by `handle`.
+     */
+    const GameObject  &GetObject(ObjectHandle handle) const;
+    /**
+     * @brief Get the handle of the `GameObject` with identifier `id`.
+     * @param id Desired object's identifier.
+     * @return The handle of said object, or an invalid handle if there is no object with identifier `id`.
+     */
+    ObjectHandle       GetObjectHandle(const std::string &id) const;
+    /**
+     * @brief Get the handle of the `GameObject` whose identifier hashes to @p id.
+     * @return The handle of said object, or an invalid handle if there is none.
+     */
+    ObjectHandle       GetObjectHandle(StringId id) const;
     /**
      * @brief Get a reference to the `UIContainer` with identifier `id`.
      * @param id Desired object's identifier.
@@ -93,18 +357,233 @@ public:
      * @return A @b constant reference to the `UIContainer` stored with the identifier `id`.
      */
     const UIContainer &GetUI(const     std::string &id) const;
+    /**
+     * @brief Get a reference to the `UIContainer` whose identifier hashes to @p id, without allocating nor comparing strings.
+     * @param id `StringId` of the desired container's identifier, e.g. `"hud"_sid`.
+     * @return A @b non-constant reference to said `UIContainer`.
+     */
+    UIContainer       &GetUI(StringId id);
+    /**
+     * @brief Get a @b constant reference to the `UIContainer` whose identifier hashes to @p id.
+     * @param id `StringId` of the desired container's identifier.
+     * @return A @b constant reference to said `UIContainer`.
+     */
+    const UIContainer &GetUI(StringId id) const;
+
+    /**
+     * @brief Register a texture file to be loaded in the background by `Preload()`.
+     * @param texture_path Path of the texture file, relative to `TEXTURES_PATH`.
+     */
+    void  RegisterPreload(const std::string &texture_path);
+    /**
+     * @brief Register an `AnimatedTexture` to be initialized in the background by `Preload()`.
+     * @param animation The animation to initialize. Ownership is @b not passed to the scene, and it must outlive the preload.
+     */
+    void  RegisterPreload(AnimatedTexture *animation);
+    /**
+     * @brief Start loading all registered assets in the background. Calling it again has no effect.
+     * @note Decoded assets are uploaded to the GPU by `SceneManager::Update()`, within the manager's upload budget.
+     */
+    void  Preload();
+    /**
+     * @brief Check how much of the registered assets finished loading.
+     * @return A value in the [0, 1] range. @b 1 if there is nothing to preload.
+     */
+    float GetPreloadProgress() const;
 
     /**
      * @brief Draw all of the `Scene` object's elements following their `draw_order`.
+     * @note Objects with bounds outside of the camera's view are skipped, see `SetCulling()`.
      * @note All objects of type `UIContainer` are @b always drawn after all `GameObject` objects.
+     * @note Without render layers, objects are drawn through the global `camera`. Otherwise each layer draws it's own objects, see `AddLayer()`.
      */
     void Draw() const;
+    /**
+     * @brief Draw all of the `Scene` object's elements to the current target, without beginning nor ending a frame.
+     * @note Used by `Draw()`, and by `SceneManager` to render scenes into textures during a transition.
+     */
+    void Render() const;
+    /**
+     * @brief Find every object overlapping a rectangle.
+     * @param area World space rectangle to search.
+     * @param result Vector the handles of the found objects are appended to, in no particular order.
+     * @note Objects without bounds are found if their position lies within @p area.
+     */
+    void QueryRect(Rectangle area, std::vector<ObjectHandle> &result) const;
+    /**
+     * @brief Find every object overlapping a circle.
+     * @param center World space center of the circle.
+     * @param radius Radius of the circle.
+     * @param result Vector the handles of the found objects are appended to, in no particular order.
+     * @note Objects without bounds are found if their position lies within the circle.
+     */
+    void QueryRadius(Vector2 center, float radius, std::vector<ObjectHandle> &result) const;
+    /**
+     * @brief Update the spatial index with the current bounds of every object that has bounds.
+     * @note Done automatically at the end of `Update()`. Only needed when objects are moved from outside of their `Update()`, and have to
+     * be found by a query or culled correctly before the next `Update()`.
+     * @note Objects without bounds when they were added or last reindexed are not polled, see `ReindexObject()`.
+     */
+    void RefreshSpatialIndex();
+    /**
+     * @brief Poll the bounds of a single object again.
+     * @note Needed when an object that had no bounds (i.e. whose `GameObject::GetBounds()` returned @b false) gains some, since such
+     * objects are not polled by `RefreshSpatialIndex()`.
+     */
+    void ReindexObject(ObjectHandle handle);
+    /**
+     * @brief Enable or disable camera culling. Enabled by default.
+     * @note Only affects objects that override `GameObject::GetBounds()`. Objects are still drawn in the same order.
+     */
+    void SetCulling(bool enabled);
+    /**
+     * @brief Check whether camera culling is enabled.
+     */
+    bool IsCulling() const;
+
+    /**
+     * @brief Add a render layer, drawn after the ones already added.
+     * @return The index of the layer, used to access it later on.
+     * @note Once a scene has layers, the global `camera` is no longer used to draw it. See `RenderLayer` for how cached layers are refreshed.
+     */
+    size_t AddLayer(const RenderLayer &layer);
+    /**
+     * @brief Get a reference to the render layer at @p index, e.g. to move it's camera.
+     * @return A @b non-constant reference to the layer.
+     * @note Cached layers are redrawn after they are accessed through this method, since their settings may have changed.
+     * Moving their camera alone is detected, so parallax layers may keep the reference instead.
+     */
+    RenderLayer       &GetLayer(size_t index);
+    /**
+     * @brief Get a @b constant reference to the render layer at @p index.
+     */
+    const RenderLayer &GetLayer(size_t index) const;
+    /**
+     * @brief Get the number of render layers.
+     */
+    size_t GetLayerCount() const;
+    /**
+     * @brief Redraw a cached layer on the next `Draw()`, e.g. after one of it's objects changed it's look without moving.
+     * @note The layer's `refresh_interval` still applies.
+     */
+    void   InvalidateLayer(size_t index);
+    /**
+     * @brief Remove all render layers, going back to drawing the scene once through the global `camera`.
+     */
+    void   ClearLayers();
+    /**
+     * @brief Set the object layers an object belongs to, as a bit mask matched against `RenderLayer::mask`.
+     * @note Objects are in layer 1 (the lowest bit) when added. Objects in no layer are only drawn by scenes without render layers.
+     */
+    void     SetObjectLayers(ObjectHandle handle, uint32_t layers_mask);
+    /**
+     * @brief Get the object layers an object belongs to.
+     * @return Said bit mask, or zero if @p handle does not refer to an object of the scene.
+     */
+    uint32_t GetObjectLayers(ObjectHandle handle) const;
+    /**
+     * @brief Set the color the screen is cleared to before drawing the scene. Black by default.
+     */
+    void  SetClearColor(Color color);
+    /**
+     * @brief Get the color the screen is cleared to before drawing the scene.
+     */
+    Color GetClearColor() const;
+
+    /**
+     * @brief Enable or disable parallel updates.
+     * @param enabled If @b true, `Update()` runs the objects whose `GameObject::IsThreadSafe()` returns @b true on `job_system`'s worker
+     * threads, and then every other object and all `UIContainer` objects on the calling thread.
+     * @param chunk_size Number of consecutive objects updated by a single job.
+     * @note Disabled by default. Objects updated in parallel run in no particular order.
+     */
+    void SetParallelUpdate(bool enabled, size_t chunk_size = 64);
+    /**
+     * @brief Check whether parallel updates are enabled.
+     */
+    bool IsParallelUpdate() const;
+
+    /**
+     * @brief Get the scene's transform store.
+     * @return A @b non-constant reference to the store.
+     * @note Objects may keep a `TransformStore::Handle` to an entry instead of using their own `transform`. World transforms and bounds of
+     * all entries are computed in one batch by `Update()`, after every object was updated, and feed the spatial index of the objects
+     * bound to them with `BindTransform()`.
+     */
+    TransformStore       &GetTransforms();
+    /**
+     * @brief Get a @b constant reference to the scene's transform store.
+     */
+    const TransformStore &GetTransforms() const;
+    /**
+     * @brief Index an object by the bounds of an entry of the scene's transform store, instead of it's `GameObject::GetBounds()`.
+     * @param handle Object to bind.
+     * @param entry Entry of `GetTransforms()` whose bounds the object draws into, or an invalid handle to go back to `GetBounds()`.
+     * @note Bound objects are refreshed in the spatial index without a virtual call. The entry is @b not removed along with the object,
+     * and objects whose entry was removed go back to `GetBounds()`.
+     */
+    void BindTransform(ObjectHandle handle, TransformStore::Handle entry);
+    /**
+     * @brief Get the transform store entry an object is bound to.
+     * @return Said entry, or an invalid handle if the object is not bound or does not exist.
+     */
+    TransformStore::Handle GetBoundTransform(ObjectHandle handle) const;
+
+    /**
+     * @brief Get the number of objects and the memory held by the scene, it's groups and it's `UIContainer` objects.
+     * @note Textures are counted once however many objects use them: the preloaded ones, and the ones objects report through
+     * `GameObject::CollectTextures()`. Iterates over every object, so it is meant for tools and budget checks, not for every frame.
+     */
+    MemoryStats GetMemoryStats() const;
+
     /**
      * @brief Updates all of the `Scene` object's elements.
+     * @note `UIContainer` objects are updated from the highest draw order to the lowest, so pointer input goes to the topmost one.
+     * @note The transform store is updated right after all objects, see `GetTransforms()`.
      */
     void Update();
 };
 
+template <typename T, typename... Args>
+Scene::ObjectHandle Scene::Emplace(const std::string &id, Args&&... args)
+{
+    static_assert(std::is_base_of<GameObject, T>::value, "Scene::Emplace() requires a type derived from GameObject");
+    if (!id.empty() && object_ids.Find(StringId(id)).IsValid())
+        return ObjectHandle{};
+
+    ObjectPool<T, GameObject> &pool = object_pools.Get<T>();
+    ObjectHandle handle = objects.Insert(OwnedPtr<GameObject>{pool.Create(std::forward<Args>(args)...), &pool});
+    TrackObject(handle);
+    if (!id.empty())
+        object_ids.Bind(id, handle);
+    return handle;
+}
+
+template <typename T>
+ObjectGroup<T> &Scene::Group()
+{
+    auto &group = groups[std::type_index(typeid(T))];
+    if (!group)
+    {
+        group.reset(new ObjectGroup<T>());
+        group->owner_queue = &group_queue;
+        group_queue.Invalidate();
+    }
+    return static_cast<ObjectGroup<T>&>(*group);
+}
+
+/**
+ * @brief Ways `SceneManager::TransitionTo()` can switch from a scene to another.
+ */
+enum class TransitionType {
+    CUT,         ///< Switch instantly, like `SceneManager::LoadScene()`.
+    FADE,        ///< Cross-fade from the outgoing scene to the incoming one.
+    SLIDE_LEFT,  ///< The incoming scene slides in from the right, pushing the outgoing one out to the left.
+    SLIDE_RIGHT, ///< The incoming scene slides in from the left, pushing the outgoing one out to the right.
+    SLIDE_UP,    ///< The incoming scene slides in from the bottom, pushing the outgoing one out to the top.
+    SLIDE_DOWN   ///< The incoming scene slides in from the top, pushing the outgoing one out to the bottom.
+};
+
 /**
  * @brief ## SceneManager class
  * @brief A container for all `Scene` objects. Allows for the display of @b only @b one `Scene` object at a time.
@@ -116,10 +595,88 @@ private:
      * @brief All `Scene` objects are stored here.
      */
     std::map<std::string, Scene*> scenes;
+    /**
+     * @brief Entries of `scenes` by the `StringId` of their identifier.
+     */
+    FlatMap<StringId, std::map<std::string, Scene*>::iterator> scene_ids;
     /**
      * @brief A pointer to the currently active `Scene` object.
      */
     Scene       *activeScene;
+    /**
+     * @brief Time `Update()` may spend uploading preloaded assets to the GPU, in milliseconds.
+     */
+    double       upload_budget_ms;
+    /**
+     * @brief Duration of a simulation step run by `Tick()`, in seconds.
+     */
+    double       fixed_step;
+    /**
+     * @brief Time passed to `Tick()` not yet consumed by simulation steps, in seconds.
+     */
+    double       accumulator;
+    /**
+     * @brief Maximum number of simulation steps run by a single `Tick()`. Extra time is dropped, so a slow frame cannot snowball.
+     */
+    int          max_steps_per_tick;
+    /**
+     * @brief Scene being transitioned from, or @b nullptr outside of transitions. Drawn, but not updated.
+     */
+    Scene         *outgoing;
+    /**
+     * @brief Type of the current transition.
+     */
+    TransitionType transition_type;
+    /**
+     * @brief Duration of the current transition, in seconds.
+     */
+    double         transition_duration;
+    /**
+     * @brief Simulation time elapsed since the current transition started, in seconds.
+     */
+    double         transition_elapsed;
+    /**
+     * @brief Whether `outgoing` was already rendered into `outgoing_target`. It is frozen, so it's rendered once per transition.
+     */
+    mutable bool   outgoing_captured;
+    /**
+     * @brief Render textures the outgoing and incoming scenes are rendered into during transitions. Kept between transitions.
+     */
+    mutable RenderTexture2D outgoing_target, incoming_target;
+    /**
+     * @brief Removed scenes waiting to be torn down by `ProcessTeardown()`, oldest first.
+     */
+    std::vector<Scene*> retired;
+    /**
+     * @brief Time `ProcessTeardown()` may spend destroying the objects of removed scenes, in milliseconds.
+     */
+    double              teardown_budget_ms;
+    std::thread             reaper;          // Thread deleting torn down scenes. Started on the first one.
+    std::mutex              reaper_mutex;    // Protects `reaper_queue` and `reaper_stopping`.
+    std::condition_variable reaper_wake;     // Signals `reaper` when a scene is queued or the manager is destroyed.
+    std::vector<Scene*>     reaper_queue;    // Torn down scenes waiting to be deleted.
+    bool                    reaper_stopping; // Whether `reaper` should exit once `reaper_queue` is empty.
+
+    /**
+     * @brief Advance `frame_clock` by @p dt, update the active scene and the current transition.
+     */
+    void Step(double dt);
+    /**
+     * @brief Tear down removed scenes within `teardown_budget_ms`, and hand the finished ones to `reaper`.
+     */
+    void ProcessTeardown();
+    /**
+     * @brief Body of `reaper`.
+     */
+    void Reap();
+    /**
+     * @brief Draw the current transition to the screen, between `BeginDrawing()` and `EndDrawing()`.
+     */
+    void DrawTransition() const;
+    /**
+     * @brief Find the `Scene` object whose identifier hashes to @p scene_id, throwing if there is none.
+     */
+    Scene &FindScene(StringId scene_id) const;
 public:
     /**
      * @brief Default constructor. Creates an empty `Scene` object and stores it with the identifier @b "scene_default". It then sets
@@ -127,7 +684,7 @@ public:
      */
     SceneManager();
     /**
-     * @brief Destructor. Automatically deletes all `Scene` objects stored in the container.
+     * @brief Destructor. Automatically deletes all `Scene` objects stored in the container, including removed ones not yet torn down.
      * @warning The `SceneManager` becomes the owner of all the `Scene` objects stored in it, and will therefore clean the memory by itself.
      */
     ~SceneManager();
@@ -144,13 +701,92 @@ public:
      * @brief Remove a `Scene` object given it's `scene_id`.
      * @param scene_id Identifier of the `Scene` object to remove.
      * @warning Once removed from the `SceneManager` the object is also deleted! Plan accordingly!
+     * @note Deletion is deferred: the scene's objects are destroyed over the next frames, see `SetTeardownBudget()`. A scene being
+     * transitioned from is only torn down once the transition ends. The active scene can't be removed.
      */
     void   RemoveScene(const std::string &scene_id);
+    /**
+     * @brief Remove a `Scene` object given the `StringId` of it's identifier. See `RemoveScene(const std::string&)`.
+     */
+    void   RemoveScene(StringId scene_id);
     /**
      * @brief Set a `Scene` object given by `scene_id` to be loaded and drawn/updated.
      * @param scene_id Desired `Scene` object's identifier.
      */
     void   LoadScene(const   std::string &scene_id);
+    /**
+     * @brief Set the `Scene` object whose identifier hashes to @p scene_id to be loaded and drawn/updated.
+     * @param scene_id `StringId` of the desired `Scene` object's identifier, e.g. `"level_1"_sid`.
+     */
+    void   LoadScene(StringId scene_id);
+    /**
+     * @brief Switch to a `Scene` object through a timed transition.
+     * @param scene_id Desired `Scene` object's identifier.
+     * @param type How the outgoing scene is replaced, see `TransitionType`.
+     * @param duration Duration of the transition, in seconds of simulation time.
+     * @note The incoming scene becomes the active scene right away, and is updated during the transition. The outgoing scene is frozen
+     * on it's last frame. Starting a transition during another one transitions from the current active scene.
+     */
+    void   TransitionTo(const std::string &scene_id, TransitionType type = TransitionType::FADE, double duration = 0.5);
+    /**
+     * @brief Switch to the `Scene` object whose identifier hashes to @p scene_id through a timed transition.
+     */
+    void   TransitionTo(StringId scene_id, TransitionType type = TransitionType::FADE, double duration = 0.5);
+    /**
+     * @brief Check whether a transition started by `TransitionTo()` is running.
+     */
+    bool   IsTransitioning() const;
+    /**
+     * @brief Set the time `Update()` may spend destroying the objects of removed scenes every frame.
+     * @param budget_ms The new budget, in milliseconds.
+     */
+    void   SetTeardownBudget(double budget_ms);
+    /**
+     * @brief Start loading the assets of a `Scene` object in the background, so it can be loaded without stalls.
+     * @param scene_id Desired `Scene` object's identifier.
+     * @note Use `GetPreloadProgress()` to know when the scene is ready, e.g. to display a loading screen meanwhile.
+     */
+    void   PreloadScene(const std::string &scene_id);
+    /**
+     * @brief Start loading the assets of the `Scene` object whose identifier hashes to @p scene_id in the background.
+     */
+    void   PreloadScene(StringId scene_id);
+    /**
+     * @brief Check how much of a `Scene` object's assets finished loading.
+     * @param scene_id Desired `Scene` object's identifier.
+     * @return A value in the [0, 1] range.
+     */
+    float  GetPreloadProgress(const std::string &scene_id) const;
+    /**
+     * @brief Check how much of the assets of the `Scene` object whose identifier hashes to @p scene_id finished loading.
+     */
+    float  GetPreloadProgress(StringId scene_id) const;
+    /**
+     * @brief Get the number of objects and the memory held by a `Scene` object, see `Scene::GetMemoryStats()`.
+     * @param scene_id Desired `Scene` object's identifier.
+     */
+    MemoryStats GetMemoryStats(const std::string &scene_id) const;
+    /**
+     * @brief Get the number of objects and the memory held by the `Scene` object whose identifier hashes to @p scene_id.
+     */
+    MemoryStats GetMemoryStats(StringId scene_id) const;
+    /**
+     * @brief Get the number of objects and the memory held by all `Scene` objects, including removed ones not yet deleted.
+     * @note Textures shared by several scenes are counted once. The render textures used by transitions are included.
+     */
+    MemoryStats GetMemoryStats() const;
+    /**
+     * @brief Write the memory held by every `Scene` object, the total, and every texture cached by `resources` to a text file.
+     * @param path Path of the file to write.
+     * @return @b True if the file was written. @b False otherwise.
+     * @note Also lists the `GameObject` objects allocated with @b new that no scene holds, which are either owned elsewhere or leaked.
+     */
+    bool        DumpMemoryStats(const std::filesystem::path &path) const;
+    /**
+     * @brief Set the time `Update()` may spend uploading preloaded assets to the GPU every frame.
+     * @param budget_ms The new budget, in milliseconds.
+     */
+    void   SetUploadBudget(double budget_ms);
     /**
      * @brief Get a reference to the currently active `Scene` object.
      * @return a @b non-constant reference to the currently active `Scene` object.
@@ -163,12 +799,40 @@ public:
     const Scene& GetActiveScene() const;
 
     /**
-     * @brief Calls the `Draw()` method of the currently active `Scene` object.
+     * @brief Set the rate at which `Tick()` runs simulation steps.
+     * @param steps_per_second Number of steps per second of simulation time. Defaults to 60.
+     * @param max_steps Maximum number of steps a single `Tick()` may run.
+     * @note Rates that are not strictly positive are rejected with a warning, and the current rate is kept.
      */
-    void Draw() const;
+    void   SetFixedRate(double steps_per_second, int max_steps = 8);
+    /**
+     * @brief Get the duration of a simulation step, in seconds.
+     */
+    double GetFixedStep() const;
+
+    /**
+     * @brief Calls the `Draw()` method of the currently active `Scene` object, or draws the current transition.
+     * @param alpha Interpolation factor between the last two simulation steps, made available through `frame_clock.GetAlpha()`.
+     * @note Also ends the current `profiler` frame, see `Profiler::EndFrame()`.
+     */
+    void Draw(float alpha = 1.0f) const;
     /**
-     * @brief Calls the `Update()` method of the currently active `Scene` object.
+     * @brief Uploads pending preloaded assets within the upload budget, tears down removed scenes within the teardown budget, then calls
+     * the `Update()` method of the currently active `Scene` object.
+     * @note Advances `frame_clock` by the duration of the last frame, and samples `input_router` once. Use `Tick()` instead for fixed
+     * simulation steps.
      */
     void Update();
+    /**
+     * @brief Run one frame: upload pending assets, run as many fixed simulation steps as fit in the accumulated time, then draw.
+     * @param dt Real time elapsed since the previous `Tick()`, in seconds.
+     * @note The time left over after the last step is passed to `Draw()` as the interpolation factor.
+     */
+    void Tick(double dt);
+    /**
+     * @brief Call `Tick()` with the last frame's duration until the window is closed.
+     * @note Function must be called after window initialization.
+     */
+    void Run();
 };
 #endif
\ No newline at end of file
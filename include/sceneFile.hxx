@@ -0,0 +1,224 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include "scene.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+/**
+ * @file sceneFile.hxx
+ * @brief This file contains the `SceneFile` class, the `SceneTypeRegistry` class and the scene record structs.
+ * @details
+ * Scene files are a compact binary snapshot of a `Scene`: it's objects, it's `UIContainer` objects and their elements, and the textures
+ * registered for preloading. Every object is stored as a fixed size record holding the name of it's type, it's identifier, it's transform,
+ * it's draw order, the path of the resource it uses, and an optional payload of type specific bytes.
+ *
+ * Files are memory mapped and read in place: the header is validated, every type name is resolved once to a factory, and the records
+ * are then passed straight to said factories, which emplace the objects into the scene's dense storage.
+ *
+ * Types opt in to saving by overriding `GameObject::Save()`, and to loading by being registered in `scene_types`. `UI::Button`,
+ * `UI::Panel` and `UI::ImageDisplay` are registered out of the box.
+ *
+ * ## Layout
+ * All values are little endian, and every section starts at a multiple of 4 bytes:
+ * - `SceneFile::Header`.
+ * - Type names, one 32 bit string offset per type.
+ * - Preloaded texture paths, one 32 bit string offset per path.
+ * - Object records (`SceneFile::ObjectRecord`).
+ * - Container records (`SceneFile::ContainerRecord`). Each container owns the next `element_count` element records.
+ * - Element records (`SceneFile::ObjectRecord`), in container order.
+ * - String table, made of NUL terminated strings. Offsets are relative to it's start, `SceneFile::NO_STRING` meaning no string.
+ * - Payload bytes, referred to by the records.
+ */
+
+
+/**
+ * @brief ## Scene record struct
+ * @brief Description of a `GameObject` to be saved, filled by `GameObject::Save()`.
+ */
+struct SceneRecord {
+    std::string          type;       ///< Name the type is registered under in `scene_types`.
+    std::string          resource;   ///< Path of the resource the object uses, if any. Passed back to the factory on load.
+    Transform2D          transform;  ///< Transform of the object. Filled in before `GameObject::Save()` is called.
+    int                  draw_order; ///< Draw order of the object. Filled in for `UIElement` objects, zero otherwise.
+    std::vector<uint8_t> payload;    ///< Type specific bytes.
+
+    /**
+     * @brief Append the bytes of @p value to `payload`.
+     * @tparam T A trivially copyable type.
+     */
+    template <typename T>
+    void Write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SceneRecord::Write() requires a trivially copyable type");
+        const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&value);
+        payload.insert(payload.end(), bytes, bytes + sizeof(T));
+    }
+};
+
+/**
+ * @brief ## Scene record view struct
+ * @brief A record read from a scene file, passed to the factories of `scene_types`.
+ * @note The strings and the payload point into the mapped file, and are only valid during the factory call.
+ */
+struct SceneRecordView {
+    const char    *id;           ///< Identifier of the object, or an empty string if it has none.
+    const char    *resource;     ///< Path of the resource the object uses, or an empty string.
+    Transform2D    transform;    ///< Transform of the object. Applied by the loader after the factory returns.
+    int            draw_order;   ///< Draw order of the object. Applied by the loader to `UIElement` objects.
+    const uint8_t *payload;      ///< Type specific bytes.
+    size_t         payload_size; ///< Number of type specific bytes.
+    mutable size_t cursor;       ///< Read position of `Read()` in `payload`.
+
+    /**
+     * @brief Read the next value from `payload`, in the order it was written by `SceneRecord::Write()`.
+     * @tparam T A trivially copyable type.
+     * @return @b True if @p value was read. @b False if the payload is too short, in which case @p value is left untouched.
+     */
+    template <typename T>
+    bool Read(T &value) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SceneRecordView::Read() requires a trivially copyable type");
+        if (payload_size - cursor < sizeof(T)) return false;
+        std::memcpy(&value, payload + cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+};
+
+
+/**
+ * @brief ## Scene type registry class
+ * @brief Maps the type names found in scene files to the functions creating them.
+ */
+class SceneTypeRegistry {
+public:
+    using ObjectFactory  = std::function<Scene::ObjectHandle(Scene&, const SceneRecordView&)>;              ///< Creates a `GameObject` in a `Scene`.
+    using ElementFactory = std::function<UIContainer::ElementHandle(UIContainer&, const SceneRecordView&)>; ///< Creates a `UIElement` in a `UIContainer`.
+private:
+    std::unordered_map<std::string, ObjectFactory>  objects;  // Object factories by type name.
+    std::unordered_map<std::string, ElementFactory> elements; // Element factories by type name.
+public:
+    /**
+     * @brief Create a registry holding the built in `UI` elements.
+     */
+    SceneTypeRegistry();
+
+    /**
+     * @brief Register a `GameObject` type.
+     * @param type Type name, as written by the type's `GameObject::Save()`.
+     * @param factory Function creating the object from a record, e.g. through `Scene::Emplace()`, and returning it's handle.
+     * @note Registering the same name twice replaces the previous factory.
+     */
+    void RegisterObject(const std::string &type, ObjectFactory factory);
+    /**
+     * @brief Register a `GameObject` type constructible from a `const SceneRecordView&`. Objects are created through `Scene::Emplace()`.
+     */
+    template <typename T>
+    void RegisterObject(const std::string &type)
+    {
+        RegisterObject(type, [](Scene &scene, const SceneRecordView &record) { return scene.Emplace<T>(record.id, record); });
+    }
+    /**
+     * @brief Register a `UIElement` type.
+     * @param type Type name, as written by the type's `GameObject::Save()`.
+     * @param factory Function creating the element from a record, e.g. through `UIContainer::Emplace()`, and returning it's handle.
+     */
+    void RegisterElement(const std::string &type, ElementFactory factory);
+    /**
+     * @brief Register a `UIElement` type constructible from a `const SceneRecordView&`. Elements are created through `UIContainer::Emplace()`.
+     */
+    template <typename T>
+    void RegisterElement(const std::string &type)
+    {
+        RegisterElement(type, [](UIContainer &ui, const SceneRecordView &record) { return ui.Emplace<T>(record.id, record); });
+    }
+
+    /**
+     * @brief Get the factory of an object type.
+     * @return A pointer to the factory, or @b nullptr if @p type is not registered.
+     */
+    const ObjectFactory  *FindObject(const std::string &type) const;
+    /**
+     * @brief Get the factory of an element type.
+     * @return A pointer to the factory, or @b nullptr if @p type is not registered.
+     */
+    const ElementFactory *FindElement(const std::string &type) const;
+};
+
+/**
+ * @brief Global type registry used by `SceneFile::Load()`.
+ */
+extern SceneTypeRegistry scene_types;
+
+
+/**
+ * @brief ## Scene file class
+ * @brief Saves scenes to, and loads them from, binary scene files.
+ */
+class SceneFile {
+public:
+    static constexpr uint32_t VERSION   = 1;          ///< Version written to, and expected in, the header.
+    static constexpr uint32_t NO_STRING = 0xFFFFFFFF; ///< String offset meaning "no string".
+
+    /**
+     * @brief First bytes of every scene file.
+     */
+    struct Header {
+        char     magic[4];        ///< Always "RSCN".
+        uint32_t version;         ///< Always `VERSION`.
+        uint32_t type_count;      ///< Number of type names.
+        uint32_t preload_count;   ///< Number of preloaded texture paths.
+        uint32_t object_count;    ///< Number of object records.
+        uint32_t container_count; ///< Number of container records.
+        uint32_t element_count;   ///< Number of element records.
+        uint32_t string_bytes;    ///< Size of the string table.
+        uint32_t payload_bytes;   ///< Size of the payload section.
+        uint32_t reserved;        ///< Always zero.
+    };
+    /**
+     * @brief Stored `GameObject` or `UIElement`.
+     */
+    struct ObjectRecord {
+        uint32_t type;           ///< Index of the type name.
+        uint32_t id;             ///< String offset of the identifier.
+        uint32_t resource;       ///< String offset of the resource path.
+        int32_t  draw_order;     ///< Draw order.
+        float    x, y;           ///< Position.
+        float    rotation;       ///< Rotation.
+        float    scale;          ///< Scale.
+        uint32_t payload_offset; ///< Offset of the payload in the payload section.
+        uint32_t payload_size;   ///< Size of the payload.
+    };
+    /**
+     * @brief Stored `UIContainer`.
+     */
+    struct ContainerRecord {
+        uint32_t id;            ///< String offset of the identifier.
+        int32_t  draw_order;    ///< Draw order of the container.
+        uint32_t element_count; ///< Number of element records belonging to the container.
+        uint32_t flags;         ///< Bit 0 set if the container is cached, see `UIContainer::SetCached()`.
+    };
+
+    /**
+     * @brief Write @p scene to a scene file.
+     * @param scene The scene to save.
+     * @param path Path of the file to write, relative to `SCENES_PATH`.
+     * @return @b True if the file was written. @b False otherwise.
+     * @note Objects whose `GameObject::Save()` returns @b false are left out, with a warning.
+     */
+    static bool   Save(const Scene &scene, const std::string &path);
+    /**
+     * @brief Create a scene from a scene file.
+     * @param path Path of the file to read, relative to `SCENES_PATH`.
+     * @return The new scene, to be given to `SceneManager::AddScene()`, or @b nullptr if the file is missing or malformed.
+     * @note Records of unregistered types are skipped, with a warning.
+     * @warning Must be called after window initialization, as objects usually acquire their resources when created.
+     */
+    static Scene *Load(const std::string &path);
+};
+
+#endif // SCENE_FILE_H
@@ -0,0 +1,303 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include "flatMap.hxx"
+#include "stringId.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file slotMap.hxx
+ * @brief This file contains the `SlotMap` template class, the `HandleIndex` class and the `SlotHandle` struct.
+ * @details
+ * A `SlotMap` stores it's values densely in a single `std::vector` so they can be iterated linearly, while handing out
+ * `SlotHandle` values that stay valid no matter how many other values are inserted or erased.
+ *
+ * Each handle holds the index of an indirection slot and the generation of that slot. Erasing a value bumps the generation of it's
+ * slot, so old handles to that slot are detected and rejected instead of silently pointing to a different value.
+ *
+ * Erasing moves the last value into the erased spot, so the iteration order of a `SlotMap` is @b not stable across erasures.
+ * `EraseOrdered()` keeps it stable instead, at the cost of shifting every later value.
+ *
+ * A `HandleIndex` is an optional side index mapping `std::string` identifiers to handles, looked up by their `StringId`. It is kept
+ * separate from the `SlotMap` so that per-frame iteration never touches it.
+ */
+
+
+/**
+ * @brief ## Slot handle struct
+ * @brief Stable reference to a value stored in a `SlotMap`.
+ */
+struct SlotHandle {
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX; ///< Slot index of a handle that does not point to anything.
+
+    uint32_t index      = INVALID_INDEX; ///< Index of the slot in the `SlotMap`.
+    uint32_t generation = 0;             ///< Generation of the slot at the time the handle was created.
+
+    /**
+     * @brief Check whether the handle was ever given out by a `SlotMap`.
+     * @return @b False for default constructed handles. @b True otherwise.
+     * @note A valid handle may still refer to an erased value. Use `SlotMap::Contains()` to check that.
+     */
+    bool IsValid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const SlotHandle &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle &other) const { return !(*this == other); }
+};
+
+
+/**
+ * @brief ## Slot map class
+ * @brief Densely stored values addressed through stable generational handles.
+ * @tparam T Type of the stored values.
+ */
+template <typename T>
+class SlotMap {
+private:
+    struct Slot {
+        uint32_t dense;      // Index of the value in `values`, or the next free slot if this one is free.
+        uint32_t generation; // Increased every time the slot is freed.
+    };
+
+    std::vector<T>        values;    // Densely stored values.
+    std::vector<uint32_t> owners;    // Slot index owning each entry of `values`.
+    std::vector<Slot>     slots;     // Indirection table used by handles.
+    uint32_t              free_head; // First free slot, or `SlotHandle::INVALID_INDEX` if there are none.
+
+    bool IsLive(SlotHandle handle) const
+    {
+        return handle.index < slots.size()
+            && slots[handle.index].generation == handle.generation
+            && slots[handle.index].dense < values.size()
+            && owners[slots[handle.index].dense] == handle.index;
+    }
+public:
+    using iterator       = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /**
+     * @brief Create an empty `SlotMap`.
+     */
+    SlotMap() : free_head(SlotHandle::INVALID_INDEX) {}
+
+    /**
+     * @brief Store a new value.
+     * @param value Value to store.
+     * @return A handle to the stored value.
+     */
+    SlotHandle Insert(T value)
+    {
+        uint32_t index;
+        if (free_head != SlotHandle::INVALID_INDEX)
+        {
+            index     = free_head;
+            free_head = slots[index].dense;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{0, 0});
+        }
+        slots[index].dense = static_cast<uint32_t>(values.size());
+        values.push_back(std::move(value));
+        owners.push_back(index);
+        return SlotHandle{index, slots[index].generation};
+    }
+
+    /**
+     * @brief Remove the value referred to by @p handle.
+     * @param handle Handle of the value to remove.
+     * @return @b True if a value was removed. @b False if @p handle did not refer to a stored value.
+     * @note The last stored value is moved into the freed position.
+     */
+    bool Erase(SlotHandle handle)
+    {
+        if (!IsLive(handle)) return false;
+
+        uint32_t dense = slots[handle.index].dense;
+        uint32_t last  = static_cast<uint32_t>(values.size() - 1);
+        if (dense != last)
+        {
+            values[dense] = std::move(values[last]);
+            owners[dense] = owners[last];
+            slots[owners[dense]].dense = dense;
+        }
+        values.pop_back();
+        owners.pop_back();
+
+        slots[handle.index].generation++;
+        slots[handle.index].dense = free_head;
+        free_head = handle.index;
+        return true;
+    }
+
+    /**
+     * @brief Remove the value referred to by @p handle, keeping the other values in insertion order.
+     * @param handle Handle of the value to remove.
+     * @return @b True if a value was removed. @b False if @p handle did not refer to a stored value.
+     * @note Every later value is moved one position back, so this is linear in the number of stored values.
+     */
+    bool EraseOrdered(SlotHandle handle)
+    {
+        if (!IsLive(handle)) return false;
+
+        for (uint32_t dense = slots[handle.index].dense; dense + 1 < values.size(); dense++)
+        {
+            values[dense] = std::move(values[dense + 1]);
+            owners[dense] = owners[dense + 1];
+            slots[owners[dense]].dense = dense;
+        }
+        values.pop_back();
+        owners.pop_back();
+
+        slots[handle.index].generation++;
+        slots[handle.index].dense = free_head;
+        free_head = handle.index;
+        return true;
+    }
+
+    /**
+     * @brief Check whether @p handle refers to a stored value.
+     * @param handle Handle to check.
+     * @return @b True if the value referred to by @p handle is still stored. @b False otherwise.
+     */
+    bool Contains(SlotHandle handle) const { return IsLive(handle); }
+
+    /**
+     * @brief Get a pointer to the value referred to by @p handle.
+     * @param handle Handle of the desired value.
+     * @return A pointer to the value, or @b nullptr if @p handle does not refer to a stored value.
+     * @warning The pointer is invalidated by any later `Insert()` or `Erase()` call. Keep the handle instead.
+     */
+    T *Get(SlotHandle handle) { return IsLive(handle) ? &values[slots[handle.index].dense] : nullptr; }
+    /**
+     * @brief Get a @b constant pointer to the value referred to by @p handle.
+     * @param handle Handle of the desired value.
+     * @return A @b constant pointer to the value, or @b nullptr if @p handle does not refer to a stored value.
+     */
+    const T *Get(SlotHandle handle) const { return IsLive(handle) ? &values[slots[handle.index].dense] : nullptr; }
+
+    /**
+     * @brief Get the handle of the value stored at a given dense position.
+     * @param dense Position of the value, in the [0, `Size()`) range.
+     * @return The handle of said value.
+     */
+    SlotHandle HandleAt(size_t dense) const { return SlotHandle{owners[dense], slots[owners[dense]].generation}; }
+
+    /**
+     * @brief Get the position of a value in the dense storage.
+     * @param handle Handle of the desired value. Must refer to a stored value.
+     * @return The position of the value, in the [0, `Size()`) range.
+     */
+    size_t DenseIndex(SlotHandle handle) const { return slots[handle.index].dense; }
+
+    /**
+     * @brief Get the number of stored values.
+     */
+    size_t Size()  const { return values.size(); }
+    /**
+     * @brief Check whether there are no stored values.
+     */
+    bool   Empty() const { return values.empty(); }
+    /**
+     * @brief Get the number of bytes reserved by the map's storage, used or not.
+     */
+    size_t ReservedBytes() const
+    {
+        return values.capacity() * sizeof(T) + owners.capacity() * sizeof(uint32_t) + slots.capacity() * sizeof(Slot);
+    }
+    /**
+     * @brief Reserve storage for @p count values, so inserting up to that many does not reallocate.
+     */
+    void   Reserve(size_t count)
+    {
+        values.reserve(count);
+        owners.reserve(count);
+        slots.reserve(count);
+    }
+    /**
+     * @brief Remove all values. Every handle given out so far is invalidated.
+     */
+    void Clear()
+    {
+        for (uint32_t owner : owners)
+        {
+            slots[owner].generation++;
+            slots[owner].dense = free_head;
+            free_head = owner;
+        }
+        values.clear();
+        owners.clear();
+    }
+
+    iterator       begin()       { return values.begin(); }
+    iterator       end()         { return values.end();   }
+    const_iterator begin() const { return values.begin(); }
+    const_iterator end()   const { return values.end();   }
+};
+
+
+/**
+ * @brief ## Handle index class
+ * @brief Optional side index mapping identifiers to `SlotHandle` values through their `StringId`, and handles back to their identifier.
+ */
+class HandleIndex {
+private:
+    FlatMap<StringId, SlotHandle>  handles; // Identifier to handle lookup.
+    FlatMap<uint32_t, std::string> keys;    // Slot index to identifier lookup, used when erasing by handle.
+public:
+    /**
+     * @brief Associate @p key with @p handle.
+     * @param key Identifier to associate.
+     * @param handle Handle to associate.
+     * @return @b True if the association was made. @b False if @p key, or another identifier with the same `StringId`, was already in use.
+     */
+    bool Bind(const std::string &key, SlotHandle handle)
+    {
+        if (!handles.Insert(StringId(key), handle)) return false;
+        keys[handle.index] = key;
+        return true;
+    }
+    /**
+     * @brief Remove the association of @p handle, if it has any.
+     * @param handle Handle to forget.
+     */
+    void Unbind(SlotHandle handle)
+    {
+        const std::string *key = keys.Find(handle.index);
+        if (!key) return;
+        handles.Erase(StringId(key->data(), key->size()));
+        keys.Erase(handle.index);
+    }
+    /**
+     * @brief Look up the handle associated with @p key.
+     * @param key Identifier to look up.
+     * @return The associated handle, or an invalid handle if @p key is unknown.
+     */
+    SlotHandle Find(StringId key) const
+    {
+        const SlotHandle *handle = handles.Find(key);
+        return handle ? *handle : SlotHandle{};
+    }
+    /**
+     * @brief Look up the key associated with @p handle.
+     * @param handle Handle to look up.
+     * @return A pointer to the associated identifier, or @b nullptr if @p handle has none.
+     */
+    const std::string *FindKey(SlotHandle handle) const
+    {
+        return keys.Find(handle.index);
+    }
+    /**
+     * @brief Remove every association.
+     */
+    void Clear()
+    {
+        handles.Clear();
+        keys.Clear();
+    }
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,185 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "globals.hxx"
+#include "slotMap.hxx"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @file spatialHash.hxx
+ * @brief This file contains the `SpatialHash` class.
+ * @details
+ * The `SpatialHash` is a uniform grid of square cells, stored sparsely in a hash map, that indexes rectangles by the cells they overlap.
+ * Area queries only visit the cells overlapping the queried area, so their cost depends on how crowded that area is rather than on how
+ * many rectangles are indexed.
+ *
+ * Rectangles overlapping too many cells are kept in a separate list that every query tests, and entries without bounds can be stored
+ * as "unbounded", to be handled by the caller (e.g. never culled).
+ *
+ * Entries are identified by a `SlotHandle`, which makes the index usable alongside any `SlotMap`. It is used by `Scene` for culling and
+ * for proximity queries.
+ */
+
+
+/**
+ * @brief ## Spatial hash class
+ * @brief Sparse uniform grid indexing rectangles identified by a `SlotHandle`.
+ */
+class SpatialHash {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 128.0f; ///< Default side of a cell, in world units.
+    static constexpr int   MAX_CELLS         = 64;     ///< Maximum number of cells an entry is stored in before it is considered large.
+private:
+    enum class Placement : uint8_t { NONE, CELLS, LARGE, UNBOUNDED };
+    struct CellRange {
+        int x0, y0, x1, y1; // Inclusive cell coordinates.
+        bool operator==(const CellRange &other) const { return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1; }
+        long long Count() const { return (long long)(x1 - x0 + 1) * (y1 - y0 + 1); }
+    };
+    struct Entry {
+        SlotHandle handle;     // Full handle of the entry, to tell apart reused slots.
+        Rectangle  bounds;     // Last indexed bounds.
+        CellRange  range;      // Cells the entry is stored in, when `placement` is `CELLS`.
+        Placement  placement;  // Where the entry is stored.
+        uint32_t   list_index; // Position in `large` or `unbounded`.
+    };
+
+    float cell_size;
+    std::vector<Entry> entries;                                   // Entries by slot index.
+    std::unordered_map<int64_t, std::vector<uint32_t>> cells;     // Slot indices of the entries overlapping each cell.
+    std::vector<uint32_t> large;                                  // Slot indices of entries overlapping more than `MAX_CELLS` cells.
+    std::vector<uint32_t> unbounded;                              // Slot indices of entries without bounds.
+    size_t count;                                                 // Number of indexed entries.
+
+    static int64_t CellKey(int x, int y) { return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y); }
+    static bool Overlaps(const Rectangle &a, const Rectangle &b)
+    {
+        return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+    }
+    CellRange RangeOf(const Rectangle &bounds) const
+    {
+        return CellRange{(int)std::floor(bounds.x / cell_size),                  (int)std::floor(bounds.y / cell_size),
+                         (int)std::floor((bounds.x + bounds.width) / cell_size), (int)std::floor((bounds.y + bounds.height) / cell_size)};
+    }
+    Entry *Find(SlotHandle handle);
+    void Unlink(Entry &entry);
+public:
+    /**
+     * @brief Create an empty index.
+     * @param _cell_size Side of a cell, in world units. Works best around the size of the typical indexed rectangle.
+     */
+    explicit SpatialHash(float _cell_size = DEFAULT_CELL_SIZE);
+
+    /**
+     * @brief Insert an entry, or update it's bounds if it is already indexed.
+     * @param handle Identifier of the entry.
+     * @param bounds Bounds of the entry, in world units.
+     * @return @b True if the entry was inserted or it's bounds changed, @b false if it was already indexed with the same bounds.
+     * @note Entries are only moved between cells when the cells they overlap change, so updating still entries is cheap.
+     */
+    bool   Set(SlotHandle handle, const Rectangle &bounds);
+    /**
+     * @brief Insert an entry without bounds, or turn an already indexed entry into one.
+     * @param handle Identifier of the entry.
+     * @return @b True if the entry was inserted or had bounds, @b false if it was already indexed without bounds.
+     * @note Unbounded entries are never reported by `QueryRect()`. Use `ForEachUnbounded()` to visit them.
+     */
+    bool   SetUnbounded(SlotHandle handle);
+    /**
+     * @brief Remove an entry. Does nothing if it is not indexed.
+     */
+    void   Remove(SlotHandle handle);
+    /**
+     * @brief Check whether an entry is indexed.
+     */
+    bool   Contains(SlotHandle handle) const;
+    /**
+     * @brief Remove all entries.
+     */
+    void   Clear();
+    /**
+     * @brief Check whether an entry is indexed without bounds.
+     */
+    bool   IsUnbounded(SlotHandle handle) const;
+    /**
+     * @brief Get the number of indexed entries, unbounded ones included.
+     */
+    size_t Size() const;
+    /**
+     * @brief Get the number of entries indexed without bounds.
+     */
+    size_t UnboundedCount() const;
+    /**
+     * @brief Estimate the number of bytes reserved by the index, cells included.
+     */
+    size_t ReservedBytes() const;
+
+    /**
+     * @brief Call @p callback for every bounded entry overlapping @p area.
+     * @param area Queried area, in world units.
+     * @param callback Callable taking a `SlotHandle` and the @b constant `Rectangle` bounds of the entry. Each entry is reported once.
+     */
+    template <typename Callback>
+    void QueryRect(const Rectangle &area, Callback &&callback) const;
+    /**
+     * @brief Call @p callback with the `SlotHandle` of every unbounded entry.
+     */
+    template <typename Callback>
+    void ForEachUnbounded(Callback &&callback) const
+    {
+        for (uint32_t index : unbounded)
+        {
+            callback(entries[index].handle);
+        }
+    }
+};
+
+
+template <typename Callback>
+void SpatialHash::QueryRect(const Rectangle &area, Callback &&callback) const
+{
+    for (uint32_t index : large)
+    {
+        if (Overlaps(entries[index].bounds, area))
+            callback(entries[index].handle, entries[index].bounds);
+    }
+
+    CellRange range = RangeOf(area);
+    // An entry overlapping several queried cells is only reported from the first of them
+    auto visit = [&](int x, int y, const std::vector<uint32_t> &cell) {
+        for (uint32_t index : cell)
+        {
+            const Entry &entry = entries[index];
+            if (x != std::max(entry.range.x0, range.x0) || y != std::max(entry.range.y0, range.y0)) continue;
+            if (Overlaps(entry.bounds, area))
+                callback(entry.handle, entry.bounds);
+        }
+    };
+
+    if (range.Count() > (long long)cells.size())
+    {
+        // Huge areas (e.g. a zoomed out camera) are cheaper to answer by walking the occupied cells
+        for (auto &cell : cells)
+        {
+            int x = (int)(cell.first >> 32);
+            int y = (int)(uint32_t)cell.first;
+            if (x >= range.x0 && x <= range.x1 && y >= range.y0 && y <= range.y1)
+                visit(x, y, cell.second);
+        }
+        return;
+    }
+    for (int y = range.y0; y <= range.y1; y++)
+    {
+        for (int x = range.x0; x <= range.x1; x++)
+        {
+            auto it = cells.find(CellKey(x, y));
+            if (it != cells.end())
+                visit(x, y, it->second);
+        }
+    }
+}
+
+#endif // SPATIAL_HASH_H
@@ -0,0 +1,107 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "globals.hxx"
+
+/**
+ * @file spriteBatch.hxx
+ * @brief This file contains the declaration of the `SpriteBatch` class and the `DrawSprite()` function.
+ * @details
+ * The `SpriteBatch` collects textured quads instead of drawing them right away. When flushed, the collected quads are grouped by layer,
+ * shader and texture, and each group is submitted to raylib's render batch in one go, which keeps texture switches (and therefore GPU
+ * draw calls) to a minimum.
+ *
+ * Layers keep the draw-order semantics: quads on a lower layer are always drawn below quads on a higher one, and only quads sharing a
+ * layer may be reordered to group them by texture.
+ *
+ * Anything that draws directly through raylib while a batch is active (shapes, `DrawText()`, custom shader passes...) must call `Flush()` first
+ * so that previously submitted quads still end up below it.
+ */
+
+
+/**
+ * @brief ## Sprite batch class
+ * @brief Collects textured quads and submits them grouped by layer, shader and texture.
+ */
+class SpriteBatch {
+private:
+    struct Quad {
+        Vector2      corners[4]; // Top-left, bottom-left, bottom-right and top-right corners, in that order.
+        float        u0, v0;     // Texture coordinates of the top-left corner.
+        float        u1, v1;     // Texture coordinates of the bottom-right corner.
+        Color        tint;       // Vertex colour.
+        unsigned int texture;    // Texture id.
+        Shader       shader;     // Shader to draw with. An id of 0 means raylib's default shader.
+        int          layer;      // Layer the quad was submitted on.
+    };
+
+    std::vector<Quad>   quads; // Quads submitted since the last flush.
+    std::vector<size_t> order; // Auxiliary vector used to sort `quads` on flush.
+    int    depth;              // Number of nested `Begin()` calls.
+    int    layer;              // Layer assigned to newly submitted quads.
+    Shader shader;             // Shader assigned to newly submitted quads.
+public:
+    /**
+     * @brief Create an inactive, empty batch.
+     */
+    SpriteBatch();
+
+    /**
+     * @brief Start collecting quads. Calls can be nested, only the outermost `End()` flushes the batch.
+     */
+    void Begin();
+    /**
+     * @brief Stop collecting quads and submit everything that was collected.
+     */
+    void End();
+    /**
+     * @brief Check whether quads are being collected.
+     * @return @b True between `Begin()` and it's matching `End()`. @b False otherwise.
+     */
+    bool IsActive() const;
+
+    /**
+     * @brief Set the layer of the quads submitted from now on.
+     * @param _layer The new layer. Usually the position of the object being drawn in the drawing order, so overlapping objects
+     * are never reordered.
+     */
+    void SetLayer(int _layer);
+    /**
+     * @brief Set the shader of the quads submitted from now on.
+     * @param _shader The new shader. Pass a default constructed `Shader` to go back to raylib's default shader.
+     * @warning All quads sharing a shader are drawn with the same uniform values, whatever they were at the time of the flush.
+     */
+    void SetShader(Shader _shader);
+    /**
+     * @brief Get the shader assigned to newly submitted quads.
+     */
+    Shader GetShader() const;
+
+    /**
+     * @brief Submit a textured quad. Takes the same parameters as raylib's `DrawTexturePro()`.
+     * @param texture Texture to sample from.
+     * @param source Region of @p texture to draw. Negative sizes flip the image.
+     * @param dest Location and size of the quad.
+     * @param origin Origin of the quad, relative to @p dest.
+     * @param rotation Rotation of the quad around @p origin, in degrees.
+     * @param tint Colour modulation.
+     */
+    void Draw(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+    /**
+     * @brief Submit all collected quads to raylib's render batch, grouped by layer, shader and texture.
+     */
+    void Flush();
+};
+
+/**
+ * @brief Global sprite batch used by the `UIContainer`, `Scene` and sprite drawing classes.
+ */
+extern SpriteBatch sprite_batch;
+
+/**
+ * @brief Draw a texture through `sprite_batch` if it is active, or directly with `DrawTexturePro()` otherwise.
+ * @note Takes the same parameters as raylib's `DrawTexturePro()`.
+ */
+void DrawSprite(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,103 @@
+#ifndef STREAMING_BUDGET_H
+#define STREAMING_BUDGET_H
+
+#include <cstddef>
+
+/**
+ * @file streamingBudget.hxx
+ * @brief This file contains the declaration of the `StreamingBudget` class.
+ * @details
+ * The `StreamingBudget` caps the amount of video memory used by streamed resources, i.e. `AnimatedTexture` objects initialized with
+ * `AnimatedTexture::InitializeStreaming()`. Streamed textures charge the budget for every frame they keep resident and only request
+ * frames ahead of their playhead while it has room left, so the budget is shared by all of them.
+ *
+ * The budget is a soft limit: the frame being displayed is always kept, even when it does not fit.
+ */
+
+
+/**
+ * @brief ## Streaming charge class
+ * @brief Bytes charged to `streaming_budget` by one owner, discharged when said owner is destroyed.
+ * @note Copies charge the budget again, since the owner they belong to keeps it's resources alive too.
+ */
+class StreamingCharge {
+private:
+    size_t bytes; // Bytes currently charged.
+public:
+    StreamingCharge();
+    StreamingCharge(const StreamingCharge &other);
+    StreamingCharge &operator=(const StreamingCharge &other);
+    /**
+     * @brief Discharge all charged bytes.
+     */
+    ~StreamingCharge();
+
+    /**
+     * @brief Charge @p _bytes more.
+     */
+    void   Add(size_t _bytes);
+    /**
+     * @brief Discharge @p _bytes.
+     */
+    void   Remove(size_t _bytes);
+    /**
+     * @brief Get the number of bytes currently charged.
+     */
+    size_t Get() const;
+};
+
+
+/**
+ * @brief ## Streaming budget class
+ * @brief Video memory accounting shared by all streamed textures.
+ */
+class StreamingBudget {
+private:
+    size_t budget;   // Maximum number of bytes streamed textures should keep resident.
+    size_t resident; // Number of bytes currently kept resident by streamed textures.
+public:
+    static constexpr size_t DEFAULT_BUDGET = 256u << 20; ///< Budget used until `SetBudget()` is called, 256 MiB.
+
+    /**
+     * @brief Create an empty budget of `DEFAULT_BUDGET` bytes.
+     */
+    StreamingBudget();
+
+    /**
+     * @brief Set the maximum number of bytes streamed textures should keep resident.
+     * @note Lowering the budget below `GetResident()` makes streamed textures evict frames on their next update.
+     */
+    void   SetBudget(size_t bytes);
+    /**
+     * @brief Get the maximum number of bytes streamed textures should keep resident.
+     */
+    size_t GetBudget() const;
+    /**
+     * @brief Get the number of bytes currently kept resident by streamed textures.
+     */
+    size_t GetResident() const;
+    /**
+     * @brief Check whether @p bytes more can be kept resident without exceeding the budget.
+     */
+    bool   Fits(size_t bytes) const;
+    /**
+     * @brief Check whether the resident bytes exceed the budget.
+     */
+    bool   IsExceeded() const;
+
+    /**
+     * @brief Record @p bytes more as resident.
+     */
+    void   Charge(size_t bytes);
+    /**
+     * @brief Record @p bytes as no longer resident.
+     */
+    void   Discharge(size_t bytes);
+};
+
+/**
+ * @brief Global streaming budget, shared by all `AnimatedTexture` objects in streaming mode.
+ */
+extern StreamingBudget streaming_budget;
+
+#endif // STREAMING_BUDGET_H
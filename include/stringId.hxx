@@ -0,0 +1,101 @@
+#ifndef STRING_ID_H
+#define STRING_ID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @file stringId.hxx
+ * @brief This file contains the `StringId` class and the `_sid` literal operator.
+ * @details
+ * A `StringId` is the 64 bit FNV-1a hash of an identifier. It is computed at compile time from literals (`"player"_sid`), so looking
+ * up an object with it neither allocates nor compares strings. `Scene`, `UIContainer` and `SceneManager` accept a `StringId` wherever
+ * they take a `std::string` identifier, and their `std::string` overloads hash the string and forward to the `StringId` ones.
+ *
+ * Identifiers hashed from a `std::string` are recorded in a reverse table, so `GetName()` can tell them apart in error messages, and
+ * two identifiers sharing a hash are reported. The table is only kept when `RGAME_STRING_ID_NAMES` is defined when compiling, since it
+ * costs a lock on every hash; otherwise `GetName()` returns the hash itself.
+ *
+ * @note Literals are only guaranteed to be hashed at compile time in constant expressions, e.g. `constexpr StringId PLAYER = "player"_sid;`.
+ */
+
+
+/**
+ * @brief ## String identifier class
+ * @brief Hashed identifier, cheap to copy, compare and look up.
+ */
+class StringId {
+private:
+    uint64_t hash; // FNV-1a hash of the identifier, or zero for invalid ids.
+public:
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull; ///< FNV-1a offset basis, the hash of the empty string.
+    static constexpr uint64_t FNV_PRIME  = 1099511628211ull;        ///< FNV-1a prime.
+
+    /**
+     * @brief Compute the FNV-1a hash of @p length characters of @p text.
+     */
+    static constexpr uint64_t Hash(const char *text, size_t length)
+    {
+        uint64_t value = FNV_OFFSET;
+        for (size_t i = 0; i < length; i++)
+        {
+            value = (value ^ (unsigned char)text[i]) * FNV_PRIME;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Create an invalid identifier, which matches nothing.
+     */
+    constexpr StringId() : hash(0) {}
+    /**
+     * @brief Hash @p length characters of @p text. Not recorded in the reverse table.
+     */
+    constexpr StringId(const char *text, size_t length) : hash(Hash(text, length)) {}
+    /**
+     * @brief Hash a string, recording it in the reverse table if `RGAME_STRING_ID_NAMES` is defined.
+     */
+    explicit StringId(const std::string &text);
+
+    /**
+     * @brief Get the hash of the identifier.
+     */
+    constexpr uint64_t GetHash() const { return hash; }
+    /**
+     * @brief Check whether the identifier was hashed from a string.
+     */
+    constexpr bool     IsValid() const { return hash != 0; }
+    /**
+     * @brief Get the string the identifier was hashed from.
+     * @return Said string if it is in the reverse table, otherwise the hash written as `"#"` followed by 16 hexadecimal digits.
+     */
+    std::string GetName() const;
+
+    constexpr bool operator==(const StringId &other) const { return hash == other.hash; }
+    constexpr bool operator!=(const StringId &other) const { return hash != other.hash; }
+};
+
+/**
+ * @brief Hash a string literal into a `StringId`, e.g. `scene.GetObject("player"_sid)`.
+ */
+constexpr StringId operator""_sid(const char *text, size_t length)
+{
+    return StringId(text, length);
+}
+
+/**
+ * @brief Throw the same exception as `ThrowNotFoundException()`, naming @p id through `StringId::GetName()`.
+ */
+[[noreturn]] void ThrowNotFoundException(StringId id);
+
+namespace std
+{
+    template <>
+    struct hash<StringId> {
+        size_t operator()(const StringId &id) const noexcept { return (size_t)id.GetHash(); }
+    };
+}
+
+#endif // STRING_ID_H
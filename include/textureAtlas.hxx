@@ -0,0 +1,76 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "globals.hxx"
+
+/**
+ * @file textureAtlas.hxx
+ * @brief This file contains the declaration of the `TextureAtlas` class.
+ * @details
+ * A `TextureAtlas` packs many small images into a single `Texture2D`. Each packed image is then drawn by using the atlas texture
+ * together with the source rectangle of it's region, so sprites sharing an atlas can be merged into the same batch and no texture
+ * switch happens between them.
+ *
+ * Images are first queued with `AddImage()` and packed all at once by `Build()`, using rows ("shelves") of images sorted by height.
+ */
+
+
+/**
+ * @brief ## Texture atlas class
+ * @brief Packs multiple images into a single texture.
+ */
+class TextureAtlas {
+private:
+    std::vector<Image>     images;  // Images queued for packing. Emptied by `Build()`.
+    std::vector<Rectangle> regions; // Location of each image inside `texture`.
+    Texture2D texture;              // The packed texture.
+    int       padding;              // Empty pixels left around each image to avoid bleeding when filtering.
+    bool      built;                // Whether `texture` has been created.
+public:
+    /**
+     * @brief Create an empty atlas.
+     * @param _padding Empty pixels left around each packed image.
+     */
+    TextureAtlas(int _padding = 1);
+    /**
+     * @brief Unloads the packed texture and any image still waiting to be packed.
+     */
+    ~TextureAtlas();
+    TextureAtlas(const TextureAtlas&)            = delete;
+    TextureAtlas &operator=(const TextureAtlas&) = delete;
+
+    /**
+     * @brief Queue an image to be packed.
+     * @param image The image to pack. Ownership is passed to the atlas.
+     * @return The index of the image's region, usable with `GetRegion()` once the atlas is built.
+     * @warning Images can't be added after `Build()` has been called.
+     */
+    int  AddImage(Image image);
+    /**
+     * @brief Pack all queued images and upload the result to the GPU.
+     * @param max_size Maximum width and height of the atlas texture.
+     * @return @b True if all images fit and the texture was created. @b False otherwise, in which case the atlas stays empty.
+     * @note Function must be called after window initialization.
+     */
+    bool Build(int max_size = 4096);
+    /**
+     * @brief Check whether the atlas texture has been created.
+     */
+    bool IsBuilt() const;
+
+    /**
+     * @brief Get the packed texture.
+     */
+    Texture2D GetTexture() const;
+    /**
+     * @brief Get the location of a packed image inside the atlas texture.
+     * @param index Index returned by `AddImage()`.
+     */
+    Rectangle GetRegion(int index) const;
+    /**
+     * @brief Get the number of regions in the atlas.
+     */
+    int       GetRegionCount() const;
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,195 @@
+#ifndef TRANSFORM_STORE_H
+#define TRANSFORM_STORE_H
+
+#include "globals.hxx"
+#include "slotMap.hxx"
+#include <vector>
+
+/**
+ * @file transformStore.hxx
+ * @brief This file contains the declaration of the `TransformStore` class.
+ * @details
+ * A `TransformStore` holds many transforms as a structure of arrays: positions, rotations, scales and sizes each live in their own
+ * contiguous array, so that updating all of them touches only the memory actually needed, and the bounds pass can run four entries at
+ * a time on SSE2 or NEON (with a scalar fallback on other targets).
+ *
+ * Every entry has a local transform, relative to an optional parent entry, and a size and pivot describing the rectangle it draws
+ * into. `Update()` computes, in one batch, the world transform of every entry and the world space bounds of it's rectangle, once rotated
+ * and scaled. Objects only keep the `TransformStore::Handle` of their entry and read the results, instead of each building their
+ * destination rectangle on it's own.
+ *
+ * Entries are kept sorted so that parents come before their children. Sorting only happens in `Update()`, and only after the hierarchy
+ * changed, so stores without parented entries are never sorted.
+ *
+ * Every `Scene` owns a store, see `Scene::GetTransforms()`. Using it is optional, `GameObject::transform` keeps working as before.
+ *
+ * Rotations are in degrees, like everywhere else they are passed to raylib.
+ */
+
+
+/**
+ * @brief ## Transform store class
+ * @brief Structure of arrays of hierarchical transforms, with world transforms and bounds computed in batches.
+ */
+class TransformStore {
+public:
+    /**
+     * @brief Stable identifier of an entry. Stays valid while other entries are created, removed or reordered.
+     */
+    using Handle = SlotHandle;
+    static constexpr uint32_t NO_PARENT = UINT32_MAX; ///< Parent index of root entries.
+private:
+    struct Slot {
+        uint32_t dense;      // Index of the entry in the arrays, or the next free slot if this one is free.
+        uint32_t generation; // Increased every time the slot is freed.
+    };
+
+    std::vector<float>    local_x, local_y, local_rotation, local_scale; // Local transform of every entry.
+    std::vector<float>    width, height, pivot_x, pivot_y;               // Unscaled size of every entry, and it's pivot as a fraction of it.
+    std::vector<float>    world_x, world_y, world_rotation, world_scale; // World transform of every entry, as of the last `Update()`.
+    std::vector<float>    world_cos, world_sin;                          // Cosine and sine of `world_rotation`.
+    std::vector<float>    min_x, min_y, max_x, max_y;                    // World space bounds of every entry, as of the last `Update()`.
+    std::vector<uint32_t> parents;       // Slot of the parent of every entry, or `NO_PARENT`.
+    std::vector<uint32_t> parent_index;  // Index of the parent of every entry, or `NO_PARENT`. Only up to date after sorting.
+    std::vector<uint32_t> owners;        // Slot owning every entry.
+    std::vector<Slot>     slots;         // Indirection table used by handles.
+    uint32_t              free_head;     // First free slot, or `SlotHandle::INVALID_INDEX` if there are none.
+    size_t                root_count;    // Number of entries without a parent. They come first once sorted.
+    size_t                child_count;   // Number of entries with a parent.
+    bool                  order_dirty;   // Whether entries must be sorted again before computing world transforms.
+    std::vector<uint32_t> order, depths; // Auxiliary vectors used by `Sort()`.
+    std::vector<float>    scratch;       // Auxiliary vector used by `Sort()`.
+
+    bool IsLive(Handle handle) const;
+    void SwapRemove(uint32_t index);
+    void Sort();
+    void ComputeBounds(size_t begin, size_t end);
+public:
+    /**
+     * @brief Create an empty store.
+     */
+    TransformStore();
+
+    /**
+     * @brief Add an entry.
+     * @param local Transform of the entry. Also it's world transform, until it is given a parent.
+     * @param size Unscaled size of the rectangle the entry draws into, e.g. the size of it's texture.
+     * @param pivot Point of the rectangle placed at the entry's position and rotated around, as a fraction of @p size.
+     * Centered by default, like `AnimatedTexture::Draw()`.
+     * @return A handle to the new entry.
+     * @note World transform and bounds are computed by the next `Update()`.
+     */
+    Handle      Create(Transform2D local = {}, Vector2 size = {0, 0}, Vector2 pivot = {0.5f, 0.5f});
+    /**
+     * @brief Remove an entry. Children of the entry become root entries, keeping their local transform.
+     * @note Removing an already removed entry has no effect.
+     */
+    void        Remove(Handle handle);
+    /**
+     * @brief Check whether @p handle refers to an entry of the store.
+     */
+    bool        Contains(Handle handle) const;
+    /**
+     * @brief Get the number of entries.
+     */
+    size_t      Size() const;
+    /**
+     * @brief Get the number of bytes reserved by the store's arrays, used or not.
+     */
+    size_t      ReservedBytes() const;
+    /**
+     * @brief Remove all entries. Every handle given out so far becomes invalid.
+     */
+    void        Clear();
+
+    /**
+     * @brief Attach an entry to a parent, so it's local transform becomes relative to said parent.
+     * @param child Entry to attach.
+     * @param parent New parent, or an invalid handle to detach @p child.
+     * @return @b True if the parent was changed. @b False if either handle is stale, or if @p parent is @p child or one of it's descendants.
+     */
+    bool        SetParent(Handle child, Handle parent);
+    /**
+     * @brief Get the parent of an entry.
+     * @return The parent's handle, or an invalid handle for root entries.
+     */
+    Handle      GetParent(Handle handle) const;
+
+    /**
+     * @brief Set the local transform of an entry.
+     */
+    void        SetLocal(Handle handle, Transform2D local);
+    /**
+     * @brief Get the local transform of an entry.
+     */
+    Transform2D GetLocal(Handle handle) const;
+    /**
+     * @brief Set the local position of an entry.
+     */
+    void        SetPosition(Handle handle, Vector2 position);
+    /**
+     * @brief Set the rectangle an entry draws into.
+     * @param size Unscaled size of the rectangle.
+     * @param pivot Point of the rectangle placed at the entry's position, as a fraction of @p size.
+     */
+    void        SetSize(Handle handle, Vector2 size, Vector2 pivot = {0.5f, 0.5f});
+    /**
+     * @brief Get the world transform of an entry, as of the last `Update()`.
+     */
+    Transform2D GetWorld(Handle handle) const;
+    /**
+     * @brief Get the world space bounds of an entry, as of the last `Update()`.
+     * @note Axis aligned, covering the rotated rectangle. Fit for `GameObject::GetBounds()`.
+     */
+    Rectangle   GetBounds(Handle handle) const;
+    /**
+     * @brief Get the scaled destination rectangle of an entry and it's origin, as expected by `DrawSprite()`.
+     * @param dest Where to write the destination rectangle, positioned at the entry's world position.
+     * @param origin Where to write the origin, i.e. the scaled pivot.
+     */
+    void        GetDrawRect(Handle handle, Rectangle &dest, Vector2 &origin) const;
+
+    /**
+     * @brief Compute the world transform and bounds of every entry.
+     * @note Called by `Scene::Update()` after all objects were updated, and before the spatial index is refreshed.
+     * @note May reorder entries, which invalidates indices obtained from `GetIndex()`, but never handles.
+     */
+    void        Update();
+
+    /**
+     * @brief Get the current array index of an entry, for use with the array accessors.
+     * @return The index, or `Size()` if @p handle is stale.
+     */
+    size_t      GetIndex(Handle handle) const;
+    /**
+     * @brief Get the handle of the entry at an array index.
+     */
+    Handle      GetHandle(size_t index) const;
+    /**
+     * @brief Get the array of local positions along the X axis, to update many entries in a tight loop.
+     * @note Arrays are indexed by `GetIndex()`, and hold `Size()` values. Pointers are invalidated by `Create()` and `Update()`.
+     */
+    float      *GetLocalX()        { return local_x.data(); }
+    /**
+     * @brief Get the array of local positions along the Y axis. See `GetLocalX()`.
+     */
+    float      *GetLocalY()        { return local_y.data(); }
+    /**
+     * @brief Get the array of local rotations. See `GetLocalX()`.
+     */
+    float      *GetLocalRotation() { return local_rotation.data(); }
+    /**
+     * @brief Get the array of local scales. See `GetLocalX()`.
+     */
+    float      *GetLocalScale()    { return local_scale.data(); }
+    /**
+     * @brief Get the world transform of the entry at an array index, as of the last `Update()`.
+     */
+    Transform2D GetWorldAt(size_t index) const;
+    /**
+     * @brief Get the world space bounds of the entry at an array index, as of the last `Update()`.
+     */
+    Rectangle   GetBoundsAt(size_t index) const;
+};
+
+#endif // TRANSFORM_STORE_H
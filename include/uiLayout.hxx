@@ -0,0 +1,175 @@
+#ifndef UI_LAYOUT_H
+#define UI_LAYOUT_H
+
+#include "globals.hxx"
+#include "slotMap.hxx"
+#include "objectPool.hxx"
+#include <vector>
+
+class UIElement;
+
+/**
+ * @file uiLayout.hxx
+ * @brief This file contains the `LayoutType` enum, the `LayoutStyle` struct and the `UILayout` class.
+ * @details
+ * A `UILayout` is a tree of nodes placing the elements of a `UIContainer`, see `UIContainer::GetLayout()`. Every node gets a
+ * rectangle from it's parent (the screen for root nodes), places it's element into it if it has one, and arranges it's own children
+ * inside of it: each on it's own anchor, or stacked in a column, a row or a grid, with padding and spacing.
+ *
+ * Computed rectangles are cached. Only nodes whose style or content changed are laid out again, along with the ancestors whose size
+ * depends on them, and only children whose rectangle actually moved are visited. Content changes are detected through
+ * `UIElement::MarkDirty()`, so e.g. setting the text of a `UI::Label` relays out it's row, and a screen resize relays out everything
+ * in a single pass on the next `UIContainer::Update()`.
+ *
+ * Elements keep working without a layout. Placed elements have their position (and for some of them, their size) overwritten whenever
+ * their node moves, see `UIElement::Place()`.
+ */
+
+
+/**
+ * @brief How a layout node arranges it's children.
+ */
+enum class LayoutType {
+    ANCHOR, ///< Every child is placed on it's own anchor inside the node.
+    COLUMN, ///< Children are stacked from top to bottom.
+    ROW,    ///< Children are stacked from left to right.
+    GRID    ///< Children fill rows of `LayoutStyle::columns` cells, from left to right and top to bottom.
+};
+
+
+/**
+ * @brief ## Layout style struct
+ * @brief Describes the size of a layout node, where it sits in it's parent, and how it arranges it's children.
+ */
+struct LayoutStyle {
+    LayoutType type    = LayoutType::ANCHOR; ///< How children are arranged.
+    Vector2    anchor  = {0, 0};  ///< Where the node sits in the space given by it's parent, as a fraction of it. {0.5, 0.5} centers it. Stacks only use the cross axis.
+    Vector2    offset  = {0, 0};  ///< Pixels added to the anchored position.
+    Vector2    size    = {0, 0};  ///< Size of the node, in pixels. Components of zero fit the content instead.
+    Vector2    fill    = {0, 0};  ///< Size of the node as a fraction of the space given by it's parent. Components above zero override `size`.
+    float      padding = 0;       ///< Pixels left empty inside the node's borders, around it's children.
+    float      spacing = 0;       ///< Pixels between consecutive children of stacks and grids.
+    float      justify = 0;       ///< Where the children of a stack sit along it's main axis when they don't fill it. 0.5 centers them.
+    int        columns = 1;       ///< Number of cells per row of a grid.
+};
+
+
+/**
+ * @brief ## UI layout class
+ * @brief Tree of nodes computing the rectangles of a container's elements, incrementally.
+ */
+class UILayout {
+public:
+    /**
+     * @brief Stable identifier of a layout node.
+     */
+    using Handle = SlotHandle;
+private:
+    struct Node {
+        LayoutStyle         style;
+        Handle              parent;         // Parent node, or an invalid handle for root nodes.
+        std::vector<Handle> children;       // Child nodes, in arrangement order.
+        SlotHandle          element;        // Element placed by the node, or an invalid handle.
+        Vector2             measured;       // Size wanted by the node, as of the last measure.
+        Rectangle           rect;           // Rectangle given to the node, as of the last arrangement.
+        bool                arranged;       // Whether `rect` was ever computed.
+        bool                measure_dirty;  // Whether `measured` must be computed again.
+        bool                dirty;          // Whether the node or one of it's descendants must be laid out again.
+    };
+
+    SlotMap<OwnedPtr<UIElement>> &elements; // Elements of the owning container.
+    SlotMap<Node>                 nodes;    // All nodes.
+    std::vector<Handle>           roots;    // Nodes without a parent, placed in the screen.
+    Rectangle                     screen;   // Screen rectangle as of the last `Update()`.
+    bool                          updating; // Whether `Update()` is running. Elements placed meanwhile don't mark their node.
+    size_t                        visited;  // Number of nodes arranged by the last `Update()`.
+
+    Handle  Insert(const LayoutStyle &style, Handle parent, SlotHandle element);
+    void    MarkDirty(Handle handle, bool remeasure);
+    void    Erase(Handle handle);
+    Vector2 Measure(Handle handle);
+    void    Arrange(Handle handle, Rectangle slot);
+    Vector2 SlotSize(const Node &node, Vector2 available) const;
+
+    /**
+     * @brief Lay out every dirty node, and every node if the screen changed size.
+     * @param _screen Current screen rectangle.
+     */
+    void Update(Rectangle _screen);
+    /**
+     * @brief Flag the node placing an element as changed, so it is measured again.
+     */
+    void ContentChanged(Handle handle);
+    /**
+     * @brief Stop placing an element that is about to be removed from it's container.
+     */
+    void Detach(Handle handle);
+    friend class UIContainer;
+    friend class UIElement;
+public:
+    /**
+     * @brief Create an empty layout.
+     * @param _elements Elements of the owning container.
+     */
+    explicit UILayout(SlotMap<OwnedPtr<UIElement>> &_elements);
+    UILayout(const UILayout&)            = delete;
+    UILayout &operator=(const UILayout&) = delete;
+
+    /**
+     * @brief Add a node without an element, e.g. a menu column.
+     * @param style Size, position and arrangement of the node.
+     * @param parent Node to add it to, after it's existing children. If invalid, the node is placed in the screen.
+     * @return A handle to the new node, or an invalid handle if @p parent is stale.
+     */
+    Handle Add(const LayoutStyle &style, Handle parent = {});
+    /**
+     * @brief Add a node placing an element of the owning container.
+     * @param element Handle of the element, as returned by `UIContainer::AddElement()` or `UIContainer::Emplace()`.
+     * @param style Size, position and arrangement of the node. Components of `LayoutStyle::size` left at zero use the element's
+     * `UIElement::GetLayoutSize()`.
+     * @param parent Node to add it to, after it's existing children. If invalid, the node is placed in the screen.
+     * @return A handle to the new node, or an invalid handle if @p element or @p parent is stale.
+     * @note An element is placed by one node at most. Attaching it again detaches it from it's previous node.
+     */
+    Handle Attach(SlotHandle element, const LayoutStyle &style = {}, Handle parent = {});
+    /**
+     * @brief Remove a node and all of it's descendants. Their elements stay in the container, where they were last placed.
+     */
+    void   Remove(Handle handle);
+    /**
+     * @brief Check whether @p handle refers to a node of the layout.
+     */
+    bool   Contains(Handle handle) const;
+    /**
+     * @brief Get the number of nodes.
+     */
+    size_t Size() const;
+
+    /**
+     * @brief Change the style of a node. Only the node, it's ancestors and it's siblings are laid out again.
+     */
+    void               SetStyle(Handle handle, const LayoutStyle &style);
+    /**
+     * @brief Get the style of a node.
+     */
+    const LayoutStyle &GetStyle(Handle handle) const;
+    /**
+     * @brief Get the rectangle of a node, as of the last `UIContainer::Update()`.
+     * @return The rectangle, or an empty one if @p handle is stale.
+     */
+    Rectangle          GetRect(Handle handle) const;
+    /**
+     * @brief Lay out a node again on the next update, e.g. after it's element changed size without calling `UIElement::MarkDirty()`.
+     */
+    void               Invalidate(Handle handle);
+    /**
+     * @brief Lay out every node again on the next update.
+     */
+    void               InvalidateAll();
+    /**
+     * @brief Get the number of nodes arranged by the last update. Nodes that neither changed nor moved are skipped, and not counted.
+     */
+    size_t             GetVisitedCount() const;
+};
+
+#endif // UI_LAYOUT_H
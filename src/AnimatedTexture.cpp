@@ -1,59 +1,289 @@
 #include "AnimatedTexture.hxx"
+#include "spriteBatch.hxx"
+#include "frameClock.hxx"
+#include <algorithm>
+#include <cmath>
 
 void AnimatedTexture::LoadFrames(std::string texture_name, int frame_count)
 {
     for (int i = 0; i < frame_count; i++)
     {
-        frames[i] = LoadTexture(((TEXTURES_PATH/texture_name).u8string() + std::to_string(i+1) + ".png").c_str());
+        frames[i] = resources.AcquireTexture(texture_name + std::to_string(i+1) + ".png");
     }
 }
 
-AnimatedTexture::AnimatedTexture()
+std::string AnimatedTexture::FramePath(int index) const
+{
+    return texture_names + std::to_string(index+1) + ".png";
+}
+
+void AnimatedTexture::QueueFrames(TextureAtlas &target, std::vector<int> &indices) const
+{
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        indices.push_back(target.AddImage(LoadImage(((TEXTURES_PATH/texture_names).u8string() + std::to_string(i+1) + ".png").c_str())));
+    }
+}
+
+AnimatedTexture::AnimatedTexture() : initialized(false), frames_ready(true), streaming(false), stream_window(0), displayed_frame(0), frame_estimate(0)
 {
     frames.resize(1);
-    frames[0]         = Texture2D{};
-    ms_per_frame      = std::chrono::milliseconds(0);
-    last_frame_change = std::chrono::steady_clock::now();
+    seconds_per_frame = 0;
+    anchor_time       = frame_clock.GetTime();
+    anchor_position   = 0;
+    speed             = 1;
     current_frame     = 0;
     loop              = false;
+    play              = false;
 }
 
-AnimatedTexture::AnimatedTexture(std::string texture_name, int frame_count, int fps, bool _loop) : loop(_loop), texture_names(texture_name), initialized(false)
+AnimatedTexture::AnimatedTexture(std::string texture_name, int frame_count, int fps, bool _loop) : loop(_loop), texture_names(texture_name), initialized(false), frames_ready(true),
+                                                                                                    streaming(false), stream_window(0), displayed_frame(0), frame_estimate(0)
 {
-    ms_per_frame      = std::chrono::milliseconds(1000 / fps);
-    last_frame_change = std::chrono::steady_clock::now();
+    seconds_per_frame = 1.0 / fps;
+    anchor_time       = frame_clock.GetTime();
+    anchor_position   = 0;
+    speed             = 1;
     frames.resize(frame_count);
     current_frame = 0;
     play = loop;
 }
 
-AnimatedTexture::~AnimatedTexture()
+void AnimatedTexture::Initialize(bool use_atlas)
 {
-    for (auto &frame : frames)
+    if (use_atlas)
     {
-        UnloadTexture(frame);
+        InitializeShared({this});
+        return;
     }
+    StopStreaming();
+    LoadFrames(texture_names, frames.size());
+    initialized  = true;
+    frames_ready = true;
 }
 
-void AnimatedTexture::Initialize()
+void AnimatedTexture::InitializeAsync()
 {
-    LoadFrames(texture_names, frames.size());
-    initialized = true;
+    StopStreaming();
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        frames[i] = resources.AcquireTextureAsync(texture_names + std::to_string(i+1) + ".png");
+    }
+    initialized  = true;
+    frames_ready = false;
+}
+
+void AnimatedTexture::InitializeShared(const std::vector<AnimatedTexture*> &textures)
+{
+    auto shared = std::make_shared<TextureAtlas>();
+    std::vector<std::vector<int>> indices(textures.size());
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        textures[i]->QueueFrames(*shared, indices[i]);
+    }
+
+    if (!shared->Build())
+    {
+        for (AnimatedTexture *texture : textures)
+        {
+            texture->Initialize();
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        AnimatedTexture &texture = *textures[i];
+        texture.StopStreaming();
+        texture.atlas = shared;
+        texture.regions.clear();
+        for (int index : indices[i])
+        {
+            texture.regions.push_back(shared->GetRegion(index));
+        }
+        texture.initialized  = true;
+        texture.frames_ready = true;
+    }
+}
+
+void AnimatedTexture::InitializeStreaming(int window)
+{
+    StopStreaming();
+    for (TextureHandle &frame : frames)
+    {
+        frame.Reset();
+    }
+    atlas.reset();
+    regions.clear();
+    streaming       = true;
+    stream_window   = std::max(1, std::min(window, (int)frames.size()));
+    current_frame   = GetCurrentFrame();
+    displayed_frame = current_frame;
+    frame_bytes.assign(frames.size(), 0);
+    initialized     = true;
+    frames_ready    = false;
+    Stream();
+}
+
+bool AnimatedTexture::IsStreaming() const
+{
+    return streaming;
+}
+
+size_t AnimatedTexture::GetResidentFrameCount() const
+{
+    if (atlas)     return regions.size();
+    if (streaming) return streamed.size();
+    return frames.size();
+}
+
+const std::shared_ptr<TextureAtlas> &AnimatedTexture::GetAtlas() const
+{
+    return atlas;
+}
+
+const std::vector<Rectangle> &AnimatedTexture::GetRegions() const
+{
+    return regions;
+}
+
+void AnimatedTexture::StopStreaming()
+{
+    if (!streaming) return;
+    for (int index : streamed)
+    {
+        frames[index].Reset();
+    }
+    streamed.clear();
+    frame_bytes.clear();
+    charge.Remove(charge.Get());
+    streaming = false;
+}
+
+bool AnimatedTexture::InWindow(int index) const
+{
+    int distance = index - current_frame;
+    if (loop && distance < 0) distance += frames.size();
+    return distance >= 0 && distance < stream_window;
+}
+
+void AnimatedTexture::EvictFrame(int index)
+{
+    frames[index].Reset();
+    charge.Remove(frame_bytes[index]);
+    frame_bytes[index] = 0;
+}
+
+bool AnimatedTexture::EvictBehind()
+{
+    size_t farthest = streamed.size();
+    int    distance = -1;
+    for (size_t i = 0; i < streamed.size(); i++)
+    {
+        int index = streamed[i];
+        if (InWindow(index) || index == displayed_frame) continue;
+        // Frames just played are the last ones needed again
+        int ahead = index - current_frame;
+        if (ahead < 0) ahead += frames.size();
+        if (ahead > distance)
+        {
+            farthest = i;
+            distance = ahead;
+        }
+    }
+    if (farthest == streamed.size()) return false;
+    EvictFrame(streamed[farthest]);
+    streamed[farthest] = streamed.back();
+    streamed.pop_back();
+    return true;
+}
+
+void AnimatedTexture::Stream()
+{
+    // Charge the budget for the frames that finished uploading since the last call
+    for (int index : streamed)
+    {
+        if (frame_bytes[index] != 0 || !frames[index].IsReady()) continue;
+        Texture2D texture = frames[index].Get();
+        if (texture.id == 0) continue;
+        frame_bytes[index] = GetPixelDataSize(texture.width, texture.height, texture.format);
+        frame_estimate     = frame_bytes[index];
+        charge.Add(frame_bytes[index]);
+    }
+    if (frames[current_frame].IsReady())
+        displayed_frame = current_frame;
+
+    // Unload the frames left behind. Looping animations keep them for the next loop, as long as the budget allows
+    bool keep_behind = loop && !streaming_budget.IsExceeded();
+    for (size_t i = 0; i < streamed.size();)
+    {
+        int index = streamed[i];
+        if (InWindow(index) || index == displayed_frame || keep_behind)
+        {
+            i++;
+            continue;
+        }
+        EvictFrame(index);
+        streamed[i] = streamed.back();
+        streamed.pop_back();
+    }
+
+    // Request the frames ahead, in playback order. The current frame is requested even if it does not fit
+    for (int k = 0; k < stream_window; k++)
+    {
+        int index = current_frame + k;
+        if (index >= (int)frames.size())
+        {
+            if (!loop) break;
+            index -= frames.size();
+        }
+        if (frames[index].IsValid()) continue;
+        // Frames ahead win over the ones kept for the next loop, starting with the ones coming up last
+        while (k > 0 && !streaming_budget.Fits(frame_estimate) && EvictBehind()) {}
+        if (k > 0 && !streaming_budget.Fits(frame_estimate)) break;
+        frames[index] = resources.AcquireTextureAsync(FramePath(index));
+        streamed.push_back(index);
+    }
 }
 
 bool AnimatedTexture::IsInitialized() const
 {
-    return initialized;
+    if (streaming)
+    {
+        frames_ready = frames[displayed_frame].IsReady();
+        return initialized && frames_ready;
+    }
+    if (initialized && !frames_ready)
+    {
+        frames_ready = std::all_of(frames.begin(), frames.end(), [](const TextureHandle &frame) { return frame.IsReady(); });
+    }
+    return initialized && frames_ready;
+}
+
+double AnimatedTexture::GetPosition() const
+{
+    if (!play || seconds_per_frame <= 0) return anchor_position;
+    return anchor_position + (frame_clock.GetTime() - anchor_time) * speed / seconds_per_frame;
+}
+
+void AnimatedTexture::Anchor()
+{
+    anchor_position = GetPosition();
+    anchor_time     = frame_clock.GetTime();
+    // Keep the position small, so long running loops don't lose precision
+    if (loop) anchor_position = std::fmod(anchor_position, (double)frames.size());
 }
 
 void AnimatedTexture::Play()
 {
+    if (play) Anchor();
+    anchor_time = frame_clock.GetTime();
     play = true;
-    last_frame_change = std::chrono::steady_clock::now();
 }
 
 void AnimatedTexture::Pause()
 {
+    Anchor();
     play = false;
 }
 
@@ -70,25 +300,64 @@ void AnimatedTexture::Stop()
 
 void AnimatedTexture::Reset()
 {
-    current_frame = 0;
+    anchor_time     = frame_clock.GetTime();
+    anchor_position = 0;
+}
+
+void AnimatedTexture::SetSpeed(double _speed)
+{
+    Anchor();
+    speed = std::max(0.0, _speed);
+}
+
+double AnimatedTexture::GetSpeed() const
+{
+    return speed;
+}
+
+int AnimatedTexture::GetCurrentFrame() const
+{
+    int    count    = (int)frames.size();
+    double position = GetPosition();
+    if (loop) position = std::fmod(position, (double)count);
+    return std::max(0, std::min(count - 1, (int)position));
+}
+
+bool AnimatedTexture::IsFinished() const
+{
+    return !loop && GetPosition() >= (double)frames.size();
 }
 
 void AnimatedTexture::Draw(Transform2D transform) const
 {
-    if (initialized)
+    if (IsInitialized())
     {
-        Rectangle rsource  = {0,0,(float)frames[current_frame].width,(float)frames[current_frame].height};
+        int       frame    = streaming ? displayed_frame : GetCurrentFrame();
+        Texture2D texture  = atlas ? atlas->GetTexture() : frames[frame].Get();
+        Rectangle rsource  = atlas ? regions[frame] : Rectangle{0,0,(float)texture.width,(float)texture.height};
         Rectangle rdest    = {transform.position.x, transform.position.y, rsource.width * transform.scale, rsource.height * transform.scale};
         Vector2   origin   = {rsource.width / 2, rsource.height / 2};
-        DrawTexturePro(frames[current_frame], rsource, rdest, origin, transform.rotation, WHITE);
+        DrawSprite(texture, rsource, rdest, origin, transform.rotation, WHITE);
     }
 }
 
-void AnimatedTexture::Update()
+void AnimatedTexture::Draw(const TransformStore &store, TransformStore::Handle entry) const
 {
-    if ((std::chrono::steady_clock::now() - last_frame_change) > ms_per_frame && initialized && play)
+    if (IsInitialized() && store.Contains(entry))
     {
-        current_frame = (current_frame + 1) % frames.size();
-        last_frame_change = std::chrono::steady_clock::now();
+        int       frame   = streaming ? displayed_frame : GetCurrentFrame();
+        Texture2D texture = atlas ? atlas->GetTexture() : frames[frame].Get();
+        Rectangle rsource = atlas ? regions[frame] : Rectangle{0,0,(float)texture.width,(float)texture.height};
+        Rectangle rdest;
+        Vector2   origin;
+        store.GetDrawRect(entry, rdest, origin);
+        DrawSprite(texture, rsource, rdest, origin, store.GetWorld(entry).rotation, WHITE);
     }
 }
+
+void AnimatedTexture::Update()
+{
+    if (!streaming) return;
+    current_frame = GetCurrentFrame();
+    Stream();
+}
@@ -1,11 +1,18 @@
 #include "UI.hpp"
+#include "spriteBatch.hxx"
+#include "resourceManager.hxx"
+#include "profiler.hxx"
+#include "sceneFile.hxx"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 
 using namespace UI;
 // Static member initialization
 Color Button::TINT_PRESS = { 150, 150, 150, 255 };
+bool  Button::variant_caching = true;
 
-UIElement::UIElement() : draw_order(0), active(true), enabled(true)
+UIElement::UIElement() : draw_order(0), active(true), enabled(true), dirty(true), blocks_pointer(false), owner(nullptr), layout_node{}
 {
 }
 
@@ -19,16 +26,21 @@ void UIElement::SetDrawOrder(int _order)
     draw_order = _order;
     if (draw_order < MIN_DRAW_ORDER) draw_order = MIN_DRAW_ORDER;
     if (draw_order > MAX_DRAW_ORDER) draw_order = MAX_DRAW_ORDER;
+    if (owner) owner->render_queue.Invalidate();
+    MarkDirty();
 }
 
 void UIElement::ToggleDisplayState()
 {
     active = !active;
+    MarkDirty();
 }
 
 void UIElement::SetDisplayState(bool _active)
 {
+    if (active == _active) return;
     active = _active;
+    MarkDirty();
 }
 
 bool UIElement::GetDisplayState()
@@ -56,50 +68,161 @@ bool UIElement::IsEnabled() const
     return enabled;
 }
 
-UIContainer::UIContainer() : draw_order(0)
+void UIElement::SetBlocksPointer(bool enabled)
+{
+    blocks_pointer = enabled;
+    // Hit test targets are refreshed when dirty elements are updated
+    dirty = true;
+}
+
+bool UIElement::BlocksPointer() const
+{
+    return blocks_pointer;
+}
+
+void UIElement::MarkDirty()
+{
+    dirty = true;
+    if (!owner) return;
+    owner->InvalidateCache();
+    if (layout_node.IsValid()) owner->layout.ContentChanged(layout_node);
+}
+
+bool UIElement::IsDirty() const
+{
+    return dirty;
+}
+
+Transform2D &UIElement::GetTransform()
+{
+    MarkDirty();
+    return transform;
+}
+
+Vector2 UIElement::GetLayoutSize() const
+{
+    Rectangle bounds;
+    if (!GetBounds(bounds)) return Vector2{0, 0};
+    return Vector2{bounds.width, bounds.height};
+}
+
+void UIElement::Place(Rectangle rect)
+{
+    transform.position = Vector2{rect.x, rect.y};
+    MarkDirty();
+}
+
+UIContainer::UIContainer() : draw_order(0), owner_queue(nullptr), profile_update_name("UIContainer::Update"), profile_draw_name("UIContainer::Draw"),
+                             cached(false), cache{}, cache_valid(false), hovered{}, pressed{}, resource_reloads(0),
+                             layout(elements)
 {
 }
 
 UIContainer::~UIContainer()
 {
-    for (auto& element : elements)
+    if (cache.id != 0 && IsWindowReady())
+        UnloadRenderTexture(cache);
+    for (auto &element : elements)
     {
-        delete element.second;
+        element.Finalize();
     }
 }
 
-void UIContainer::AddElement(std::string id, UIElement *_element)
+UIContainer::ElementHandle UIContainer::AddElement(const std::string &id, UIElement *_element)
 {
-    elements.emplace(id, _element);
+    if (element_ids.Find(StringId(id)).IsValid())
+        return ElementHandle{};
+
+    ElementHandle handle = AddElement(_element);
+    element_ids.Bind(id, handle);
+    return handle;
 }
 
-void UIContainer::RemoveElement(std::string id)
+UIContainer::ElementHandle UIContainer::AddElement(UIElement *_element)
 {
-    delete elements[id];
-    elements.erase(id);
+    _element->owner = this;
+    render_queue.Invalidate();
+    InvalidateCache();
+    return elements.Insert(OwnedPtr<UIElement>{_element, nullptr});
 }
 
-UIElement &UIContainer::GetElement(std::string id)
+void UIContainer::RemoveElement(const std::string &id)
 {
-    auto it = elements.find(id);
-    if (it != elements.end()) {
-        return *(it->second);
-    }
-    else{
+    RemoveElement(StringId(id));
+}
+
+void UIContainer::RemoveElement(StringId id)
+{
+    RemoveElement(element_ids.Find(id));
+}
+
+void UIContainer::RemoveElement(ElementHandle handle)
+{
+    OwnedPtr<UIElement> *element = elements.Get(handle);
+    if (!element) return;
+
+    layout.Detach(element->object->layout_node);
+    element->Destroy();
+    // Elements sharing a draw order stack in insertion order, which removing another one must not change
+    elements.EraseOrdered(handle);
+    element_ids.Unbind(handle);
+    pointer_targets.Remove(handle);
+    if (hovered == handle) hovered = ElementHandle{};
+    if (pressed == handle) pressed = ElementHandle{};
+    render_queue.Invalidate();
+    InvalidateCache();
+}
+
+UIElement &UIContainer::GetElement(const std::string &id)
+{
+    return GetElement(StringId(id));
+}
+
+const UIElement &UIContainer::GetElement(const std::string &id) const
+{
+    return GetElement(StringId(id));
+}
+
+UIElement &UIContainer::GetElement(StringId id)
+{
+    OwnedPtr<UIElement> *element = elements.Get(element_ids.Find(id));
+    if (!element)
         ThrowNotFoundException(id);
-    }
-    
+    return *element->object;
 }
 
-const UIElement &UIContainer::GetElement(std::string id) const
+const UIElement &UIContainer::GetElement(StringId id) const
 {
-    auto it = elements.find(id);
-    if (it != elements.end()) {
-        return *(it->second);
-    }
-    else{
+    const OwnedPtr<UIElement> *element = elements.Get(element_ids.Find(id));
+    if (!element)
         ThrowNotFoundException(id);
-    }
+    return *element->object;
+}
+
+UIElement &UIContainer::GetElement(ElementHandle handle)
+{
+    OwnedPtr<UIElement> *element = elements.Get(handle);
+    if (!element)
+        ThrowNotFoundException("#" + std::to_string(handle.index));
+    return *element->object;
+}
+
+const UIElement &UIContainer::GetElement(ElementHandle handle) const
+{
+    const OwnedPtr<UIElement> *element = elements.Get(handle);
+    if (!element)
+        ThrowNotFoundException("#" + std::to_string(handle.index));
+    return *element->object;
+}
+
+UIContainer::ElementHandle UIContainer::GetElementHandle(const std::string &id) const
+{
+    return GetElementHandle(StringId(id));
+}
+
+UIContainer::ElementHandle UIContainer::GetElementHandle(StringId id) const
+{
+    return element_ids.Find(id);
 }
 
 int UIContainer::GetDrawOrder() const
@@ -112,32 +235,218 @@ void UIContainer::SetDrawOrder(int _order)
     draw_order = _order;
     if (draw_order < MIN_DRAW_ORDER) draw_order = MIN_DRAW_ORDER;
     if (draw_order > MAX_DRAW_ORDER) draw_order = MAX_DRAW_ORDER;
+    if (owner_queue) owner_queue->Invalidate();
+}
+
+UILayout &UIContainer::GetLayout()
+{
+    return layout;
+}
+
+const UILayout &UIContainer::GetLayout() const
+{
+    return layout;
 }
 
 void UIContainer::Update()
 {
-    for (auto& element : elements){
-        if (element.second->GetDisplayState())
-        element.second->Update();
+    PROFILE_SCOPE(profile_update_name);
+    // Hot reloaded textures may have changed size, so cached sizes, hitboxes and layouts are recomputed
+    if (resource_reloads != resources.GetReloadCount())
+    {
+        resource_reloads = resources.GetReloadCount();
+        for (auto &element : elements) element.object->dirty = true;
+        layout.InvalidateAll();
+        InvalidateCache();
+    }
+    // Placed elements are marked dirty, so they are updated below with their new position
+    layout.Update(Rectangle{0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()});
+    for (size_t i = 0; i < elements.Size(); i++){
+        UIElement *element = elements.begin()[i].object;
+        if (!element->GetDisplayState()) continue;
+        // Static elements that did not change have nothing to recompute
+        if (element->IsStatic() && !element->dirty) continue;
+        bool changed = element->dirty;
+        element->Update();
+        if (changed && (element->IsInteractive() || element->blocks_pointer))
+            IndexElement(elements.HandleAt(i), *element);
+        else if (changed)
+            pointer_targets.Remove(elements.HandleAt(i));
+        element->dirty = false;
+    }
+    DispatchInput();
+}
+
+void UIContainer::IndexElement(ElementHandle handle, const UIElement &element)
+{
+    // Elements at MAX_DRAW_ORDER are not drawn, so they must not take the pointer from the ones below either
+    Rectangle bounds;
+    if (element.draw_order < MAX_DRAW_ORDER && element.GetBounds(bounds))
+        pointer_targets.Set(handle, bounds);
+    else
+        pointer_targets.Remove(handle);
+}
+
+UIContainer::ElementHandle UIContainer::HitTest(Vector2 point) const
+{
+    ElementHandle top{};
+    int    top_order = 0;
+    size_t top_dense = 0;
+    pointer_targets.QueryRect(Rectangle{point.x, point.y, 0, 0}, [&](SlotHandle handle, const Rectangle &bounds) {
+        if (!CheckCollisionPointRec(point, bounds)) return;
+        const UIElement &element = *elements.Get(handle)->object;
+        // Shown blockers stop the pointer even while disabled
+        if (!element.active || !(element.enabled || element.blocks_pointer) || element.draw_order >= MAX_DRAW_ORDER) return;
+        // Same order as `Draw()`: higher draw orders on top, and later elements on top of earlier ones with the same order
+        size_t dense = elements.DenseIndex(handle);
+        if (!top.IsValid() || element.draw_order > top_order || (element.draw_order == top_order && dense > top_dense))
+        {
+            top       = handle;
+            top_order = element.draw_order;
+            top_dense = dense;
+        }
+    });
+    return top;
+}
+
+void UIContainer::DispatchInput()
+{
+    const PointerState &pointer = input_router.GetPointer();
+    ElementHandle top = input_router.IsCaptured() ? ElementHandle{} : HitTest(pointer.position);
+    if (top.IsValid())
+    {
+        input_router.Capture();
+        // Blockers only keep the pointer from lower elements and containers, they are not sent events
+        const UIElement &element = *elements.Get(top)->object;
+        if (!element.IsInteractive() || !element.enabled) top = ElementHandle{};
+    }
+
+    // Elements are looked up again after every event, as callbacks may remove them
+    auto send = [this](ElementHandle handle, PointerEvent event) {
+        if (OwnedPtr<UIElement> *element = elements.Get(handle))
+            element->object->OnPointerEvent(event);
+    };
+    if (top != hovered)
+    {
+        ElementHandle left = hovered;
+        hovered = top;
+        if (left == pressed) pressed = ElementHandle{};
+        if (left.IsValid()) send(left, PointerEvent::LEAVE);
+        if (top.IsValid())  send(top,  PointerEvent::ENTER);
+    }
+    if (pointer.pressed && hovered.IsValid())
+    {
+        pressed = hovered;
+        send(pressed, PointerEvent::PRESS);
+    }
+    if (pointer.released && pressed.IsValid())
+    {
+        ElementHandle released = pressed;
+        pressed = ElementHandle{};
+        send(released, PointerEvent::RELEASE);
+    }
+}
+
+void UIContainer::SetCached(bool enabled)
+{
+    cached = enabled;
+    cache_valid = false;
+    if (!cached && cache.id != 0)
+    {
+        UnloadRenderTexture(cache);
+        cache = RenderTexture2D{};
     }
 }
 
+bool UIContainer::IsCached() const
+{
+    return cached;
+}
+
+void UIContainer::InvalidateCache()
+{
+    cache_valid = false;
+}
+
+void UIContainer::AccumulateMemory(MemoryStats &stats, TextureSet &textures) const
+{
+    stats.ui_containers++;
+    stats.ui_elements += elements.Size();
+    stats.heap_bytes  += element_pools.ReservedBytes() + elements.ReservedBytes() + pointer_targets.ReservedBytes();
+    for (const OwnedPtr<UIElement> &element : elements)
+    {
+        // Pooled elements are already counted by their pool's blocks
+        if (!element.pool)
+        {
+            stats.heap_objects++;
+            stats.heap_bytes += GameObject::GetAllocationSize(*element.object);
+        }
+        element->CollectTextures(textures);
+    }
+    textures.Add(cache.texture);
+}
+
+MemoryStats UIContainer::GetMemoryStats() const
+{
+    MemoryStats stats;
+    TextureSet  textures;
+    AccumulateMemory(stats, textures);
+    stats.textures      = textures.Count();
+    stats.texture_bytes = textures.Bytes();
+    return stats;
+}
+
 void UIContainer::Draw() const
 {
-    for (int i = MIN_DRAW_ORDER; i < MAX_DRAW_ORDER; i++)
+    PROFILE_SCOPE(profile_draw_name);
+    if (!cached)
     {
-        for (auto& element : elements){
-            if (element.second->GetDrawOrder() == i && element.second->GetDisplayState())
-                element.second->Draw();
+        DrawElements();
+        return;
+    }
+
+    int width = GetScreenWidth(), height = GetScreenHeight();
+    if (cache.id == 0 || cache.texture.width != width || cache.texture.height != height)
+    {
+        if (cache.id != 0) UnloadRenderTexture(cache);
+        cache = LoadRenderTexture(width, height);
+        cache_valid = false;
+    }
+    if (!cache_valid)
+    {
+        BeginRenderTarget(cache);
+            ClearBackground(BLANK);
+            DrawElements();
+        EndRenderTarget();
+        cache_valid = true;
+    }
+    // Render textures are stored upside down
+    DrawTextureRec(cache.texture, Rectangle{0, 0, (float)width, -(float)height}, Vector2{0, 0}, WHITE);
+}
+
+void UIContainer::DrawElements() const
+{
+    // Elements at MAX_DRAW_ORDER have never been drawn by containers, keep it that way
+    render_queue.Rebuild(elements.begin(), elements.end(), [](const OwnedPtr<UIElement> &element) { return element.object; }, MAX_DRAW_ORDER - 1);
+    // The queue is sorted by draw order, so numbering the elements in it's order keeps elements sharing a draw order stacked too
+    int sequence = 0;
+    sprite_batch.Begin();
+    for (UIElement *element : render_queue.Items())
+    {
+        if (element->GetDisplayState())
+        {
+            sprite_batch.SetLayer(sequence++);
+            element->Draw();
         }
     }
+    sprite_batch.End();
 }
 
 void UIContainer::EnableAll()
 {
     for (auto &element : elements)
     {
-        element.second->Enable();
+        element->Enable();
     }
 }
 
@@ -145,7 +454,7 @@ void UIContainer::DisableAll()
 {
     for (auto &element : elements)
     {
-        element.second->Disable();
+        element->Disable();
     }
 }
 
@@ -153,33 +462,131 @@ void UIContainer::SetAllVisibilityTo(bool value)
 {
     for (auto &element : elements)
     {
-        element.second->SetDisplayState(value);
+        element->SetDisplayState(value);
     }
 }
 
 void Button::InitButton()
 {
-    hover = false;
-    press = false;
+    hover   = false;
+    press   = false;
+    release = false;
     callbackFunction = DefaultCallback;
-    TextureSetup();
+    outline_size     = DEFAULT_OUTLINE_SIZE;
+    UpdateHitbox();
+}
+
+void Button::UpdateHitbox()
+{
+    // The hitbox covers the original texture, not the padding added for the outline
+    const Texture2D &tex = texture.Get();
+    float width  = (tex.width  - TEXTURE_PADDING * 2) * transform.scale;
+    float height = (tex.height - TEXTURE_PADDING * 2) * transform.scale;
+    hitbox = Rectangle{transform.position.x - width / 2, transform.position.y - height / 2, width, height};
 }
 
-void Button::TextureSetup()
+Image Button::PadImage(Image img)
 {
-    hitbox = Rectangle{transform.position.x - (texture.width * transform.scale) / 2, transform.position.y - (texture.height * transform.scale) / 2, (float)texture.width * transform.scale, (float)texture.height * transform.scale};
-    Image img = LoadImageFromTexture(texture);
-    ImageResizeCanvas(&img, img.width + 8, img.height + 8, 4, 4, {0, 0, 0, 0});
-    UnloadTexture(texture);
-    texture = LoadTextureFromImage(img);
+    ImageResizeCanvas(&img, img.width + TEXTURE_PADDING * 2, img.height + TEXTURE_PADDING * 2, TEXTURE_PADDING, TEXTURE_PADDING, {0, 0, 0, 0});
+    return img;
+}
+
+Image Button::BuildVariant(Image padded, bool pressed)
+{
+    // Same as `button.fs`: transparent pixels next to an opaque one become the outline, opaque ones are shifted by half the range.
+    // At the default size, the shader's neighbours are exactly one texel away
+    static constexpr unsigned char ALPHA_THRESHOLD = 3; // 0.01 in the shader
+    ImageFormat(&padded, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    Image variant = ImageCopy(padded);
+    const Color *src = (const Color*)padded.data;
+    Color       *dst = (Color*)variant.data;
+    const int shift = pressed ? -128 : 128;
+    auto tint = [shift](unsigned char value) { return (unsigned char)std::max(0, std::min(255, value + shift)); };
+    for (int y = 0; y < padded.height; y++)
+    {
+        for (int x = 0; x < padded.width; x++)
+        {
+            Color pixel = src[y * padded.width + x];
+            if (pixel.a >= ALPHA_THRESHOLD)
+            {
+                dst[y * padded.width + x] = Color{tint(pixel.r), tint(pixel.g), tint(pixel.b), pixel.a};
+                continue;
+            }
+            bool outline = false;
+            for (int ny = std::max(0, y - 1); ny <= std::min(padded.height - 1, y + 1) && !outline; ny++)
+            {
+                for (int nx = std::max(0, x - 1); nx <= std::min(padded.width - 1, x + 1) && !outline; nx++)
+                {
+                    outline = src[ny * padded.width + nx].a >= ALPHA_THRESHOLD;
+                }
+            }
+            dst[y * padded.width + x] = outline ? WHITE : BLANK;
+        }
+    }
+    UnloadImage(padded);
+    return variant;
+}
+
+std::string Button::GetTexturePath() const
+{
+    // Only buttons sharing a texture file through the resource cache know where their texture comes from
+    static const std::string SUFFIX = "#button";
+    const std::string &key = texture.GetKey();
+    if (key.size() <= SUFFIX.size() || key.compare(key.size() - SUFFIX.size(), SUFFIX.size(), SUFFIX) != 0)
+        return "";
+    return key.substr(0, key.size() - SUFFIX.size());
+}
+
+void Button::BuildVariants()
+{
+    std::string path = GetTexturePath();
+    if (!path.empty())
+    {
+        // Shared by every button of the same file, and rebuilt after the padded texture when it is hot reloaded
+        TextureHandle base = texture;
+        hover_texture = resources.AcquireTexture(texture.GetKey() + "_hover", [base]() {
+            return BuildVariant(LoadImageFromTexture(base.Get()), false);
+        }, path);
+        press_texture = resources.AcquireTexture(texture.GetKey() + "_pressed", [base]() {
+            return BuildVariant(LoadImageFromTexture(base.Get()), true);
+        }, path);
+    }
+    else
+    {
+        // Both variants come from a single read back of the padded texture
+        Image padded = LoadImageFromTexture(texture.Get());
+        Image hover_img = BuildVariant(ImageCopy(padded), false);
+        Image press_img = BuildVariant(padded, true);
+        hover_texture = resources.AdoptTexture(LoadTextureFromImage(hover_img));
+        press_texture = resources.AdoptTexture(LoadTextureFromImage(press_img));
+        UnloadImage(hover_img);
+        UnloadImage(press_img);
+    }
+}
+
+void Button::TextureSetup(Texture2D _texture)
+{
+    Image img = PadImage(LoadImageFromTexture(_texture));
+    UnloadTexture(_texture);
+    texture = resources.AdoptTexture(LoadTextureFromImage(img));
     UnloadImage(img);
 }
 
 // Button methods
 Button::Button(Texture2D _texture, Transform2D _transform)
 {
-    texture   = _texture;
     transform = _transform;
+    TextureSetup(_texture);
+    InitButton();
+}
+
+Button::Button(const std::string &texture_path, Transform2D _transform)
+{
+    transform = _transform;
+    // Padded variants are cached too, so buttons sharing an icon never redo the padding
+    texture   = resources.AcquireTexture(texture_path + "#button", [texture_path]() {
+        return PadImage(LoadImage((TEXTURES_PATH / texture_path).string().c_str()));
+    }, texture_path);
     InitButton();
 }
 
@@ -188,7 +595,7 @@ bool Button::IsPressed() const {
 }
 
 bool Button::IsReleased() const {
-    return press && !IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+    return release;
 }
 
 bool Button::IsHover() const {
@@ -200,67 +607,127 @@ void Button::DefineOnPressCallback(std::function<void()> callback)
     callbackFunction = callback;
 }
 
-void Button::Update() {
-    if (enabled)
-    {
-        Vector2 mousePos = GetMousePosition();
+void Button::SetOutlineSize(float thickness)
+{
+    outline_size = thickness;
+    MarkDirty();
+}
 
-        hover = CheckCollisionPointRec(mousePos, hitbox);
-        
-        if (press && !IsMouseButtonDown(MOUSE_BUTTON_LEFT)){
-            callbackFunction();
+float Button::GetOutlineSize() const
+{
+    return outline_size;
+}
+
+void Button::SetVariantCaching(bool enabled)
+{
+    variant_caching = enabled;
+}
+
+bool Button::GetBounds(Rectangle &bounds) const {
+    bounds = hitbox;
+    return true;
+}
+
+void Button::OnPointerEvent(PointerEvent event) {
+    switch (event)
+    {
+        case PointerEvent::ENTER:
+            hover = true;
+            break;
+        case PointerEvent::LEAVE:
+            hover = false;
             press = false;
-        }
-        if (hover && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+            break;
+        case PointerEvent::PRESS:
             press = true;
-        }
-        else if (!hover){
-            press = false;
-        }
+            break;
+        case PointerEvent::RELEASE:
+            if (!press) return;
+            press   = false;
+            release = true;
+            MarkDirty();
+            callbackFunction(); // Last, the callback may remove the button
+            return;
     }
+    MarkDirty();
 }
 
-void Button::Draw() const {
-    Vector2 drawPos = {transform.position.x - (texture.width * transform.scale) / 2, transform.position.y - (texture.height * transform.scale) / 2};
+Vector2 Button::GetLayoutSize() const {
+    const Texture2D &tex = texture.Get();
+    return Vector2{(tex.width - TEXTURE_PADDING * 2) * transform.scale, (tex.height - TEXTURE_PADDING * 2) * transform.scale};
+}
 
-    // Set all shader values before entering shader mode
-    ConfigButtonShader(IsHover(), transform.scale * 0.75);
+void Button::Place(Rectangle rect) {
+    transform.position = Vector2{rect.x + rect.width / 2, rect.y + rect.height / 2};
+    MarkDirty();
+}
 
-    Vector2 texSize = {(float)texture.width * transform.scale, (float)texture.height * transform.scale};
-    int texSizeLoc = GetShaderLocation(button_shader, "texSize");
-    SetShaderValue(button_shader, texSizeLoc, &texSize, SHADER_UNIFORM_VEC2);
+void Button::CollectTextures(TextureSet &textures) const {
+    textures.Add(texture.Get());
+    textures.Add(hover_texture.Get());
+    textures.Add(press_texture.Get());
+}
 
-    // Color modulation
-    float np = !IsPressed();
-    Vector4 colorMod = {
-        np, np, np, 1
-    };
-    int colorModLoc = GetShaderLocation(button_shader, "tintCol");
-    SetShaderValue(button_shader, colorModLoc, &colorMod, SHADER_UNIFORM_VEC4);
+bool Button::Save(SceneRecord &record) const {
+    std::string path = GetTexturePath();
+    if (path.empty())
+        return false;
+    record.type     = "UI::Button";
+    record.resource = path;
+    return true;
+}
+
+void Button::Update() {
+    // The transform may have changed since the hitbox was computed
+    if (dirty)
+        UpdateHitbox();
+    // Built here rather than in `Draw()`, so the read back and upload never stall a frame being drawn
+    if (hover && variant_caching && !hover_texture.IsValid())
+        BuildVariants();
+    release = false;
+}
+
+void Button::Draw() const {
+    const Texture2D &tex = texture.Get();
+    Vector2 drawPos = {transform.position.x - (tex.width * transform.scale) / 2, transform.position.y - (tex.height * transform.scale) / 2};
+
+    // Cached variants are plain sprites, which keep the batch going
+    if (hover && variant_caching && outline_size == DEFAULT_OUTLINE_SIZE && hover_texture.IsValid()) {
+        const Texture2D &variant = (IsPressed() ? press_texture : hover_texture).Get();
+        DrawSprite(variant, Rectangle{0, 0, (float)variant.width, (float)variant.height}, Rectangle{drawPos.x, drawPos.y, variant.width * transform.scale, variant.height * transform.scale}, Vector2{0, 0}, transform.rotation, WHITE);
+    }
+    // Otherwise, if hovered, use shader mode
+    else if (hover) {
+        sprite_batch.Flush();
+
+        // Color modulation
+        float np = !IsPressed();
+        Vector2 texSize  = {(float)tex.width * transform.scale, (float)tex.height * transform.scale};
+        Vector4 colorMod = {np, np, np, 1};
+        ConfigButtonShader(true, transform.scale * outline_size, texSize, colorMod);
 
-    // If hovered, use shader mode
-    if (hover) {
         BeginShaderMode(button_shader);
-        DrawTextureEx(texture, drawPos, transform.rotation, transform.scale, WHITE);
+        DrawTextureEx(tex, drawPos, transform.rotation, transform.scale, WHITE);
         EndShaderMode();
     }
     else {
         // Normal state, no shader applied
-        DrawTextureEx(texture, drawPos, transform.rotation, transform.scale, WHITE);
+        DrawSprite(tex, Rectangle{0, 0, (float)tex.width, (float)tex.height}, Rectangle{drawPos.x, drawPos.y, tex.width * transform.scale, tex.height * transform.scale}, Vector2{0, 0}, transform.rotation, WHITE);
     }
 }
 
-Panel::Panel(Transform2D _transform, Vector2 _dimensions, Color _col, Color _edge_col, unsigned int _edge_thickness) : col(_col), edge_col(_edge_col), dimensions(_dimensions), edge_thickness(_edge_thickness)
+Panel::Panel(Transform2D _transform, Vector2 _dimensions, Color _col, Color _edge_col, unsigned int _edge_thickness) : col(_col), edge_col(_edge_col), dimensions(_dimensions), size(_dimensions), edge_thickness(_edge_thickness)
 {
     transform = _transform;
 }
 
 void Panel::Draw() const
 {
-    DrawRectangle(transform.position.x, transform.position.y, dimensions.x, dimensions.y, col);
+    sprite_batch.Flush();
+    DrawRectangle(transform.position.x, transform.position.y, size.x, size.y, col);
     if (edge_thickness)
     {
-        DrawRectangleLinesEx(Rectangle{transform.position.x, transform.position.y, dimensions.x, dimensions.y}, edge_thickness, edge_col);
+        DrawRectangleLinesEx(Rectangle{transform.position.x, transform.position.y, size.x, size.y}, edge_thickness, edge_col);
     }
 }
 
@@ -268,13 +735,49 @@ void UI::Panel::Update()
 {
 }
 
-UI::Label::Label(Transform2D _transform, std::string _text, unsigned int _text_size, Color _text_col, ALIGNMENT _alignment) : text_col(_text_col), text(_text), text_size(_text_size), alignment(_alignment)
+Vector2 UI::Panel::GetLayoutSize() const
+{
+    return dimensions;
+}
+
+void UI::Panel::Place(Rectangle rect)
+{
+    transform.position = Vector2{rect.x, rect.y};
+    size               = Vector2{rect.width, rect.height};
+    MarkDirty();
+}
+
+bool UI::Panel::GetBounds(Rectangle &bounds) const
+{
+    bounds = Rectangle{transform.position.x, transform.position.y, size.x, size.y};
+    return true;
+}
+
+bool UI::Panel::Save(SceneRecord &record) const
+{
+    record.type = "UI::Panel";
+    record.Write(dimensions);
+    record.Write(col);
+    record.Write(edge_col);
+    record.Write((uint32_t)edge_thickness);
+    return true;
+}
+
+UI::Label::Label(Transform2D _transform, std::string _text, unsigned int _text_size, Color _text_col, ALIGNMENT _alignment) : text_col(_text_col), text(_text), text_size(_text_size), alignment(_alignment),
+                                                                                                                             origin{}, layout_valid(false)
 {
     transform = _transform;
 }
 
+void UI::Label::InvalidateLayout()
+{
+    layout_valid = false;
+    MarkDirty();
+}
+
 std::string &UI::Label::GetText()
 {
+    InvalidateLayout();
     return text;
 }
 
@@ -286,6 +789,7 @@ const std::string &UI::Label::GetText() const
 void UI::Label::SetText(std::string _text)
 {
     text = _text;
+    InvalidateLayout();
 }
 
 unsigned int UI::Label::GetFontSize() const
@@ -296,6 +800,7 @@ unsigned int UI::Label::GetFontSize() const
 void UI::Label::SetFontSize(unsigned int _size)
 {
     text_size = _size;
+    InvalidateLayout();
 }
 
 UI::Label::ALIGNMENT UI::Label::GetAlignment() const
@@ -306,6 +811,7 @@ UI::Label::ALIGNMENT UI::Label::GetAlignment() const
 void UI::Label::SetAlignment(ALIGNMENT _alignment)
 {
     alignment = _alignment;
+    InvalidateLayout();
 }
 
 Color UI::Label::GetTextColor() const
@@ -316,51 +822,150 @@ Color UI::Label::GetTextColor() const
 void UI::Label::SetTextColor(Color color)
 {
     text_col = color;
+    MarkDirty();
+}
+
+const FontHandle &UI::Label::GetFont() const
+{
+    return font;
+}
+
+void UI::Label::SetFont(FontHandle _font)
+{
+    font = std::move(_font);
+    InvalidateLayout();
 }
 
 void UI::Label::Draw() const
 {
+    const FontAsset &asset = font.IsValid() ? font.Get() : fonts.GetDefault();
     float spacing = 1;
-    Vector2 origin = MeasureTextEx(GetFontDefault(), text.c_str(), text_size, spacing);
-    origin.y = origin.y / 2;
+    if (!layout_valid)
+    {
+        origin = fonts.Layout(asset, text, text_size, spacing, glyphs);
+        origin.y = origin.y / 2;
+        switch (alignment)
+        {
+            case ALIGNMENT::LEFT:
+                origin.x = 0;
+                break;
+            case ALIGNMENT::RIGHT:
+                origin.x = origin.x;
+                break;
+            default: // case ALIGNMENT::MIDDLE:
+                origin.x = origin.x / 2;
+                break;
+        }
+        layout_valid = true;
+    }
+    fonts.Submit(asset, glyphs, transform.position, origin, transform.rotation, text_col);
+}
+
+Vector2 UI::Label::GetLayoutSize() const
+{
+    const FontAsset &asset = font.IsValid() ? font.Get() : fonts.GetDefault();
+    return fonts.Measure(asset, text, text_size, 1);
+}
+
+void UI::Label::Place(Rectangle rect)
+{
+    // Same reference point as `Draw()`: the vertical center, at the aligned edge
     switch (alignment)
     {
         case ALIGNMENT::LEFT:
-            origin.x = 0;
+            transform.position.x = rect.x;
             break;
         case ALIGNMENT::RIGHT:
-            origin.x = origin.x;
+            transform.position.x = rect.x + rect.width;
             break;
         default: // case ALIGNMENT::MIDDLE:
-            origin.x = origin.x / 2;
+            transform.position.x = rect.x + rect.width / 2;
             break;
     }
-    DrawTextPro(GetFontDefault(), text.c_str(), transform.position, origin, transform.rotation, text_size, spacing, text_col);
+    transform.position.y = rect.y + rect.height / 2;
+    MarkDirty();
 }
 
 
-UI::ImageDisplay::ImageDisplay(Texture2D texture, Transform2D _transform, Vector2 _origin) : image(texture), origin(_origin)
+UI::ImageDisplay::ImageDisplay(Texture2D texture, Transform2D _transform, Vector2 _origin) : image(resources.AdoptTexture(texture)), origin(_origin)
 {
     transform = _transform;
 }
 
-UI::ImageDisplay::~ImageDisplay()
+UI::ImageDisplay::ImageDisplay(const std::string &texture_path, Transform2D _transform, Vector2 _origin) : image(resources.AcquireTexture(texture_path)), origin(_origin)
 {
-    UnloadTexture(image);
+    transform = _transform;
 }
 
 void UI::ImageDisplay::CenterImage()
 {
-    origin = {image.width / 2.0f, image.height / 2.0f};
+    origin = {image.Get().width / 2.0f, image.Get().height / 2.0f};
+    MarkDirty();
 }
 
 void UI::ImageDisplay::Update()
 {
-    sr = Rectangle{0, 0, (float)image.width, (float)image.height};
-    dr = Rectangle{transform.position.x, transform.position.y, image.width * transform.scale, image.height * transform.scale};
+    const Texture2D &texture = image.Get();
+    sr = Rectangle{0, 0, (float)texture.width, (float)texture.height};
+    dr = Rectangle{transform.position.x, transform.position.y, texture.width * transform.scale, texture.height * transform.scale};
 }
 
 void UI::ImageDisplay::Draw() const
 {
-    DrawTexturePro(image, sr, dr, origin, transform.rotation, WHITE);
+    DrawSprite(image.Get(), sr, dr, origin, transform.rotation, WHITE);
+}
+
+Vector2 UI::ImageDisplay::GetLayoutSize() const
+{
+    const Texture2D &texture = image.Get();
+    return Vector2{texture.width * transform.scale, texture.height * transform.scale};
+}
+
+void UI::ImageDisplay::Place(Rectangle rect)
+{
+    transform.position = Vector2{rect.x + origin.x, rect.y + origin.y};
+    MarkDirty();
+}
+
+bool UI::ImageDisplay::GetBounds(Rectangle &bounds) const
+{
+    const Texture2D &texture = image.Get();
+    bounds = Rectangle{transform.position.x - origin.x, transform.position.y - origin.y, texture.width * transform.scale, texture.height * transform.scale};
+    return true;
+}
+
+void UI::ImageDisplay::CollectTextures(TextureSet &textures) const
+{
+    textures.Add(image.Get());
+}
+
+bool UI::ImageDisplay::Save(SceneRecord &record) const
+{
+    // Adopted textures have no file to be loaded back from
+    const std::string &key = image.GetKey();
+    if (key.empty() || key[0] == '#')
+        return false;
+    record.type     = "UI::ImageDisplay";
+    record.resource = key;
+    record.Write(origin);
+    return true;
+}
+
+
+template <>
+void UI::VariableDisplay<Profiler>::Update()
+{
+    text = "section: min / avg / p99 (ms)";
+    char line[128];
+    for (const ProfileStats &stats : variable->GetStats())
+    {
+        std::snprintf(line, sizeof(line), "\n%s: %.2f / %.2f / %.2f", stats.name.c_str(), stats.min_ms, stats.avg_ms, stats.p99_ms);
+        text += line;
+    }
+    if (variable->GetDroppedCount() > 0)
+        text += "\ndropped samples: " + std::to_string(variable->GetDroppedCount());
+    std::snprintf(line, sizeof(line), "\nheap objects: %zu (%.1f KiB)\ntextures: %zu (%.1f MiB)", GameObject::GetHeapCount(),
+                  GameObject::GetHeapBytes() / 1024.0, resources.GetTextureCount(), resources.GetTextureBytes() / (1024.0 * 1024.0));
+    text += line;
+    InvalidateLayout();
 }
@@ -0,0 +1,91 @@
+#include "assetLoader.hxx"
+#include <algorithm>
+#include <chrono>
+#include "profiler.hxx"
+
+AssetLoader asset_loader;
+
+AssetLoader::AssetLoader() : in_flight(0), stopping(false)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    for (auto &request : decoded)
+    {
+        if (IsImageValid(request.image)) UnloadImage(request.image);
+    }
+}
+
+void AssetLoader::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [this] { return stopping || !queued.empty(); });
+        if (stopping) return;
+
+        Request request = std::move(queued.front());
+        queued.pop_front();
+        in_flight++;
+
+        lock.unlock();
+        {
+            PROFILE_SCOPE("AssetLoader::Decode");
+            request.image = LoadImage(request.path.c_str());
+        }
+        lock.lock();
+
+        in_flight--;
+        decoded.push_back(std::move(request));
+    }
+}
+
+void AssetLoader::QueueImage(const std::string &path, std::function<void(Image)> on_loaded)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (workers.empty())
+        {
+            unsigned int count = std::max(1u, std::thread::hardware_concurrency() / 2);
+            for (unsigned int i = 0; i < count; i++)
+            {
+                workers.emplace_back(&AssetLoader::WorkerLoop, this);
+            }
+        }
+        queued.push_back(Request{path, std::move(on_loaded), Image{}});
+    }
+    wake.notify_one();
+}
+
+void AssetLoader::ProcessUploads(double budget_ms)
+{
+    auto start  = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<double, std::milli>(budget_ms);
+    do
+    {
+        Request request;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decoded.empty()) return;
+            request = std::move(decoded.front());
+            decoded.pop_front();
+        }
+        request.on_loaded(request.image);
+    } while (std::chrono::steady_clock::now() - start < budget);
+}
+
+size_t AssetLoader::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued.size() + in_flight + decoded.size();
+}
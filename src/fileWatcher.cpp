@@ -0,0 +1,87 @@
+#include "fileWatcher.hxx"
+#include <algorithm>
+
+FileWatcher::FileWatcher() : interval(500), stopping(false)
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+void FileWatcher::Start(const std::filesystem::path &_root, int interval_ms)
+{
+    Stop();
+    root     = _root;
+    interval = std::chrono::milliseconds(std::max(1, interval_ms));
+    stopping = false;
+    times.clear();
+    Scan(false); // Baseline, so existing files are not reported
+    thread = std::thread(&FileWatcher::ThreadLoop, this);
+}
+
+void FileWatcher::Stop()
+{
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+    std::lock_guard<std::mutex> lock(mutex);
+    changed.clear();
+}
+
+bool FileWatcher::IsRunning() const
+{
+    return thread.joinable();
+}
+
+void FileWatcher::Scan(bool record)
+{
+    // Files may disappear or be locked mid-scan, errors only skip the entry
+    std::error_code error;
+    std::vector<std::string> found;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+        if (!it->is_regular_file(error)) continue;
+        std::filesystem::file_time_type time = it->last_write_time(error);
+        if (error)
+        {
+            error.clear();
+            continue;
+        }
+
+        std::string path = it->path().lexically_relative(root).generic_string();
+        auto known = times.find(path);
+        if (known != times.end() && known->second == time) continue;
+        times[path] = time;
+        if (record) found.push_back(std::move(path));
+    }
+
+    if (found.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    changed.insert(found.begin(), found.end());
+}
+
+void FileWatcher::ThreadLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, interval, [this] { return stopping; }))
+    {
+        lock.unlock();
+        Scan(true);
+        lock.lock();
+    }
+}
+
+bool FileWatcher::Poll(std::vector<std::string> &paths)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (changed.empty()) return false;
+    paths.insert(paths.end(), changed.begin(), changed.end());
+    changed.clear();
+    return true;
+}
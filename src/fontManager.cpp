@@ -0,0 +1,120 @@
+#include "fontManager.hxx"
+#include "spriteBatch.hxx"
+#include <algorithm>
+
+FontManager fonts;
+
+/**
+ * Walks @p text like raylib's `DrawTextEx()`, calling @p emit with the index and top left corner of every visible glyph.
+ * Returns the size of the text.
+ */
+template <typename Emit>
+static Vector2 WalkText(const Font &font, const std::string &text, float size, float spacing, Emit &&emit)
+{
+    float scale = font.baseSize > 0 ? size / font.baseSize : 1.0f;
+    float x = 0, y = 0, width = 0;
+    bool  line_empty = true;
+    int   lines = 1;
+
+    const char *c   = text.c_str();
+    const char *end = c + text.size();
+    while (c < end)
+    {
+        int bytes = 0;
+        int codepoint = GetCodepointNext(c, &bytes);
+        c += std::max(bytes, 1);
+
+        if (codepoint == '\n')
+        {
+            if (!line_empty) width = std::max(width, x - spacing);
+            x = 0;
+            y += size + FontManager::LINE_SPACING;
+            line_empty = true;
+            lines++;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        if (codepoint != ' ' && codepoint != '\t')
+            emit(index, x, y, scale);
+        float advance = font.glyphs[index].advanceX != 0 ? font.glyphs[index].advanceX : font.recs[index].width;
+        x += advance * scale + spacing;
+        line_empty = false;
+    }
+    if (!line_empty) width = std::max(width, x - spacing);
+    return Vector2{width, lines * size + (lines - 1) * FontManager::LINE_SPACING};
+}
+
+FontHandle FontManager::Acquire(const std::string &path, int base_size)
+{
+    return resources.AcquireFont(path, base_size, true);
+}
+
+FontHandle FontManager::AcquireBitmap(const std::string &path, int size)
+{
+    return resources.AcquireFont(path, size, false);
+}
+
+const FontAsset &FontManager::GetDefault() const
+{
+    // Refreshed on every call, as raylib reloads it's default font along with the window
+    static FontAsset asset{};
+    asset = FontAsset{GetFontDefault(), false};
+    return asset;
+}
+
+Vector2 FontManager::Layout(const FontAsset &font, const std::string &text, float size, float spacing, std::vector<GlyphQuad> &quads) const
+{
+    quads.clear();
+    const Font &f = font.font;
+    if (f.glyphCount == 0) return Vector2{0, 0};
+
+    float padding = (float)f.glyphPadding;
+    return WalkText(f, text, size, spacing, [&](int index, float x, float y, float scale) {
+        const Rectangle &rec = f.recs[index];
+        const GlyphInfo &glyph = f.glyphs[index];
+        quads.push_back(GlyphQuad{
+            Rectangle{rec.x - padding, rec.y - padding, rec.width + 2 * padding, rec.height + 2 * padding},
+            Rectangle{x + (glyph.offsetX - padding) * scale, y + (glyph.offsetY - padding) * scale,
+                      (rec.width + 2 * padding) * scale, (rec.height + 2 * padding) * scale}
+        });
+    });
+}
+
+Vector2 FontManager::Measure(const FontAsset &font, const std::string &text, float size, float spacing) const
+{
+    if (font.font.glyphCount == 0) return Vector2{0, 0};
+    return WalkText(font.font, text, size, spacing, [](int, float, float, float) {});
+}
+
+void FontManager::Submit(const FontAsset &font, const std::vector<GlyphQuad> &quads, Vector2 position, Vector2 origin, float rotation, Color tint)
+{
+    if (quads.empty()) return;
+
+    bool standalone = !sprite_batch.IsActive();
+    if (standalone) sprite_batch.Begin();
+    Shader previous = sprite_batch.GetShader();
+    if (font.sdf)
+    {
+        if (!sdf_shader.IsValid())
+            sdf_shader = resources.AcquireShader("", "sdf.fs");
+        sprite_batch.SetShader(sdf_shader.Get());
+    }
+
+    // Every glyph is rotated around the text's origin, not it's own
+    for (const GlyphQuad &quad : quads)
+    {
+        sprite_batch.Draw(font.font.texture, quad.source, Rectangle{position.x, position.y, quad.dest.width, quad.dest.height},
+                          Vector2{origin.x - quad.dest.x, origin.y - quad.dest.y}, rotation, tint);
+    }
+
+    sprite_batch.SetShader(previous);
+    if (standalone) sprite_batch.End();
+}
+
+void FontManager::Draw(const FontAsset &font, const std::string &text, Vector2 position, Vector2 origin, float rotation, float size, float spacing, Color tint)
+{
+    static std::vector<GlyphQuad> quads; // Reused between calls to avoid allocating every frame
+    Layout(font, text, size, spacing, quads);
+    Submit(font, quads, position, origin, rotation, tint);
+}
@@ -0,0 +1,39 @@
+#include "frameClock.hxx"
+
+FrameClock frame_clock;
+
+FrameClock::FrameClock() : time(0), delta(0), steps(0), alpha(1)
+{
+}
+
+void FrameClock::Advance(double dt)
+{
+    time  += dt;
+    delta  = dt;
+    steps++;
+}
+
+void FrameClock::SetAlpha(float _alpha)
+{
+    alpha = _alpha;
+}
+
+double FrameClock::GetTime() const
+{
+    return time;
+}
+
+double FrameClock::GetDelta() const
+{
+    return delta;
+}
+
+uint64_t FrameClock::GetStep() const
+{
+    return steps;
+}
+
+float FrameClock::GetAlpha() const
+{
+    return alpha;
+}
@@ -1,4 +1,12 @@
 #include "gameObject.hxx"
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// Every allocation starts with a header holding it's size, padded so the object keeps the default alignment
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+static std::atomic<size_t> heap_count(0);
+static std::atomic<size_t> heap_bytes(0);
 
 GameObject::GameObject(Transform2D _transform) : transform(_transform)
 {
@@ -13,3 +21,38 @@ const Transform2D &GameObject::GetTransform() const
 {
     return transform;
 }
+
+void *GameObject::operator new(size_t size)
+{
+    char *block = static_cast<char*>(::operator new(size + HEADER_SIZE));
+    *reinterpret_cast<size_t*>(block) = size;
+    heap_count.fetch_add(1, std::memory_order_relaxed);
+    heap_bytes.fetch_add(size + HEADER_SIZE, std::memory_order_relaxed);
+    return block + HEADER_SIZE;
+}
+
+void GameObject::operator delete(void *pointer) noexcept
+{
+    if (!pointer) return;
+    char *block = static_cast<char*>(pointer) - HEADER_SIZE;
+    heap_count.fetch_sub(1, std::memory_order_relaxed);
+    heap_bytes.fetch_sub(*reinterpret_cast<size_t*>(block) + HEADER_SIZE, std::memory_order_relaxed);
+    ::operator delete(block);
+}
+
+size_t GameObject::GetHeapCount()
+{
+    return heap_count.load(std::memory_order_relaxed);
+}
+
+size_t GameObject::GetHeapBytes()
+{
+    return heap_bytes.load(std::memory_order_relaxed);
+}
+
+size_t GameObject::GetAllocationSize(const GameObject &object)
+{
+    // The allocation starts at the most derived object, which may not be where it's `GameObject` part is
+    const char *block = static_cast<const char*>(dynamic_cast<const void*>(&object)) - HEADER_SIZE;
+    return *reinterpret_cast<const size_t*>(block) + HEADER_SIZE;
+}
@@ -1,5 +1,6 @@
 #include "globals.hxx"
 #include "scene.hpp"
+#include "resourceManager.hxx"
 
 Camera2D camera = {};
 
@@ -14,34 +15,52 @@ void DefaultCallback()
 }
 
 Shader button_shader = {};
-void InitButtonShader()
+ButtonShaderParams button_shader_params;
+static ShaderHandle button_shader_resource; // Keeps `button_shader` loaded through the resource cache.
+static void BindButtonShader()
 {
-    button_shader = LoadShader(TextFormat("%s/outline.vs", SHADERS_PATH.string().c_str()), TextFormat("%s/outline.fs", SHADERS_PATH.string().c_str()));
-
-    Vector2 texSize = { 64.0f, 64.0f }; // Default (will be updated per texture)
-    int texSizeLoc = GetShaderLocation(button_shader, "texSize");
-    SetShaderValue(button_shader, texSizeLoc, &texSize, SHADER_UNIFORM_VEC2);
+    button_shader = button_shader_resource.Get();
+    button_shader_params.Resolve(button_shader);
 
-    float outlineSize = 2.0f;
-    int outlineSizeLoc = GetShaderLocation(button_shader, "outlineSize");
-    SetShaderValue(button_shader, outlineSizeLoc, &outlineSize, SHADER_UNIFORM_FLOAT);
+    button_shader_params.texSize.Set(button_shader, Vector2{64.0f, 64.0f}); // Default (will be updated per texture)
+    button_shader_params.outlineSize.Set(button_shader, 2.0f);
+    button_shader_params.outlineColor.Set(button_shader, Vector4{1.0f, 1.0f, 1.0f, 1.0f}); // white
+    button_shader_params.tintCol.Set(button_shader, Vector4{1, 1, 1, 0}); // Set shader tint alpha to 0% (aka no tint)
+}
 
-    Vector4 outlineColor = {1.0f, 1.0f, 1.0f, 1.0f}; // white
-    int outlineColorLoc = GetShaderLocation(button_shader, "outlineColor");
-    SetShaderValue(button_shader, outlineColorLoc, &outlineColor, SHADER_UNIFORM_VEC4);
+void InitButtonShader()
+{
+    button_shader_resource = resources.AcquireShader("button.vs", "button.fs");
+    BindButtonShader();
+}
 
-    Vector4 colorMod = {1, 1, 1, 0}; // Set shader tint alpha to 0% (aka no tint)
+void ConfigButtonShader(bool outline, float thickness)
+{
+    // The shader was hot reloaded, uniform locations and values did not survive
+    if (button_shader.id != button_shader_resource.Get().id) BindButtonShader();
+    button_shader_params.hover.Set(button_shader, outline);
+    button_shader_params.outlineSize.Set(button_shader, thickness);
+}
 
-    int colorModLoc = GetShaderLocation(button_shader, "tintCol");
-    SetShaderValue(button_shader, colorModLoc, &colorMod, SHADER_UNIFORM_VEC4);
+void ConfigButtonShader(bool outline, float thickness, Vector2 texSize, Vector4 tint)
+{
+    ConfigButtonShader(outline, thickness);
+    button_shader_params.texSize.Set(button_shader, texSize);
+    button_shader_params.tintCol.Set(button_shader, tint);
 }
 
-void ConfigButtonShader(bool outline, float thickness)
+static std::vector<RenderTexture2D> render_targets; // Targets begun through `BeginRenderTarget()`, innermost last.
+void BeginRenderTarget(RenderTexture2D target)
 {
-    int hover = outline;
-    int hoverLoc = GetShaderLocation(button_shader, "hover");
-    SetShaderValue(button_shader, hoverLoc, &hover, SHADER_UNIFORM_INT);
+    render_targets.push_back(target);
+    BeginTextureMode(target);
+}
 
-    int outlineSizeLoc = GetShaderLocation(button_shader, "outlineSize");
-    SetShaderValue(button_shader, outlineSizeLoc, &thickness, SHADER_UNIFORM_FLOAT);
-}
\ No newline at end of file
+void EndRenderTarget()
+{
+    if (render_targets.empty()) return;
+    render_targets.pop_back();
+    EndTextureMode();
+    if (!render_targets.empty())
+        BeginTextureMode(render_targets.back());
+}
@@ -0,0 +1,37 @@
+#include "inputRouter.hxx"
+
+InputRouter input_router;
+
+InputRouter::InputRouter() : pointer{}, captured(false)
+{
+}
+
+void InputRouter::Sample()
+{
+    pointer.position  = GetMousePosition();
+    pointer.down      = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+    pointer.pressed  |= IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    pointer.released |= IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
+}
+
+void InputRouter::Consume()
+{
+    pointer.pressed  = false;
+    pointer.released = false;
+    captured         = false;
+}
+
+const PointerState &InputRouter::GetPointer() const
+{
+    return pointer;
+}
+
+bool InputRouter::IsCaptured() const
+{
+    return captured;
+}
+
+void InputRouter::Capture()
+{
+    captured = true;
+}
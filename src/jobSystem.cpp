@@ -0,0 +1,140 @@
+#include "jobSystem.hxx"
+#include <algorithm>
+
+JobSystem job_system;
+
+struct JobSystem::Group {
+    const std::function<void(size_t, size_t)> *job; // Loop body.
+    std::atomic<size_t> remaining;                  // Chunks not yet finished.
+    std::mutex          error_mutex;                // Protects `error`.
+    std::exception_ptr  error;                      // First exception thrown by `job`.
+};
+
+// At least one worker, even on single core machines, so loops never depend on the calling thread alone
+JobSystem::JobSystem() : worker_count(std::max(2u, std::thread::hardware_concurrency()) - 1), pending(0), next_queue(0), stopping(false)
+{
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::Start()
+{
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+void JobSystem::Run(const Task &task)
+{
+    try
+    {
+        (*task.group->job)(task.begin, task.end);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(task.group->error_mutex);
+        if (!task.group->error)
+            task.group->error = std::current_exception();
+    }
+    task.group->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool JobSystem::TryRun(size_t first_queue)
+{
+    for (size_t i = 0; i < queues.size(); i++)
+    {
+        Queue &queue = *queues[(first_queue + i) % queues.size()];
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            // Own work is taken from the front, stolen work from the back
+            if (i == 0)
+            {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            else
+            {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+        }
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        Run(task);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+    while (true)
+    {
+        if (TryRun(index)) continue;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+        if (stopping) return;
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunk_size, const std::function<void(size_t, size_t)> &job)
+{
+    if (count == 0) return;
+    chunk_size = std::max<size_t>(1, chunk_size);
+    size_t chunks = (count + chunk_size - 1) / chunk_size;
+    if (chunks == 1)
+    {
+        job(0, count);
+        return;
+    }
+    std::call_once(started, &JobSystem::Start, this);
+
+    Group group;
+    group.job = &job;
+    group.remaining.store(chunks, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.fetch_add(chunks, std::memory_order_relaxed);
+    }
+    size_t first_queue = next_queue.fetch_add(chunks, std::memory_order_relaxed);
+    for (size_t c = 0; c < chunks; c++)
+    {
+        Queue &queue = *queues[(first_queue + c) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(Task{&group, c * chunk_size, std::min(count, (c + 1) * chunk_size)});
+    }
+    wake.notify_all();
+
+    // Help out until every chunk is done, including the ones taken by workers
+    while (group.remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (!TryRun(first_queue))
+            std::this_thread::yield();
+    }
+    if (group.error)
+        std::rethrow_exception(group.error);
+}
+
+size_t JobSystem::GetThreadCount() const
+{
+    return worker_count + 1;
+}
@@ -0,0 +1,101 @@
+#include "mappedFile.hxx"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(nullptr)
+{
+}
+#else
+MappedFile::MappedFile() : data(nullptr), size(0), file(-1)
+{
+}
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path &path) : MappedFile()
+{
+    Open(path);
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::filesystem::path &path)
+{
+    Close();
+    file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        Close();
+        return false;
+    }
+    size = (size_t)file_size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data)                         UnmapViewOfFile(data);
+    if (mapping)                      CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    data    = nullptr;
+    size    = 0;
+    mapping = nullptr;
+    file    = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::Open(const std::filesystem::path &path)
+{
+    Close();
+    file = open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+    void *address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (address == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    data = static_cast<const uint8_t*>(address);
+    size = (size_t)info.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data)      munmap(const_cast<uint8_t*>(data), size);
+    if (file >= 0) close(file);
+    data = nullptr;
+    size = 0;
+    file = -1;
+}
+#endif
@@ -0,0 +1,68 @@
+#include "memoryStats.hxx"
+#include <algorithm>
+
+MemoryStats &MemoryStats::operator+=(const MemoryStats &other)
+{
+    objects         += other.objects;
+    heap_objects    += other.heap_objects;
+    grouped_objects += other.grouped_objects;
+    ui_containers   += other.ui_containers;
+    ui_elements     += other.ui_elements;
+    heap_bytes      += other.heap_bytes;
+    textures        += other.textures;
+    texture_bytes   += other.texture_bytes;
+    return *this;
+}
+
+void TextureSet::Add(Texture2D texture)
+{
+    if (texture.id == 0) return;
+    textures.push_back(texture);
+    sorted = false;
+}
+
+void TextureSet::Normalize() const
+{
+    if (sorted) return;
+    std::sort(textures.begin(), textures.end(), [](const Texture2D &a, const Texture2D &b) { return a.id < b.id; });
+    textures.erase(std::unique(textures.begin(), textures.end(), [](const Texture2D &a, const Texture2D &b) { return a.id == b.id; }),
+                   textures.end());
+    sorted = true;
+}
+
+size_t TextureSet::Count() const
+{
+    Normalize();
+    return textures.size();
+}
+
+size_t TextureSet::Bytes() const
+{
+    Normalize();
+    size_t bytes = 0;
+    for (const Texture2D &texture : textures)
+    {
+        bytes += TextureBytes(texture);
+    }
+    return bytes;
+}
+
+void TextureSet::Clear()
+{
+    textures.clear();
+    sorted = true;
+}
+
+size_t TextureSet::TextureBytes(Texture2D texture)
+{
+    // Every mipmap level is half the size of the previous one, down to a single pixel
+    size_t bytes = 0;
+    int width = texture.width, height = texture.height;
+    for (int level = 0; level < std::max(1, texture.mipmaps); level++)
+    {
+        bytes += GetPixelDataSize(width, height, texture.format);
+        width  = std::max(1, width  / 2);
+        height = std::max(1, height / 2);
+    }
+    return bytes;
+}
@@ -0,0 +1,251 @@
+#include "particleSystem.hxx"
+#include "AnimatedTexture.hxx"
+#include "spriteBatch.hxx"
+#include "frameClock.hxx"
+#include "jobSystem.hxx"
+#include "memoryStats.hxx"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+ParticleSystem::ParticleSystem(const ParticleEmitter &_emitter, size_t max_particles, Transform2D _transform)
+    : GameObject(_transform), emitter(_emitter), capacity(max_particles), count(0), emitting(true), emit_carry(0), bounds{}
+{
+    // Allocated once at the cap, so emitting never reallocates
+    for (std::vector<float> *array : {&position_x, &position_y, &velocity_x, &velocity_y, &rotation, &spin, &age, &lifetime})
+    {
+        array->resize(capacity);
+    }
+}
+
+void ParticleSystem::SetTexture(const TextureHandle &_texture)
+{
+    texture = _texture;
+    atlas.reset();
+    frames.clear();
+}
+
+void ParticleSystem::SetAtlas(std::shared_ptr<TextureAtlas> _atlas, std::vector<Rectangle> regions)
+{
+    texture.Reset();
+    atlas  = std::move(_atlas);
+    frames = std::move(regions);
+}
+
+bool ParticleSystem::SetAnimation(const AnimatedTexture &animation)
+{
+    if (!animation.GetAtlas()) return false;
+    SetAtlas(animation.GetAtlas(), animation.GetRegions());
+    return true;
+}
+
+void ParticleSystem::SetEmitting(bool enabled)
+{
+    emitting   = enabled;
+    emit_carry = 0;
+}
+
+bool ParticleSystem::IsEmitting() const
+{
+    return emitting;
+}
+
+void ParticleSystem::Emit(size_t amount)
+{
+    Spawn(amount);
+}
+
+void ParticleSystem::Clear()
+{
+    count = 0;
+}
+
+ParticleEmitter &ParticleSystem::GetEmitter()
+{
+    return emitter;
+}
+
+const ParticleEmitter &ParticleSystem::GetEmitter() const
+{
+    return emitter;
+}
+
+size_t ParticleSystem::GetCount() const
+{
+    return count;
+}
+
+size_t ParticleSystem::GetCapacity() const
+{
+    return capacity;
+}
+
+float ParticleSystem::RandomRange(float min, float max)
+{
+    return min + (max - min) * std::uniform_real_distribution<float>(0.0f, 1.0f)(random);
+}
+
+void ParticleSystem::Spawn(size_t amount)
+{
+    amount = std::min(amount, capacity - count);
+    for (size_t i = count; i < count + amount; i++)
+    {
+        float angle  = (emitter.direction + RandomRange(-0.5f, 0.5f) * emitter.spread) * DEG2RAD;
+        float speed  = RandomRange(emitter.speed_min, emitter.speed_max);
+        float offset = emitter.spawn_radius * std::sqrt(RandomRange(0, 1)); // Uniform over the disc
+        float around = RandomRange(0, 2 * PI);
+        position_x[i] = transform.position.x + offset * std::cos(around);
+        position_y[i] = transform.position.y + offset * std::sin(around);
+        velocity_x[i] = speed * std::cos(angle);
+        velocity_y[i] = speed * std::sin(angle);
+        rotation[i]   = 0;
+        spin[i]       = RandomRange(emitter.spin_min, emitter.spin_max);
+        age[i]        = 0;
+        lifetime[i]   = std::max(RandomRange(emitter.lifetime_min, emitter.lifetime_max), 1e-4f);
+    }
+    count += amount;
+}
+
+void ParticleSystem::Simulate(size_t begin, size_t end, float dt)
+{
+    // One array at a time, so every loop is a straight line the compiler can vectorize
+    const float damping = std::max(0.0f, 1.0f - emitter.drag * dt);
+    const float gx = emitter.gravity.x * dt, gy = emitter.gravity.y * dt;
+    float *vx = velocity_x.data(), *vy = velocity_y.data(), *x = position_x.data(), *y = position_y.data();
+    float *r  = rotation.data(),   *w  = spin.data(),       *a = age.data();
+    for (size_t i = begin; i < end; i++) vx[i] = (vx[i] + gx) * damping;
+    for (size_t i = begin; i < end; i++) vy[i] = (vy[i] + gy) * damping;
+    for (size_t i = begin; i < end; i++) x[i] += vx[i] * dt;
+    for (size_t i = begin; i < end; i++) y[i] += vy[i] * dt;
+    for (size_t i = begin; i < end; i++) r[i] += w[i] * dt;
+    for (size_t i = begin; i < end; i++) a[i] += dt;
+}
+
+void ParticleSystem::Compact()
+{
+    // Expired particles are replaced by the last live one
+    for (size_t i = 0; i < count;)
+    {
+        if (age[i] >= lifetime[i])
+        {
+            count--;
+            position_x[i] = position_x[count];
+            position_y[i] = position_y[count];
+            velocity_x[i] = velocity_x[count];
+            velocity_y[i] = velocity_y[count];
+            rotation[i]   = rotation[count];
+            spin[i]       = spin[count];
+            age[i]        = age[count];
+            lifetime[i]   = lifetime[count];
+            continue;
+        }
+        i++;
+    }
+}
+
+void ParticleSystem::ComputeBounds()
+{
+    if (count == 0) return;
+    float min_x = position_x[0], min_y = position_y[0], max_x = min_x, max_y = min_y;
+    for (size_t i = 1; i < count; i++)
+    {
+        min_x = std::min(min_x, position_x[i]);
+        max_x = std::max(max_x, position_x[i]);
+        min_y = std::min(min_y, position_y[i]);
+        max_y = std::max(max_y, position_y[i]);
+    }
+
+    // Grown by the largest particle, at any rotation
+    float size = 0;
+    if (frames.empty())
+    {
+        Texture2D sheet = atlas ? atlas->GetTexture() : texture.Get();
+        size = std::max(sheet.width, sheet.height);
+    }
+    for (const Rectangle &frame : frames)
+    {
+        size = std::max(size, std::max(frame.width, frame.height));
+    }
+    float margin = size * std::max(std::fabs(emitter.scale_start), std::fabs(emitter.scale_end)) * 0.7072f;
+    bounds = Rectangle{min_x - margin, min_y - margin, max_x - min_x + margin * 2, max_y - min_y + margin * 2};
+}
+
+void ParticleSystem::Update()
+{
+    float dt = (float)frame_clock.GetDelta();
+    if (count >= PARALLEL_THRESHOLD)
+    {
+        job_system.ParallelFor(count, PARALLEL_CHUNK, [this, dt](size_t begin, size_t end) { Simulate(begin, end, dt); });
+    }
+    else
+    {
+        Simulate(0, count, dt);
+    }
+    Compact();
+
+    if (emitting && emitter.rate > 0)
+    {
+        emit_carry += emitter.rate * dt;
+        size_t amount = (size_t)emit_carry;
+        emit_carry -= amount;
+        // Emission is dropped, not deferred, while the cap is reached
+        if (count + amount > capacity) emit_carry = 0;
+        Spawn(amount);
+    }
+    ComputeBounds();
+}
+
+void ParticleSystem::Draw() const
+{
+    if (count == 0) return;
+    Texture2D sheet = atlas ? atlas->GetTexture() : texture.Get();
+    if (sheet.id == 0) return;
+
+    // Everything batched so far goes below the particles
+    if (sprite_batch.IsActive()) sprite_batch.Flush();
+
+    const Rectangle whole       = {0, 0, (float)sheet.width, (float)sheet.height};
+    const size_t    frame_count = frames.empty() ? 1 : frames.size();
+    rlSetTexture(sheet.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        float t = age[i] / lifetime[i];
+        size_t frame_index = emitter.frame_rate > 0 ? (size_t)(age[i] * emitter.frame_rate) % frame_count
+                                                    : std::min(frame_count - 1, (size_t)(t * frame_count));
+        const Rectangle &source = frames.empty() ? whole : frames[frame_index];
+
+        float scale = emitter.scale_start + (emitter.scale_end - emitter.scale_start) * t;
+        float hw    = source.width  * scale * 0.5f;
+        float hh    = source.height * scale * 0.5f;
+        float c     = std::cos(rotation[i] * DEG2RAD), s = std::sin(rotation[i] * DEG2RAD);
+        float x     = position_x[i], y = position_y[i];
+
+        float u0 = source.x / sheet.width,  u1 = (source.x + source.width)  / sheet.width;
+        float v0 = source.y / sheet.height, v1 = (source.y + source.height) / sheet.height;
+        rlColor4ub((unsigned char)(emitter.color_start.r + (emitter.color_end.r - emitter.color_start.r) * t),
+                   (unsigned char)(emitter.color_start.g + (emitter.color_end.g - emitter.color_start.g) * t),
+                   (unsigned char)(emitter.color_start.b + (emitter.color_end.b - emitter.color_start.b) * t),
+                   (unsigned char)(emitter.color_start.a + (emitter.color_end.a - emitter.color_start.a) * t));
+        // Same corner order as `SpriteBatch::Flush()`: top-left, bottom-left, bottom-right, top-right
+        rlTexCoord2f(u0, v0); rlVertex2f(x + (-hw * c + hh * s), y + (-hw * s - hh * c));
+        rlTexCoord2f(u0, v1); rlVertex2f(x + (-hw * c - hh * s), y + (-hw * s + hh * c));
+        rlTexCoord2f(u1, v1); rlVertex2f(x + ( hw * c - hh * s), y + ( hw * s + hh * c));
+        rlTexCoord2f(u1, v0); rlVertex2f(x + ( hw * c + hh * s), y + ( hw * s - hh * c));
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+bool ParticleSystem::GetBounds(Rectangle &_bounds) const
+{
+    if (count == 0) return false;
+    _bounds = bounds;
+    return true;
+}
+
+void ParticleSystem::CollectTextures(TextureSet &textures) const
+{
+    textures.Add(atlas ? atlas->GetTexture() : texture.Get());
+}
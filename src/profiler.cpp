@@ -0,0 +1,148 @@
+#include "profiler.hxx"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+Profiler profiler;
+
+static uint32_t CurrentThreadIndex()
+{
+    static std::atomic<uint32_t> thread_count(0);
+    thread_local uint32_t index = thread_count.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+Profiler::Profiler() : enabled(true), dropped(0), epoch(std::chrono::steady_clock::now()), last_frame_ns(0), capturing(false)
+{
+}
+
+void Profiler::SetEnabled(bool _enabled)
+{
+    enabled.store(_enabled, std::memory_order_relaxed);
+}
+
+void Profiler::Record(const char *name, int64_t start_ns, int64_t duration_ns)
+{
+    if (!samples.Push(ProfileSample{name, start_ns, duration_ns, CurrentThreadIndex()}))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char *Profiler::Intern(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(names_mutex);
+    return names.insert(name).first->c_str();
+}
+
+Profiler::Section &Profiler::FindSection(const char *name)
+{
+    auto it = lookup.find(name);
+    if (it != lookup.end())
+        return *it->second;
+
+    // Different pointers may hold the same name (e.g. the same literal in two translation units)
+    Section &section = sections.emplace(name, Section{}).first->second;
+    lookup.emplace(name, &section);
+    return section;
+}
+
+void Profiler::EndFrame()
+{
+    int64_t now = Now();
+    if (last_frame_ns != 0 && IsEnabled())
+        Record("Frame", last_frame_ns, now - last_frame_ns);
+    last_frame_ns = now;
+
+    ProfileSample sample;
+    while (samples.Pop(sample))
+    {
+        Section &section = FindSection(sample.name);
+        section.frame_ns += sample.duration_ns;
+        section.hit = true;
+        if (capturing && capture.size() < MAX_CAPTURE)
+            capture.push_back(sample);
+    }
+
+    for (auto &entry : sections)
+    {
+        Section &section = entry.second;
+        if (!section.hit) continue;
+        section.history[section.next] = section.frame_ns / 1e6f;
+        section.next  = (section.next + 1) % HISTORY;
+        section.count = std::min(section.count + 1, HISTORY);
+        section.frame_ns = 0;
+        section.hit      = false;
+    }
+}
+
+std::vector<ProfileStats> Profiler::GetStats() const
+{
+    std::vector<ProfileStats> stats;
+    stats.reserve(sections.size());
+    float values[HISTORY];
+    for (auto &entry : sections)
+    {
+        const Section &section = entry.second;
+        if (section.count == 0) continue;
+
+        std::copy(section.history, section.history + section.count, values);
+        float total = 0;
+        for (size_t i = 0; i < section.count; i++)
+        {
+            total += values[i];
+        }
+        size_t p99 = (size_t)std::ceil(section.count * 0.99) - 1;
+        std::nth_element(values, values + p99, values + section.count);
+        float p99_ms = values[p99];
+        float min_ms = *std::min_element(values, values + section.count);
+        stats.push_back(ProfileStats{entry.first, min_ms, total / section.count, p99_ms});
+    }
+    return stats;
+}
+
+void Profiler::BeginCapture()
+{
+    capture.clear();
+    capturing = true;
+}
+
+static void WriteJsonString(std::ofstream &file, const char *text)
+{
+    file << '"';
+    for (const char *c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')   file << '\\' << *c;
+        else if ((unsigned char)*c < 0x20) file << ' ';
+        else                           file << *c;
+    }
+    file << '"';
+}
+
+bool Profiler::EndCapture(const std::filesystem::path &path)
+{
+    capturing = false;
+    std::ofstream file(path);
+    if (!file)
+    {
+        TraceLog(LOG_WARNING, "PROFILER: Could not write trace file %s", path.string().c_str());
+        return false;
+    }
+
+    // Chrome trace event format, with timestamps in microseconds
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < capture.size(); i++)
+    {
+        const ProfileSample &sample = capture[i];
+        if (i > 0) file << ',';
+        file << "\n{\"name\":";
+        WriteJsonString(file, sample.name);
+        file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << sample.thread
+             << ",\"ts\":"  << sample.start_ns / 1000.0
+             << ",\"dur\":" << sample.duration_ns / 1000.0 << '}';
+    }
+    file << "\n]}\n";
+    capture.clear();
+    capture.shrink_to_fit();
+    return (bool)file;
+}
@@ -0,0 +1,343 @@
+#include "resourceManager.hxx"
+#include "assetLoader.hxx"
+#include "memoryStats.hxx"
+#include <algorithm>
+#include "rlgl.h"
+
+ResourceManager resources;
+
+ResourceManager::ResourceManager() : adopted_count(0), reload_count(0)
+{
+}
+
+ResourceManager::~ResourceManager()
+{
+    for (auto &texture : textures)
+    {
+        texture.second->owner = nullptr;
+    }
+    for (auto &shader : shaders)
+    {
+        shader.second->owner = nullptr;
+    }
+    for (auto &font : fonts)
+    {
+        font.second->owner = nullptr;
+    }
+}
+
+void ResourceManager::Release(ResourceEntry<Texture2D> *entry)
+{
+    // Handles may outlive the window when they are stored in globals
+    if (IsWindowReady())
+        UnloadTexture(entry->resource);
+    // The build function may hold handles to other textures, which must not be released while `derived` is being modified
+    Derived dropped;
+    auto it = derived.find(entry->key);
+    if (it != derived.end())
+    {
+        dropped = std::move(it->second);
+        derived.erase(it);
+    }
+    textures.erase(entry->key);
+    delete entry;
+}
+
+void ResourceManager::Release(ResourceEntry<Shader> *entry)
+{
+    if (IsWindowReady())
+        UnloadShader(entry->resource);
+    shaders.erase(entry->key);
+    delete entry;
+}
+
+void ResourceManager::Release(ResourceEntry<FontAsset> *entry)
+{
+    // Fonts that failed to load share raylib's default font, which is not ours to unload
+    if (IsWindowReady() && entry->resource.font.texture.id != GetFontDefault().texture.id)
+        UnloadFont(entry->resource.font);
+    fonts.erase(entry->key);
+    delete entry;
+}
+
+TextureHandle ResourceManager::AcquireTexture(const std::string &path)
+{
+    auto it = textures.find(path);
+    if (it != textures.end())
+    {
+        // A pending asynchronous load is finished right away, the decoded image will be discarded
+        if (!it->second->loaded)
+        {
+            it->second->resource = LoadTexture((TEXTURES_PATH / path).string().c_str());
+            it->second->loaded   = true;
+        }
+        return TextureHandle(it->second);
+    }
+
+    Texture2D texture = LoadTexture((TEXTURES_PATH / path).string().c_str());
+    auto entry = new ResourceEntry<Texture2D>{texture, 0, path, true, this};
+    textures.emplace(path, entry);
+    return TextureHandle(entry);
+}
+
+TextureHandle ResourceManager::AcquireTexture(const std::string &key, const std::function<Image()> &build, const std::string &source)
+{
+    auto it = textures.find(key);
+    if (it != textures.end())
+        return TextureHandle(it->second);
+
+    if (!source.empty())
+        derived[key] = Derived{source, build};
+
+    Image image = build();
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    auto entry = new ResourceEntry<Texture2D>{texture, 0, key, true, this};
+    textures.emplace(key, entry);
+    return TextureHandle(entry);
+}
+
+TextureHandle ResourceManager::AcquireTextureAsync(const std::string &path)
+{
+    auto it = textures.find(path);
+    if (it != textures.end())
+        return TextureHandle(it->second);
+
+    auto entry = new ResourceEntry<Texture2D>{Texture2D{}, 0, path, false, this};
+    textures.emplace(path, entry);
+    asset_loader.QueueImage((TEXTURES_PATH / path).string(), [this, path](Image image) {
+        // The entry may have been released, or loaded synchronously, while the image was being decoded
+        auto it = textures.find(path);
+        if (it != textures.end() && !it->second->loaded)
+        {
+            if (IsImageValid(image))
+                it->second->resource = LoadTextureFromImage(image);
+            it->second->loaded = true;
+        }
+        if (IsImageValid(image))
+            UnloadImage(image);
+    });
+    return TextureHandle(entry);
+}
+
+TextureHandle ResourceManager::AdoptTexture(Texture2D texture)
+{
+    // Adopted textures get a key no file path can match, so they are never shared
+    std::string key = "#adopted" + std::to_string(adopted_count++);
+    auto entry = new ResourceEntry<Texture2D>{texture, 0, key, true, this};
+    textures.emplace(key, entry);
+    return TextureHandle(entry);
+}
+
+ShaderHandle ResourceManager::AcquireShader(const std::string &vs_path, const std::string &fs_path)
+{
+    std::string key = vs_path + "|" + fs_path;
+    auto it = shaders.find(key);
+    if (it != shaders.end())
+        return ShaderHandle(it->second);
+
+    std::string vs = vs_path.empty() ? "" : (SHADERS_PATH / vs_path).string();
+    std::string fs = fs_path.empty() ? "" : (SHADERS_PATH / fs_path).string();
+    Shader shader = LoadShader(vs.empty() ? nullptr : vs.c_str(), fs.empty() ? nullptr : fs.c_str());
+    auto entry = new ResourceEntry<Shader>{shader, 0, key, true, this};
+    shaders.emplace(key, entry);
+    return ShaderHandle(entry);
+}
+
+FontHandle ResourceManager::AcquireFont(const std::string &path, int base_size, bool sdf)
+{
+    std::string key = path + "|" + std::to_string(base_size) + (sdf ? "|sdf" : "");
+    auto it = fonts.find(key);
+    if (it != fonts.end())
+        return FontHandle(it->second);
+
+    const int GLYPH_COUNT = 95; // Printable ASCII, from ' ' to '~'
+    std::string file = (FONTS_PATH / path).string();
+    FontAsset asset{Font{}, sdf};
+    if (!sdf)
+    {
+        asset.font = LoadFontEx(file.c_str(), base_size, nullptr, GLYPH_COUNT);
+    }
+    else
+    {
+        int size = 0;
+        unsigned char *data = LoadFileData(file.c_str(), &size);
+        if (data)
+        {
+            asset.font.baseSize   = base_size;
+            asset.font.glyphCount = GLYPH_COUNT;
+            asset.font.glyphs     = LoadFontData(data, size, base_size, nullptr, GLYPH_COUNT, FONT_SDF);
+            if (asset.font.glyphs)
+            {
+                Image atlas = GenImageFontAtlas(asset.font.glyphs, &asset.font.recs, GLYPH_COUNT, base_size, 0, 1);
+                asset.font.texture = LoadTextureFromImage(atlas);
+                UnloadImage(atlas);
+                // Distance fields must be interpolated to be reconstructed at other sizes
+                SetTextureFilter(asset.font.texture, TEXTURE_FILTER_BILINEAR);
+            }
+            UnloadFileData(data);
+        }
+    }
+    if (asset.font.texture.id == 0)
+    {
+        TraceLog(LOG_WARNING, "RESOURCES: Could not load font %s, using the default font instead", file.c_str());
+        if (asset.font.glyphs) UnloadFontData(asset.font.glyphs, asset.font.glyphCount);
+        if (asset.font.recs)   MemFree(asset.font.recs);
+        asset = FontAsset{GetFontDefault(), false};
+    }
+
+    auto entry = new ResourceEntry<FontAsset>{asset, 0, key, true, this};
+    fonts.emplace(key, entry);
+    return FontHandle(entry);
+}
+
+void ResourceManager::SetHotReload(bool enabled, int interval_ms)
+{
+    if (enabled) watcher.Start(RESOURCES_PATH, interval_ms);
+    else         watcher.Stop();
+}
+
+bool ResourceManager::IsHotReloading() const
+{
+    return watcher.IsRunning();
+}
+
+bool ResourceManager::ReloadTexture(ResourceEntry<Texture2D> *entry, Image image)
+{
+    if (!IsImageValid(image)) return false;
+
+    Texture2D &texture = entry->resource;
+    // Same size and format: overwrite the pixels, so copies of the `Texture2D` held anywhere stay valid
+    if (texture.id != 0 && texture.width == image.width && texture.height == image.height && texture.format == image.format
+        && texture.mipmaps == 1 && image.mipmaps == 1)
+    {
+        UpdateTexture(texture, image.data);
+    }
+    else
+    {
+        Texture2D reloaded = LoadTextureFromImage(image);
+        if (reloaded.id == 0) return false;
+        if (texture.id != 0) UnloadTexture(texture);
+        texture = reloaded;
+    }
+    UnloadImage(image);
+    return true;
+}
+
+bool ResourceManager::ReloadShader(ResourceEntry<Shader> *entry)
+{
+    size_t separator = entry->key.find('|');
+    std::string vs_path = entry->key.substr(0, separator);
+    std::string fs_path = entry->key.substr(separator + 1);
+    std::string vs = vs_path.empty() ? "" : (SHADERS_PATH / vs_path).string();
+    std::string fs = fs_path.empty() ? "" : (SHADERS_PATH / fs_path).string();
+
+    // raylib falls back to it's default shader when compilation fails, keep the working one instead
+    Shader shader = LoadShader(vs.empty() ? nullptr : vs.c_str(), fs.empty() ? nullptr : fs.c_str());
+    if (shader.id == 0 || shader.id == rlGetShaderIdDefault())
+    {
+        TraceLog(LOG_WARNING, "RESOURCES: Could not reload shader %s, keeping the previous version", entry->key.c_str());
+        return false;
+    }
+    UnloadShader(entry->resource);
+    entry->resource = shader;
+    return true;
+}
+
+size_t ResourceManager::ProcessReloads()
+{
+    if (!watcher.IsRunning()) return 0;
+    reload_paths.clear();
+    if (!watcher.Poll(reload_paths)) return 0;
+
+    const std::string textures_dir = TEXTURES_PATH.lexically_relative(RESOURCES_PATH).generic_string() + "/";
+    const std::string shaders_dir  = SHADERS_PATH.lexically_relative(RESOURCES_PATH).generic_string() + "/";
+    size_t reloaded = 0;
+    for (const std::string &changed : reload_paths)
+    {
+        if (changed.compare(0, textures_dir.size(), textures_dir) == 0)
+        {
+            std::string path = changed.substr(textures_dir.size());
+            auto it = textures.find(path);
+            // Pending asynchronous loads will pick up the new file on their own
+            if (it != textures.end() && it->second->loaded)
+            {
+                Image image = LoadImage((TEXTURES_PATH / path).string().c_str());
+                if (ReloadTexture(it->second, image)) reloaded++;
+                else if (IsImageValid(image))         UnloadImage(image);
+            }
+            for (auto &entry : derived)
+            {
+                if (entry.second.source != path) continue;
+                Image image = entry.second.build();
+                if (ReloadTexture(textures.at(entry.first), image)) reloaded++;
+                else if (IsImageValid(image))                       UnloadImage(image);
+            }
+        }
+        else if (changed.compare(0, shaders_dir.size(), shaders_dir) == 0)
+        {
+            std::string path = changed.substr(shaders_dir.size());
+            for (auto &entry : shaders)
+            {
+                size_t separator = entry.first.find('|');
+                if (entry.first.compare(0, separator, path) == 0 || entry.first.compare(separator + 1, std::string::npos, path) == 0)
+                {
+                    if (ReloadShader(entry.second)) reloaded++;
+                }
+            }
+        }
+    }
+    if (reloaded > 0)
+    {
+        reload_count++;
+        TraceLog(LOG_INFO, "RESOURCES: Hot reloaded %zu resources", reloaded);
+    }
+    return reloaded;
+}
+
+size_t ResourceManager::GetReloadCount() const
+{
+    return reload_count;
+}
+
+size_t ResourceManager::GetTextureCount() const
+{
+    return textures.size();
+}
+
+size_t ResourceManager::GetTextureBytes() const
+{
+    size_t bytes = 0;
+    for (const auto &texture : textures)
+    {
+        if (texture.second->loaded) bytes += TextureSet::TextureBytes(texture.second->resource);
+    }
+    return bytes;
+}
+
+std::vector<TextureUsage> ResourceManager::GetTextureUsage() const
+{
+    std::vector<TextureUsage> usage;
+    usage.reserve(textures.size());
+    for (const auto &texture : textures)
+    {
+        const ResourceEntry<Texture2D> &entry = *texture.second;
+        if (!entry.loaded) continue;
+        usage.push_back(TextureUsage{entry.key, entry.resource.width, entry.resource.height, TextureSet::TextureBytes(entry.resource),
+                                     entry.references});
+    }
+    std::sort(usage.begin(), usage.end(), [](const TextureUsage &a, const TextureUsage &b) {
+        return a.bytes != b.bytes ? a.bytes > b.bytes : a.key < b.key;
+    });
+    return usage;
+}
+
+size_t ResourceManager::GetShaderCount() const
+{
+    return shaders.size();
+}
+
+size_t ResourceManager::GetFontCount() const
+{
+    return fonts.size();
+}
@@ -1,112 +1,753 @@
 #include "scene.hpp"
+#include "spriteBatch.hxx"
+#include "assetLoader.hxx"
+#include "AnimatedTexture.hxx"
+#include "profiler.hxx"
+#include "jobSystem.hxx"
+#include "frameClock.hxx"
+#include "inputRouter.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 
-Scene::Scene()
+// Resize a render target, keeping it if it already matches
+static void FitRenderTarget(RenderTexture2D &target, int width, int height)
+{
+    if (target.id != 0 && target.texture.width == width && target.texture.height == height) return;
+    if (target.id != 0) UnloadRenderTexture(target);
+    target = LoadRenderTexture(width, height);
+}
+
+Scene::Scene() : preload_started(false), parallel_update(false), parallel_chunk_size(64), unbounded_dirty(false), culling(true), changed_layers(0), groups_changed(false), clear_color(BLACK)
 {
 }
 
 Scene::~Scene()
 {
+    if (IsWindowReady())
+        ReleaseLayers();
     for (auto &ui : interfaces)
     {
         delete ui.second;
     }
     for (auto &obj : objects)
     {
-        delete obj.second;
+        obj.Finalize();
     }
 }
 
 void Scene::AddUi(const std::string &id, UIContainer *_ui)
 {
-    interfaces.emplace(id, _ui);
+    StringId key(id);
+    if (interface_ids.Find(key)) return;
+
+    interface_ids.Insert(key, interfaces.emplace(id, _ui).first);
+    _ui->owner_queue = &ui_queue;
+    _ui->profile_update_name = profiler.Intern("UIContainer::Update [" + id + "]");
+    _ui->profile_draw_name   = profiler.Intern("UIContainer::Draw [" + id + "]");
+    ui_queue.Invalidate();
 }
 
 void Scene::RemoveUI(const std::string &id)
 {
-    delete interfaces[id];
-    interfaces.erase(id);
+    RemoveUI(StringId(id));
 }
 
-void Scene::AddObject(const std::string &id, GameObject *_object)
+void Scene::RemoveUI(StringId id)
 {
-    objects.emplace(id, _object);
+    auto *entry = interface_ids.Find(id);
+    if (!entry) return;
+    delete (*entry)->second;
+    interfaces.erase(*entry);
+    interface_ids.Erase(id);
+    ui_queue.Invalidate();
+}
+
+Scene::ObjectHandle Scene::AddObject(const std::string &id, GameObject *_object)
+{
+    if (object_ids.Find(StringId(id)).IsValid())
+        return ObjectHandle{};
+
+    ObjectHandle handle = AddObject(_object);
+    object_ids.Bind(id, handle);
+    return handle;
+}
+
+Scene::ObjectHandle Scene::AddObject(GameObject *_object)
+{
+    ObjectHandle handle = objects.Insert(OwnedPtr<GameObject>{_object, nullptr});
+    TrackObject(handle);
+    return handle;
 }
 
 void Scene::RemoveObject(const std::string &id)
 {
-    delete objects[id];
-    objects.erase(id);
+    RemoveObject(StringId(id));
+}
+
+void Scene::RemoveObject(StringId id)
+{
+    RemoveObject(object_ids.Find(id));
+}
+
+void Scene::RemoveObject(ObjectHandle handle)
+{
+    OwnedPtr<GameObject> *obj = objects.Get(handle);
+    if (!obj) return;
+
+    obj->Destroy();
+    // Objects are drawn in dense order, so the ones after the removed object keep their stacking
+    size_t dense     = objects.DenseIndex(handle);
+    bool   unbounded = spatial_index.IsUnbounded(handle);
+    objects.EraseOrdered(handle);
+    spatial_index.Remove(handle);
+    changed_layers |= object_layers[handle.index];
+    uint32_t &position = bounded_positions[handle.index];
+    if (position != SlotHandle::INVALID_INDEX)
+    {
+        bounded_positions[bounded_objects.back().index] = position;
+        bounded_objects[position] = bounded_objects.back();
+        bounded_objects.pop_back();
+        position = SlotHandle::INVALID_INDEX;
+    }
+    // Every later object moved one position back, which keeps `unbounded_order` sorted
+    if (!unbounded_dirty)
+    {
+        auto later = std::lower_bound(unbounded_order.begin(), unbounded_order.end(), dense);
+        if (unbounded && later != unbounded_order.end() && *later == dense)
+            later = unbounded_order.erase(later);
+        for (; later != unbounded_order.end(); ++later) (*later)--;
+    }
+    object_ids.Unbind(handle);
 }
 
 GameObject &Scene::GetObject(const std::string &id)
 {
-    auto it = objects.find(id);
-    if (it != objects.end())
-        return *it->second;
-    else
-        ThrowNotFoundException(id);
+    return GetObject(StringId(id));
 }
 
 const GameObject &Scene::GetObject(const std::string &id) const
 {
-    auto it = objects.find(id);
-    if (it != objects.end())
-        return *it->second;
-    else
+    return GetObject(StringId(id));
+}
+
+GameObject &Scene::GetObject(StringId id)
+{
+    OwnedPtr<GameObject> *obj = objects.Get(object_ids.Find(id));
+    if (!obj)
         ThrowNotFoundException(id);
+    return *obj->object;
 }
 
-UIContainer &Scene::GetUI(const std::string &id)
+const GameObject &Scene::GetObject(StringId id) const
 {
-    auto it = interfaces.find(id);
-    if (it != interfaces.end())
-        return *it->second;
-    else
+    const OwnedPtr<GameObject> *obj = objects.Get(object_ids.Find(id));
+    if (!obj)
         ThrowNotFoundException(id);
+    return *obj->object;
+}
+
+GameObject &Scene::GetObject(ObjectHandle handle)
+{
+    OwnedPtr<GameObject> *obj = objects.Get(handle);
+    if (!obj)
+        ThrowNotFoundException("#" + std::to_string(handle.index));
+    return *obj->object;
+}
+
+const GameObject &Scene::GetObject(ObjectHandle handle) const
+{
+    const OwnedPtr<GameObject> *obj = objects.Get(handle);
+    if (!obj)
+        ThrowNotFoundException("#" + std::to_string(handle.index));
+    return *obj->object;
+}
+
+Scene::ObjectHandle Scene::GetObjectHandle(const std::string &id) const
+{
+    return GetObjectHandle(StringId(id));
+}
+
+Scene::ObjectHandle Scene::GetObjectHandle(StringId id) const
+{
+    return object_ids.Find(id);
+}
+
+UIContainer &Scene::GetUI(const std::string &id)
+{
+    return GetUI(StringId(id));
 }
 
 const UIContainer &Scene::GetUI(const std::string &id) const
 {
-    auto it = interfaces.find(id);
-    if (it != interfaces.end())
-        return *it->second;
-    else
+    return GetUI(StringId(id));
+}
+
+UIContainer &Scene::GetUI(StringId id)
+{
+    auto *entry = interface_ids.Find(id);
+    if (!entry)
         ThrowNotFoundException(id);
+    return *(*entry)->second;
+}
+
+const UIContainer &Scene::GetUI(StringId id) const
+{
+    auto *entry = interface_ids.Find(id);
+    if (!entry)
+        ThrowNotFoundException(id);
+    return *(*entry)->second;
+}
+
+void Scene::TrackObject(ObjectHandle handle)
+{
+    if (handle.index >= object_layers.size())
+        object_layers.resize(handle.index + 1, 0);
+    object_layers[handle.index] = 1;
+    if (handle.index >= object_transforms.size())
+        object_transforms.resize(handle.index + 1);
+    object_transforms[handle.index] = TransformStore::Handle{};
+    IndexObject(handle, *objects.Get(handle)->object);
+}
+
+void Scene::IndexObject(ObjectHandle handle, const GameObject &object)
+{
+    Rectangle bounds;
+    TransformStore::Handle entry = object_transforms[handle.index];
+    if (entry.IsValid() && transforms.Contains(entry))
+    {
+        bounds = transforms.GetBounds(entry);
+        IndexBounds(handle, &bounds);
+        return;
+    }
+    IndexBounds(handle, object.GetBounds(bounds) ? &bounds : nullptr);
+}
+
+void Scene::IndexBounds(ObjectHandle handle, const Rectangle *bounds)
+{
+    if (handle.index >= bounded_positions.size())
+        bounded_positions.resize(handle.index + 1, SlotHandle::INVALID_INDEX);
+    uint32_t &position = bounded_positions[handle.index];
+    bool      was_new  = !spatial_index.Contains(handle);
+
+    bool changed = bounds ? spatial_index.Set(handle, *bounds) : spatial_index.SetUnbounded(handle);
+    if (changed) changed_layers |= object_layers[handle.index];
+
+    if (bounds && position == SlotHandle::INVALID_INDEX)
+    {
+        position = (uint32_t)bounded_objects.size();
+        bounded_objects.push_back(handle);
+        if (!was_new) unbounded_dirty = true;
+    }
+    else if (!bounds && position != SlotHandle::INVALID_INDEX)
+    {
+        bounded_positions[bounded_objects.back().index] = position;
+        bounded_objects[position] = bounded_objects.back();
+        bounded_objects.pop_back();
+        position = SlotHandle::INVALID_INDEX;
+        unbounded_dirty = true;
+    }
+    else if (!bounds && was_new && !unbounded_dirty)
+    {
+        // New objects go last in dense order, so the list stays sorted
+        unbounded_order.push_back(objects.DenseIndex(handle));
+    }
+}
+
+void Scene::RefreshSpatialIndex()
+{
+    // Backwards, since objects losing their bounds are swapped out of the list
+    for (size_t i = bounded_objects.size(); i-- > 0;)
+    {
+        ObjectHandle handle = bounded_objects[i];
+        IndexObject(handle, *objects.Get(handle)->object);
+    }
+}
+
+void Scene::ReindexObject(ObjectHandle handle)
+{
+    const OwnedPtr<GameObject> *obj = objects.Get(handle);
+    if (obj) IndexObject(handle, *obj->object);
+}
+
+void Scene::QueryRect(Rectangle area, std::vector<ObjectHandle> &result) const
+{
+    spatial_index.QueryRect(area, [&result](SlotHandle handle, const Rectangle &) { result.push_back(handle); });
+    spatial_index.ForEachUnbounded([&](SlotHandle handle) {
+        if (CheckCollisionPointRec(objects.Get(handle)->object->GetTransform().position, area))
+            result.push_back(handle);
+    });
+}
+
+void Scene::QueryRadius(Vector2 center, float radius, std::vector<ObjectHandle> &result) const
+{
+    Rectangle area = {center.x - radius, center.y - radius, radius * 2, radius * 2};
+    spatial_index.QueryRect(area, [&](SlotHandle handle, const Rectangle &bounds) {
+        if (CheckCollisionCircleRec(center, radius, bounds))
+            result.push_back(handle);
+    });
+    spatial_index.ForEachUnbounded([&](SlotHandle handle) {
+        Vector2 position = objects.Get(handle)->object->GetTransform().position;
+        float dx = position.x - center.x, dy = position.y - center.y;
+        if (dx * dx + dy * dy <= radius * radius)
+            result.push_back(handle);
+    });
+}
+
+void Scene::SetCulling(bool enabled)
+{
+    culling = enabled;
+}
+
+bool Scene::IsCulling() const
+{
+    return culling;
+}
+
+void Scene::RegisterPreload(const std::string &texture_path)
+{
+    preload_paths.push_back(texture_path);
+}
+
+void Scene::RegisterPreload(AnimatedTexture *animation)
+{
+    preload_animations.push_back(animation);
+}
+
+void Scene::Preload()
+{
+    if (preload_started) return;
+    preload_started = true;
+    for (auto &path : preload_paths)
+    {
+        preloaded.push_back(resources.AcquireTextureAsync(path));
+    }
+    for (AnimatedTexture *animation : preload_animations)
+    {
+        if (!animation->IsInitialized())
+            animation->InitializeAsync();
+    }
+}
+
+float Scene::GetPreloadProgress() const
+{
+    size_t total = preload_paths.size() + preload_animations.size();
+    if (total == 0) return 1.0f;
+
+    size_t ready = 0;
+    for (auto &texture : preloaded)
+    {
+        if (texture.IsReady()) ready++;
+    }
+    for (AnimatedTexture *animation : preload_animations)
+    {
+        if (animation->IsInitialized()) ready++;
+    }
+    return (float)ready / total;
 }
 
 void Scene::Draw() const
 {
     BeginDrawing();
-        ClearBackground(BLACK);
-        BeginMode2D(camera);
-            for (auto &obj : objects)
+    {
+        // Ends before EndDrawing(), which waits for vsync
+        PROFILE_SCOPE("Scene::Draw");
+        Render();
+    }
+    EndDrawing();
+}
+
+void Scene::Render() const
+{
+    ClearBackground(clear_color);
+    if (layers.empty())
+    {
+        DrawWorld(camera, Rectangle{0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()}, RenderLayer::ALL_OBJECTS, true);
+    }
+    else
+    {
+        for (const Layer &layer : layers)
+        {
+            if ((changed_layers & layer.settings.mask) || (groups_changed && layer.settings.draw_groups))
+                layer.dirty = true;
+            DrawLayer(layer);
+        }
+    }
+    changed_layers = 0;
+    groups_changed = false;
+    ui_queue.Rebuild(interfaces.begin(), interfaces.end(), [](const auto &ui) { return ui.second; });
+    for (UIContainer *ui : ui_queue.Items())
+    {
+        ui->Draw();
+    }
+}
+
+void Scene::DrawWorld(const Camera2D &view_camera, Rectangle view, uint32_t mask, bool draw_groups) const
+{
+    // Every object is in some layer when drawing without layers, so the per-object test can be skipped
+    bool all_objects = mask == RenderLayer::ALL_OBJECTS;
+    // Objects may overlap, so each one gets it's own batch layer and only quads of a single object are grouped by texture. Groups get
+    // one layer each, in draw order, so their instances are still batched together
+    int  sequence    = 0;
+    BeginMode2D(view_camera);
+        sprite_batch.Begin();
+        group_queue.Rebuild(groups.begin(), groups.end(), [](const auto &group) { return group.second.get(); });
+        const std::vector<ObjectGroupBase*> &sorted_groups = group_queue.Items();
+        // Groups with a negative draw order go below the objects
+        auto first_above = draw_groups ? std::find_if(sorted_groups.begin(), sorted_groups.end(),
+                                                      [](const ObjectGroupBase *group) { return group->GetDrawOrder() >= 0; })
+                                       : sorted_groups.begin();
+        auto last_above  = draw_groups ? sorted_groups.end() : sorted_groups.begin();
+        for (auto it = sorted_groups.begin(); it != first_above; ++it)
+        {
+            sprite_batch.SetLayer(sequence++);
+            (*it)->DrawAll();
+        }
+        auto draw = [&](size_t index) {
+            const GameObject &obj = *objects.begin()[index].object;
+            PROFILE_SCOPE(obj.GetProfileName());
+            sprite_batch.SetLayer(sequence++);
+            obj.Draw();
+        };
+        // Without bounded objects there is nothing to cull, and everything is drawn in a single linear pass
+        if (culling && view_camera.zoom != 0 && spatial_index.UnboundedCount() < objects.Size())
+        {
+            // World space bounding box of the view, which also covers rotated cameras
+            Vector2 corners[4] = {GetScreenToWorld2D(Vector2{view.x, view.y}, view_camera),
+                                  GetScreenToWorld2D(Vector2{view.x + view.width, view.y}, view_camera),
+                                  GetScreenToWorld2D(Vector2{view.x, view.y + view.height}, view_camera),
+                                  GetScreenToWorld2D(Vector2{view.x + view.width, view.y + view.height}, view_camera)};
+            Vector2 min = corners[0], max = corners[0];
+            for (const Vector2 &corner : corners)
             {
-                obj.second->Draw();
+                min = Vector2{std::min(min.x, corner.x), std::min(min.y, corner.y)};
+                max = Vector2{std::max(max.x, corner.x), std::max(max.y, corner.y)};
             }
-        EndMode2D();
-        for (int i = MIN_DRAW_ORDER; i <= MAX_DRAW_ORDER; i++)
+
+            visible_objects.clear();
+            spatial_index.QueryRect(Rectangle{min.x, min.y, max.x - min.x, max.y - min.y}, [&](SlotHandle handle, const Rectangle &) {
+                if (all_objects || (object_layers[handle.index] & mask))
+                    visible_objects.push_back(objects.DenseIndex(handle));
+            });
+            // Only the visible bounded objects are sorted. Unbounded ones are kept sorted, and merged in to keep the unculled drawing order
+            std::sort(visible_objects.begin(), visible_objects.end());
+            if (unbounded_dirty)
+            {
+                unbounded_order.clear();
+                spatial_index.ForEachUnbounded([this](SlotHandle handle) { unbounded_order.push_back(objects.DenseIndex(handle)); });
+                std::sort(unbounded_order.begin(), unbounded_order.end());
+                unbounded_dirty = false;
+            }
+            auto bounded = visible_objects.begin();
+            for (size_t index : unbounded_order)
+            {
+                if (!all_objects && !(object_layers[objects.HandleAt(index).index] & mask)) continue;
+                for (; bounded != visible_objects.end() && *bounded < index; ++bounded) draw(*bounded);
+                draw(index);
+            }
+            for (; bounded != visible_objects.end(); ++bounded) draw(*bounded);
+        }
+        else
         {
-            for (auto &ui : interfaces)
+            for (size_t i = 0; i < objects.Size(); i++)
             {
-                if (ui.second->GetDrawOrder() == i)
-                {
-                    ui.second->Draw();
-                }
+                if (!all_objects && !(object_layers[objects.HandleAt(i).index] & mask)) continue;
+                draw(i);
             }
         }
-    EndDrawing();
+        for (auto it = first_above; it != last_above; ++it)
+        {
+            sprite_batch.SetLayer(sequence++);
+            (*it)->DrawAll();
+        }
+        sprite_batch.End();
+    EndMode2D();
+}
+
+static bool SameCamera(const Camera2D &a, const Camera2D &b)
+{
+    return a.offset.x == b.offset.x && a.offset.y == b.offset.y && a.target.x == b.target.x && a.target.y == b.target.y
+        && a.rotation == b.rotation && a.zoom == b.zoom;
+}
+
+void Scene::DrawLayer(const Layer &layer) const
+{
+    const RenderLayer &settings = layer.settings;
+    if (!settings.visible) return;
+
+    Rectangle viewport = settings.viewport;
+    if (viewport.width <= 0 || viewport.height <= 0)
+        viewport = Rectangle{0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()};
+
+    if (!settings.cached)
+    {
+        BeginScissorMode((int)viewport.x, (int)viewport.y, (int)viewport.width, (int)viewport.height);
+            if (settings.clear.a > 0) DrawRectangleRec(viewport, settings.clear);
+            DrawWorld(settings.camera, viewport, settings.mask, settings.draw_groups);
+        EndScissorMode();
+        return;
+    }
+
+    int  width   = settings.target_width  > 0 ? settings.target_width  : (int)viewport.width;
+    int  height  = settings.target_height > 0 ? settings.target_height : (int)viewport.height;
+    bool resized = layer.target.id == 0 || layer.target.texture.width != width || layer.target.texture.height != height;
+    if (resized)
+        FitRenderTarget(layer.target, width, height);
+    if (resized || !SameCamera(layer.drawn_camera, settings.camera))
+        layer.dirty = true;
+
+    double now = frame_clock.GetTime();
+    // A resized target holds no picture at all, so it can not wait for the refresh interval
+    if (layer.dirty && (resized || now - layer.drawn_at >= settings.refresh_interval))
+    {
+        BeginRenderTarget(layer.target);
+            ClearBackground(settings.clear);
+            DrawWorld(settings.camera, Rectangle{0, 0, (float)width, (float)height}, settings.mask, settings.draw_groups);
+        EndRenderTarget();
+        layer.drawn_camera = settings.camera;
+        layer.drawn_at     = now;
+        layer.dirty        = false;
+    }
+    // Render textures are stored upside down
+    DrawTexturePro(layer.target.texture, Rectangle{0, 0, (float)width, -(float)height}, viewport, Vector2{0, 0}, 0.0f, WHITE);
+}
+
+size_t Scene::AddLayer(const RenderLayer &layer)
+{
+    layers.push_back(Layer{layer, RenderTexture2D{}, layer.camera, 0.0, true});
+    return layers.size() - 1;
+}
+
+RenderLayer &Scene::GetLayer(size_t index)
+{
+    if (index >= layers.size())
+        ThrowNotFoundException("layer #" + std::to_string(index));
+    layers[index].dirty = true;
+    return layers[index].settings;
+}
+
+const RenderLayer &Scene::GetLayer(size_t index) const
+{
+    if (index >= layers.size())
+        ThrowNotFoundException("layer #" + std::to_string(index));
+    return layers[index].settings;
+}
+
+size_t Scene::GetLayerCount() const
+{
+    return layers.size();
+}
+
+void Scene::InvalidateLayer(size_t index)
+{
+    if (index < layers.size())
+        layers[index].dirty = true;
+}
+
+void Scene::ClearLayers()
+{
+    ReleaseLayers();
+}
+
+void Scene::ReleaseLayers()
+{
+    for (Layer &layer : layers)
+    {
+        if (layer.target.id != 0) UnloadRenderTexture(layer.target);
+    }
+    layers.clear();
+}
+
+void Scene::SetObjectLayers(ObjectHandle handle, uint32_t layers_mask)
+{
+    if (!objects.Get(handle)) return;
+    // Layers the object leaves have to be redrawn without it, and the ones it joins with it
+    changed_layers |= object_layers[handle.index] ^ layers_mask;
+    object_layers[handle.index] = layers_mask;
+}
+
+uint32_t Scene::GetObjectLayers(ObjectHandle handle) const
+{
+    return objects.Get(handle) ? object_layers[handle.index] : 0;
+}
+
+void Scene::SetClearColor(Color color)
+{
+    clear_color = color;
+}
+
+Color Scene::GetClearColor() const
+{
+    return clear_color;
+}
+
+bool Scene::Teardown(double budget_ms)
+{
+    auto start  = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<double, std::milli>(budget_ms);
+
+    while (!interfaces.empty())
+    {
+        auto         first = interfaces.begin();
+        UIContainer *ui    = first->second;
+        // Elements from the back first, so a container holding many of them can span several calls too
+        for (size_t destroyed = 1; ui->elements.Size() > 0; destroyed++)
+        {
+            size_t last = ui->elements.Size() - 1;
+            ui->elements.begin()[last].Finalize();
+            ui->elements.Erase(ui->elements.HandleAt(last));
+            if (destroyed % 64 == 0 && std::chrono::steady_clock::now() - start >= budget) return false;
+        }
+        interface_ids.Erase(StringId(first->first));
+        interfaces.erase(first);
+        ui_queue.Invalidate();
+        delete ui;
+        if (std::chrono::steady_clock::now() - start >= budget) return false;
+    }
+    preloaded.clear();
+    ReleaseLayers();
+    while (!groups.empty())
+    {
+        groups.erase(groups.begin());
+        group_queue.Invalidate();
+        if (std::chrono::steady_clock::now() - start >= budget) return false;
+    }
+    // From the back, so erasing never moves another object. Pooled memory is released along with the scene
+    for (size_t destroyed = 1; objects.Size() > 0; destroyed++)
+    {
+        size_t last = objects.Size() - 1;
+        objects.begin()[last].Finalize();
+        objects.Erase(objects.HandleAt(last));
+        if (destroyed % 64 == 0 && std::chrono::steady_clock::now() - start >= budget)
+            return objects.Size() == 0;
+    }
+    return true;
+}
+
+void Scene::SetParallelUpdate(bool enabled, size_t chunk_size)
+{
+    parallel_update     = enabled;
+    parallel_chunk_size = chunk_size;
+}
+
+TransformStore &Scene::GetTransforms()
+{
+    return transforms;
+}
+
+const TransformStore &Scene::GetTransforms() const
+{
+    return transforms;
+}
+
+void Scene::BindTransform(ObjectHandle handle, TransformStore::Handle entry)
+{
+    const OwnedPtr<GameObject> *obj = objects.Get(handle);
+    if (!obj) return;
+    object_transforms[handle.index] = entry;
+    IndexObject(handle, *obj->object);
+}
+
+TransformStore::Handle Scene::GetBoundTransform(ObjectHandle handle) const
+{
+    return objects.Contains(handle) ? object_transforms[handle.index] : TransformStore::Handle{};
+}
+
+void Scene::AccumulateMemory(MemoryStats &stats, TextureSet &textures) const
+{
+    stats.objects    += objects.Size();
+    stats.heap_bytes += object_pools.ReservedBytes() + objects.ReservedBytes() + spatial_index.ReservedBytes() + transforms.ReservedBytes()
+                      + parallel_objects.capacity() * sizeof(GameObject*) + visible_objects.capacity() * sizeof(size_t)
+                      + bounded_objects.capacity() * sizeof(ObjectHandle) + bounded_positions.capacity() * sizeof(uint32_t)
+                      + unbounded_order.capacity() * sizeof(size_t) + object_transforms.capacity() * sizeof(TransformStore::Handle);
+    for (const OwnedPtr<GameObject> &object : objects)
+    {
+        // Pooled objects are already counted by their pool's blocks
+        if (!object.pool)
+        {
+            stats.heap_objects++;
+            stats.heap_bytes += GameObject::GetAllocationSize(*object.object);
+        }
+        object->CollectTextures(textures);
+    }
+    for (const auto &group : groups)
+    {
+        stats.grouped_objects += group.second->Size();
+        stats.heap_bytes      += group.second->ReservedBytes();
+    }
+    for (const auto &ui : interfaces)
+    {
+        ui.second->AccumulateMemory(stats, textures);
+    }
+    for (const TextureHandle &texture : preloaded)
+    {
+        textures.Add(texture.Get());
+    }
+    for (const Layer &layer : layers)
+    {
+        textures.Add(layer.target.texture);
+    }
+    stats.heap_bytes += layers.capacity() * sizeof(Layer) + object_layers.capacity() * sizeof(uint32_t);
+}
+
+MemoryStats Scene::GetMemoryStats() const
+{
+    MemoryStats stats;
+    TextureSet  textures;
+    AccumulateMemory(stats, textures);
+    stats.textures      = textures.Count();
+    stats.texture_bytes = textures.Bytes();
+    return stats;
+}
+
+bool Scene::IsParallelUpdate() const
+{
+    return parallel_update;
 }
 
 void Scene::Update()
 {
+    PROFILE_SCOPE("Scene::Update");
+    if (parallel_update)
+    {
+        parallel_objects.clear();
+        for (auto &obj : objects)
+        {
+            if (obj->IsThreadSafe())
+                parallel_objects.push_back(obj.object);
+        }
+        job_system.ParallelFor(parallel_objects.size(), parallel_chunk_size, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                PROFILE_SCOPE(parallel_objects[i]->GetProfileName());
+                parallel_objects[i]->Update();
+            }
+        });
+    }
     for (auto &obj : objects)
     {
-        obj.second->Update();
+        if (parallel_update && obj->IsThreadSafe()) continue;
+        PROFILE_SCOPE(obj->GetProfileName());
+        obj->Update();
     }
-    for (auto &ui : interfaces)
+    for (auto &group : groups)
+    {
+        group.second->UpdateAll();
+    }
+    groups_changed = groups_changed || !groups.empty();
+    {
+        PROFILE_SCOPE("TransformStore::Update");
+        transforms.Update();
+    }
+    RefreshSpatialIndex();
+    // Topmost containers first, so they capture the pointer before the ones drawn below them
+    ui_queue.Rebuild(interfaces.begin(), interfaces.end(), [](const auto &ui) { return ui.second; });
+    const std::vector<UIContainer*> &containers = ui_queue.Items();
+    for (auto it = containers.rbegin(); it != containers.rend(); ++it)
     {
-        ui.second->Update();
+        (*it)->Update();
     }
 }
 
@@ -115,46 +756,214 @@ void Scene::Update()
 // === SCENE MANAGER SHENANIGANS ===
 // =================================
 
-SceneManager::SceneManager()
+SceneManager::SceneManager() : upload_budget_ms(4.0), fixed_step(1.0 / 60), accumulator(0), max_steps_per_tick(8),
+                               outgoing(nullptr), transition_type(TransitionType::CUT), transition_duration(0), transition_elapsed(0),
+                               outgoing_captured(false), outgoing_target{}, incoming_target{}, teardown_budget_ms(2.0), reaper_stopping(false)
 {
-    scenes.emplace("scene_default", new Scene());
+    AddScene("scene_default", new Scene());
     activeScene = scenes["scene_default"];
 }
 
 SceneManager::~SceneManager()
 {
+    {
+        std::lock_guard<std::mutex> lock(reaper_mutex);
+        reaper_stopping = true;
+    }
+    reaper_wake.notify_all();
+    if (reaper.joinable()) reaper.join();
+
     for (auto &scene : scenes){
         delete scene.second;
     }
+    for (Scene *scene : retired)
+    {
+        delete scene;
+    }
+    if (IsWindowReady())
+    {
+        if (outgoing_target.id != 0) UnloadRenderTexture(outgoing_target);
+        if (incoming_target.id != 0) UnloadRenderTexture(incoming_target);
+    }
 }
 
 void SceneManager::AddScene(const std::string &scene_id, Scene *_scene)
 {
-    scenes.emplace(scene_id, _scene);
+    StringId key(scene_id);
+    if (scene_ids.Find(key)) return;
+    scene_ids.Insert(key, scenes.emplace(scene_id, _scene).first);
 }
 
 void SceneManager::RemoveScene(const std::string &scene_id)
 {
-    auto it = scenes.find(scene_id);
-    if (it != scenes.end())
+    RemoveScene(StringId(scene_id));
+}
+
+void SceneManager::RemoveScene(StringId scene_id)
+{
+    auto *entry = scene_ids.Find(scene_id);
+    if (!entry) return;
+    if ((*entry)->second == activeScene)
     {
-        delete it->second;
-        scenes.erase(it);
+        TraceLog(LOG_WARNING, "SCENE: Cannot remove active scene [%s]", (*entry)->first.c_str());
+        return;
     }
+    retired.push_back((*entry)->second);
+    scenes.erase(*entry);
+    scene_ids.Erase(scene_id);
+}
 
+Scene &SceneManager::FindScene(StringId scene_id) const
+{
+    auto *entry = scene_ids.Find(scene_id);
+    if (!entry)
+        ThrowNotFoundException(scene_id);
+    return *(*entry)->second;
 }
 
 void SceneManager::LoadScene(const std::string &scene_id)
 {
-    auto it = scenes.find(scene_id);
-    if (it == scenes.end())
+    LoadScene(StringId(scene_id));
+}
+
+void SceneManager::LoadScene(StringId scene_id)
+{
+    activeScene = &FindScene(scene_id);
+    outgoing    = nullptr;
+}
+
+void SceneManager::TransitionTo(const std::string &scene_id, TransitionType type, double duration)
+{
+    TransitionTo(StringId(scene_id), type, duration);
+}
+
+void SceneManager::TransitionTo(StringId scene_id, TransitionType type, double duration)
+{
+    Scene &target = FindScene(scene_id);
+    if (type == TransitionType::CUT || duration <= 0 || &target == activeScene)
     {
-        ThrowNotFoundException(scene_id);
+        LoadScene(scene_id);
+        return;
     }
-    else
+    outgoing            = activeScene;
+    activeScene         = &target;
+    transition_type     = type;
+    transition_duration = duration;
+    transition_elapsed  = 0;
+    outgoing_captured   = false;
+}
+
+bool SceneManager::IsTransitioning() const
+{
+    return outgoing != nullptr;
+}
+
+void SceneManager::SetTeardownBudget(double budget_ms)
+{
+    teardown_budget_ms = budget_ms;
+}
+
+void SceneManager::PreloadScene(const std::string &scene_id)
+{
+    PreloadScene(StringId(scene_id));
+}
+
+void SceneManager::PreloadScene(StringId scene_id)
+{
+    FindScene(scene_id).Preload();
+}
+
+float SceneManager::GetPreloadProgress(const std::string &scene_id) const
+{
+    return GetPreloadProgress(StringId(scene_id));
+}
+
+float SceneManager::GetPreloadProgress(StringId scene_id) const
+{
+    return FindScene(scene_id).GetPreloadProgress();
+}
+
+MemoryStats SceneManager::GetMemoryStats(const std::string &scene_id) const
+{
+    return GetMemoryStats(StringId(scene_id));
+}
+
+MemoryStats SceneManager::GetMemoryStats(StringId scene_id) const
+{
+    return FindScene(scene_id).GetMemoryStats();
+}
+
+MemoryStats SceneManager::GetMemoryStats() const
+{
+    MemoryStats stats;
+    TextureSet  textures;
+    for (const auto &scene : scenes)
+    {
+        scene.second->AccumulateMemory(stats, textures);
+    }
+    for (const Scene *scene : retired)
     {
-        activeScene = it->second;
+        scene->AccumulateMemory(stats, textures);
     }
+    textures.Add(outgoing_target.texture);
+    textures.Add(incoming_target.texture);
+    stats.textures      = textures.Count();
+    stats.texture_bytes = textures.Bytes();
+    return stats;
+}
+
+static void WriteMemoryLine(std::ofstream &file, const char *name, const MemoryStats &stats)
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %10zu %10zu %10zu %6zu %10zu %14zu %8zu %14zu\n", name, stats.objects, stats.heap_objects,
+                  stats.grouped_objects, stats.ui_containers, stats.ui_elements, stats.heap_bytes, stats.textures, stats.texture_bytes);
+    file << line;
+}
+
+bool SceneManager::DumpMemoryStats(const std::filesystem::path &path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        TraceLog(LOG_WARNING, "SCENE: Could not write memory snapshot %s", path.string().c_str());
+        return false;
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %10s %10s %10s %6s %10s %14s %8s %14s\n", "scene", "objects", "heap_objs", "grouped", "uis",
+                  "elements", "heap_bytes", "textures", "texture_bytes");
+    file << line;
+    for (const auto &scene : scenes)
+    {
+        // The active scene is marked with a star
+        std::string name = (scene.second == activeScene ? "*" : "") + scene.first;
+        WriteMemoryLine(file, name.c_str(), scene.second->GetMemoryStats());
+    }
+    for (const Scene *scene : retired)
+    {
+        WriteMemoryLine(file, "(removed)", scene->GetMemoryStats());
+    }
+    MemoryStats total = GetMemoryStats();
+    WriteMemoryLine(file, "total", total);
+
+    // Objects allocated with new are counted wherever they are, so the difference was allocated outside of any scene
+    size_t heap_count = GameObject::GetHeapCount();
+    file << "\nheap GameObject objects: " << heap_count << " (" << GameObject::GetHeapBytes() << " bytes), "
+         << (heap_count > total.heap_objects ? heap_count - total.heap_objects : 0) << " outside of any scene\n";
+
+    std::vector<TextureUsage> usage = resources.GetTextureUsage();
+    file << "\ncached textures: " << usage.size() << " (" << resources.GetTextureBytes() << " bytes)\n";
+    for (const TextureUsage &texture : usage)
+    {
+        std::snprintf(line, sizeof(line), "%14zu %5dx%-5d %4d refs  ", texture.bytes, texture.width, texture.height, texture.references);
+        file << line << texture.key << '\n';
+    }
+    return (bool)file;
+}
+
+void SceneManager::SetUploadBudget(double budget_ms)
+{
+    upload_budget_ms = budget_ms;
 }
 
 Scene &SceneManager::GetActiveScene()
@@ -167,12 +976,181 @@ const Scene &SceneManager::GetActiveScene() const
     return *activeScene;
 }
 
-void SceneManager::Draw() const
+void SceneManager::SetFixedRate(double steps_per_second, int max_steps)
 {
-    activeScene->Draw();
+    // Also rejects NaN, which would make every comparison in Tick() fail
+    if (!(steps_per_second > 0))
+    {
+        TraceLog(LOG_WARNING, "SCENE: Invalid fixed rate %f, keeping %f steps per second", steps_per_second, 1.0 / fixed_step);
+        return;
+    }
+    fixed_step         = 1.0 / steps_per_second;
+    max_steps_per_tick = std::max(1, max_steps);
 }
 
-void SceneManager::Update()
+double SceneManager::GetFixedStep() const
+{
+    return fixed_step;
+}
+
+void SceneManager::Draw(float alpha) const
+{
+    frame_clock.SetAlpha(alpha);
+    BeginDrawing();
+    {
+        // Ends before EndDrawing(), which waits for vsync
+        PROFILE_SCOPE("SceneManager::Draw");
+        if (outgoing)
+        {
+            DrawTransition();
+        }
+        else
+        {
+            PROFILE_SCOPE("Scene::Draw");
+            activeScene->Render();
+        }
+    }
+    EndDrawing();
+    profiler.EndFrame();
+}
+
+void SceneManager::DrawTransition() const
+{
+    int   width  = GetScreenWidth(), height = GetScreenHeight();
+    float w      = (float)width,     h      = (float)height;
+    if (outgoing_target.texture.width != width || outgoing_target.texture.height != height)
+        outgoing_captured = false;
+    FitRenderTarget(outgoing_target, width, height);
+    FitRenderTarget(incoming_target, width, height);
+
+    // The outgoing scene is frozen, so it only has to be rendered once
+    if (!outgoing_captured)
+    {
+        BeginRenderTarget(outgoing_target);
+            outgoing->Render();
+        EndRenderTarget();
+        outgoing_captured = true;
+    }
+    BeginRenderTarget(incoming_target);
+        activeScene->Render();
+    EndRenderTarget();
+
+    float t = (float)std::min(1.0, transition_elapsed / transition_duration);
+    t = t * t * (3 - 2 * t); // Smoothstep, so the transition eases in and out
+    Vector2 out_pos = {0, 0}, in_pos = {0, 0};
+    switch (transition_type)
+    {
+        case TransitionType::SLIDE_LEFT:  out_pos.x = -t * w; in_pos.x = (1 - t) * w;  break;
+        case TransitionType::SLIDE_RIGHT: out_pos.x =  t * w; in_pos.x = (t - 1) * w;  break;
+        case TransitionType::SLIDE_UP:    out_pos.y = -t * h; in_pos.y = (1 - t) * h;  break;
+        case TransitionType::SLIDE_DOWN:  out_pos.y =  t * h; in_pos.y = (t - 1) * h;  break;
+        default: break;
+    }
+    Color in_tint = transition_type == TransitionType::FADE ? Fade(WHITE, t) : WHITE;
+
+    ClearBackground(BLACK);
+    // Render textures are stored upside down
+    DrawTextureRec(outgoing_target.texture, Rectangle{0, 0, w, -h}, out_pos, WHITE);
+    DrawTextureRec(incoming_target.texture, Rectangle{0, 0, w, -h}, in_pos,  in_tint);
+}
+
+void SceneManager::Step(double dt)
 {
+    PROFILE_SCOPE("SceneManager::Update");
+    frame_clock.Advance(dt);
     activeScene->Update();
+    input_router.Consume();
+    if (outgoing)
+    {
+        transition_elapsed += dt;
+        if (transition_elapsed >= transition_duration) outgoing = nullptr;
+    }
+}
+
+void SceneManager::ProcessTeardown()
+{
+    PROFILE_SCOPE("SceneManager::ProcessTeardown");
+    auto start = std::chrono::steady_clock::now();
+    for (auto it = retired.begin(); it != retired.end();)
+    {
+        // Still drawn by the current transition
+        if (*it == outgoing)
+        {
+            ++it;
+            continue;
+        }
+        double spent = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (spent >= teardown_budget_ms) return;
+        if (!(*it)->Teardown(teardown_budget_ms - spent)) return;
+
+        // Only memory is left, which is released away from the main thread
+        {
+            std::lock_guard<std::mutex> lock(reaper_mutex);
+            if (!reaper.joinable()) reaper = std::thread(&SceneManager::Reap, this);
+            reaper_queue.push_back(*it);
+        }
+        reaper_wake.notify_one();
+        it = retired.erase(it);
+    }
+}
+
+void SceneManager::Reap()
+{
+    std::unique_lock<std::mutex> lock(reaper_mutex);
+    while (true)
+    {
+        reaper_wake.wait(lock, [this] { return reaper_stopping || !reaper_queue.empty(); });
+        if (reaper_queue.empty()) return;
+        Scene *scene = reaper_queue.back();
+        reaper_queue.pop_back();
+        lock.unlock();
+        delete scene;
+        lock.lock();
+    }
+}
+
+void SceneManager::Update()
+{
+    {
+        PROFILE_SCOPE("ResourceManager::ProcessReloads");
+        resources.ProcessReloads();
+    }
+    {
+        PROFILE_SCOPE("AssetLoader::ProcessUploads");
+        asset_loader.ProcessUploads(upload_budget_ms);
+    }
+    ProcessTeardown();
+    input_router.Sample();
+    Step(GetFrameTime());
+}
+
+void SceneManager::Tick(double dt)
+{
+    {
+        PROFILE_SCOPE("ResourceManager::ProcessReloads");
+        resources.ProcessReloads();
+    }
+    {
+        PROFILE_SCOPE("AssetLoader::ProcessUploads");
+        asset_loader.ProcessUploads(upload_budget_ms);
+    }
+    ProcessTeardown();
+    // Sampled once per frame. Presses and releases go to the first step, or wait for the next frame if no step runs
+    input_router.Sample();
+
+    accumulator += std::min(dt, fixed_step * max_steps_per_tick);
+    while (accumulator >= fixed_step)
+    {
+        Step(fixed_step);
+        accumulator -= fixed_step;
+    }
+    Draw((float)(accumulator / fixed_step));
+}
+
+void SceneManager::Run()
+{
+    while (!WindowShouldClose())
+    {
+        Tick(GetFrameTime());
+    }
 }
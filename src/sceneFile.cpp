@@ -0,0 +1,292 @@
+#include "sceneFile.hxx"
+#include "mappedFile.hxx"
+#include <algorithm>
+#include <fstream>
+
+SceneTypeRegistry scene_types;
+
+SceneTypeRegistry::SceneTypeRegistry()
+{
+    RegisterElement("UI::Button", [](UIContainer &ui, const SceneRecordView &record) {
+        return ui.Emplace<UI::Button>(record.id, std::string(record.resource), record.transform);
+    });
+    RegisterElement("UI::ImageDisplay", [](UIContainer &ui, const SceneRecordView &record) {
+        Vector2 origin = {0, 0};
+        record.Read(origin);
+        return ui.Emplace<UI::ImageDisplay>(record.id, std::string(record.resource), record.transform, origin);
+    });
+    RegisterElement("UI::Panel", [](UIContainer &ui, const SceneRecordView &record) {
+        Vector2  dimensions = {0, 0};
+        Color    col = WHITE, edge_col = WHITE;
+        uint32_t edge_thickness = 0;
+        record.Read(dimensions);
+        record.Read(col);
+        record.Read(edge_col);
+        record.Read(edge_thickness);
+        return ui.Emplace<UI::Panel>(record.id, record.transform, dimensions, col, edge_col, edge_thickness);
+    });
+}
+
+void SceneTypeRegistry::RegisterObject(const std::string &type, ObjectFactory factory)
+{
+    objects[type] = std::move(factory);
+}
+
+void SceneTypeRegistry::RegisterElement(const std::string &type, ElementFactory factory)
+{
+    elements[type] = std::move(factory);
+}
+
+const SceneTypeRegistry::ObjectFactory *SceneTypeRegistry::FindObject(const std::string &type) const
+{
+    auto it = objects.find(type);
+    return it != objects.end() ? &it->second : nullptr;
+}
+
+const SceneTypeRegistry::ElementFactory *SceneTypeRegistry::FindElement(const std::string &type) const
+{
+    auto it = elements.find(type);
+    return it != elements.end() ? &it->second : nullptr;
+}
+
+
+namespace
+{
+    /**
+     * @brief Sections of a scene file being written.
+     */
+    struct SceneWriter {
+        std::vector<uint32_t>                     types;
+        std::vector<uint32_t>                     preloads;
+        std::vector<SceneFile::ObjectRecord>      objects;
+        std::vector<SceneFile::ContainerRecord>   containers;
+        std::vector<SceneFile::ObjectRecord>      elements;
+        std::string                               strings;
+        std::vector<uint8_t>                      payload;
+        std::unordered_map<std::string, uint32_t> string_offsets; // Offsets of the strings already in `strings`.
+        std::unordered_map<std::string, uint32_t> type_indices;   // Indices of the types already in `types`.
+        size_t                                    skipped = 0;    // Objects that could not be saved.
+
+        uint32_t Intern(const std::string &text)
+        {
+            if (text.empty()) return SceneFile::NO_STRING;
+            auto it = string_offsets.find(text);
+            if (it != string_offsets.end()) return it->second;
+
+            uint32_t offset = (uint32_t)strings.size();
+            strings.append(text);
+            strings.push_back('\0');
+            string_offsets.emplace(text, offset);
+            return offset;
+        }
+        uint32_t TypeIndex(const std::string &type)
+        {
+            auto it = type_indices.find(type);
+            if (it != type_indices.end()) return it->second;
+
+            uint32_t index = (uint32_t)types.size();
+            types.push_back(Intern(type));
+            type_indices.emplace(type, index);
+            return index;
+        }
+        bool Add(const GameObject &object, const std::string *id, int draw_order, std::vector<SceneFile::ObjectRecord> &records)
+        {
+            SceneRecord record{std::string(), std::string(), object.GetTransform(), draw_order, {}};
+            if (!object.Save(record) || record.type.empty())
+            {
+                skipped++;
+                return false;
+            }
+
+            const Transform2D &t = record.transform;
+            records.push_back(SceneFile::ObjectRecord{TypeIndex(record.type), id ? Intern(*id) : SceneFile::NO_STRING, Intern(record.resource),
+                                                      record.draw_order, t.position.x, t.position.y, t.rotation, t.scale,
+                                                      (uint32_t)payload.size(), (uint32_t)record.payload.size()});
+            payload.insert(payload.end(), record.payload.begin(), record.payload.end());
+            return true;
+        }
+    };
+
+    template <typename T>
+    void WriteSection(std::ofstream &file, const std::vector<T> &section)
+    {
+        file.write(reinterpret_cast<const char*>(section.data()), section.size() * sizeof(T));
+    }
+}
+
+bool SceneFile::Save(const Scene &scene, const std::string &path)
+{
+    SceneWriter writer;
+    for (const std::string &preload : scene.preload_paths)
+    {
+        writer.preloads.push_back(writer.Intern(preload));
+    }
+    for (size_t i = 0; i < scene.objects.Size(); i++)
+    {
+        writer.Add(*scene.objects.begin()[i].object, scene.object_ids.FindKey(scene.objects.HandleAt(i)), 0, writer.objects);
+    }
+    for (const auto &entry : scene.interfaces)
+    {
+        const UIContainer &ui = *entry.second;
+        size_t first = writer.elements.size();
+        for (size_t i = 0; i < ui.elements.Size(); i++)
+        {
+            const UIElement &element = *ui.elements.begin()[i].object;
+            writer.Add(element, ui.element_ids.FindKey(ui.elements.HandleAt(i)), element.GetDrawOrder(), writer.elements);
+        }
+        writer.containers.push_back(ContainerRecord{writer.Intern(entry.first), ui.draw_order, (uint32_t)(writer.elements.size() - first),
+                                                    ui.cached ? 1u : 0u});
+    }
+    if (writer.skipped > 0)
+        TraceLog(LOG_WARNING, "SCENE: %zu objects can't be saved and were left out of %s", writer.skipped, path.c_str());
+
+    // Keeps the payload section 4 byte aligned
+    writer.strings.resize((writer.strings.size() + 3) & ~(size_t)3, '\0');
+
+    Header header = {{'R', 'S', 'C', 'N'}, VERSION,
+                     (uint32_t)writer.types.size(), (uint32_t)writer.preloads.size(), (uint32_t)writer.objects.size(),
+                     (uint32_t)writer.containers.size(), (uint32_t)writer.elements.size(),
+                     (uint32_t)writer.strings.size(), (uint32_t)writer.payload.size(), 0};
+
+    std::filesystem::path file_path = SCENES_PATH / path;
+    std::error_code error;
+    std::filesystem::create_directories(file_path.parent_path(), error);
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        TraceLog(LOG_WARNING, "SCENE: Could not write scene file %s", file_path.string().c_str());
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteSection(file, writer.types);
+    WriteSection(file, writer.preloads);
+    WriteSection(file, writer.objects);
+    WriteSection(file, writer.containers);
+    WriteSection(file, writer.elements);
+    file.write(writer.strings.data(), writer.strings.size());
+    WriteSection(file, writer.payload);
+    return (bool)file;
+}
+
+Scene *SceneFile::Load(const std::string &path)
+{
+    std::filesystem::path file_path = SCENES_PATH / path;
+    MappedFile file(file_path);
+    auto fail = [&file_path](const char *reason) -> Scene* {
+        TraceLog(LOG_WARNING, "SCENE: Could not load scene file %s: %s", file_path.string().c_str(), reason);
+        return nullptr;
+    };
+    if (!file.IsOpen()) return fail("file not found");
+
+    const uint8_t *data = file.Data();
+    Header header;
+    if (file.Size() < sizeof(Header)) return fail("file too short");
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, "RSCN", 4) != 0) return fail("not a scene file");
+    if (header.version != VERSION)                 return fail("unsupported version");
+
+    // Section offsets are computed in 64 bits, so corrupted counts can't wrap around
+    uint64_t offset = sizeof(Header);
+    auto section = [&offset](uint64_t bytes) { uint64_t start = offset; offset += bytes; return start; };
+    uint64_t types_at      = section(4ull * header.type_count);
+    uint64_t preloads_at   = section(4ull * header.preload_count);
+    uint64_t objects_at    = section((uint64_t)sizeof(ObjectRecord) * header.object_count);
+    uint64_t containers_at = section((uint64_t)sizeof(ContainerRecord) * header.container_count);
+    uint64_t elements_at   = section((uint64_t)sizeof(ObjectRecord) * header.element_count);
+    uint64_t strings_at    = section(header.string_bytes);
+    uint64_t payload_at    = section(header.payload_bytes);
+    if (offset > file.Size()) return fail("file truncated");
+    if (header.string_bytes > 0 && data[strings_at + header.string_bytes - 1] != '\0') return fail("malformed string table");
+
+    auto u32 = [data](uint64_t at) { uint32_t value; std::memcpy(&value, data + at, sizeof(value)); return value; };
+    auto text = [&](uint32_t at) { return at < header.string_bytes ? reinterpret_cast<const char*>(data + strings_at + at) : ""; };
+    auto view = [&](const ObjectRecord &record, SceneRecordView &result) {
+        if ((uint64_t)record.payload_offset + record.payload_size > header.payload_bytes) return false;
+        result = SceneRecordView{text(record.id), text(record.resource), Transform2D{{record.x, record.y}, record.rotation, record.scale},
+                                 record.draw_order, data + payload_at + record.payload_offset, record.payload_size, 0};
+        return true;
+    };
+
+    // Every type name is resolved once, records then only index into these
+    std::vector<const char*> type_names(header.type_count);
+    std::vector<const SceneTypeRegistry::ObjectFactory*>  object_factories(header.type_count);
+    std::vector<const SceneTypeRegistry::ElementFactory*> element_factories(header.type_count);
+    std::vector<bool> warned(header.type_count, false);
+    for (uint32_t i = 0; i < header.type_count; i++)
+    {
+        type_names[i]        = text(u32(types_at + 4ull * i));
+        object_factories[i]  = scene_types.FindObject(type_names[i]);
+        element_factories[i] = scene_types.FindElement(type_names[i]);
+    }
+    auto unknown = [&](uint32_t type) {
+        if (type >= header.type_count || warned[type]) return;
+        TraceLog(LOG_WARNING, "SCENE: Skipping objects of unregistered type %s in %s", type_names[type], path.c_str());
+        warned[type] = true;
+    };
+
+    Scene *scene = new Scene();
+    for (uint32_t i = 0; i < header.preload_count; i++)
+    {
+        scene->RegisterPreload(text(u32(preloads_at + 4ull * i)));
+    }
+
+    scene->objects.Reserve(header.object_count);
+    for (uint32_t i = 0; i < header.object_count; i++)
+    {
+        ObjectRecord record;
+        SceneRecordView record_view;
+        std::memcpy(&record, data + objects_at + sizeof(ObjectRecord) * (uint64_t)i, sizeof(ObjectRecord));
+        if (!view(record, record_view)) continue;
+        if (record.type >= header.type_count || !object_factories[record.type])
+        {
+            unknown(record.type);
+            continue;
+        }
+
+        Scene::ObjectHandle handle = (*object_factories[record.type])(*scene, record_view);
+        if (OwnedPtr<GameObject> *object = scene->objects.Get(handle))
+            object->object->GetTransform() = record_view.transform;
+    }
+    scene->RefreshSpatialIndex();
+
+    uint64_t element = 0;
+    for (uint32_t i = 0; i < header.container_count; i++)
+    {
+        ContainerRecord container;
+        std::memcpy(&container, data + containers_at + sizeof(ContainerRecord) * (uint64_t)i, sizeof(ContainerRecord));
+        uint64_t end = std::min<uint64_t>(element + container.element_count, header.element_count);
+
+        UIContainer *ui = new UIContainer();
+        ui->SetDrawOrder(container.draw_order);
+        ui->elements.Reserve(end - element);
+        for (; element < end; element++)
+        {
+            ObjectRecord record;
+            SceneRecordView record_view;
+            std::memcpy(&record, data + elements_at + sizeof(ObjectRecord) * element, sizeof(ObjectRecord));
+            if (!view(record, record_view)) continue;
+            if (record.type >= header.type_count || !element_factories[record.type])
+            {
+                unknown(record.type);
+                continue;
+            }
+
+            UIContainer::ElementHandle handle = (*element_factories[record.type])(*ui, record_view);
+            if (!handle.IsValid()) continue;
+            UIElement &loaded = ui->GetElement(handle);
+            loaded.GetTransform() = record_view.transform;
+            loaded.SetDrawOrder(record_view.draw_order);
+        }
+        ui->SetCached(container.flags & 1u);
+
+        std::string id = text(container.id);
+        if (scene->interfaces.count(id))
+        {
+            TraceLog(LOG_WARNING, "SCENE: Skipping duplicated container %s in %s", id.c_str(), path.c_str());
+            delete ui;
+            continue;
+        }
+        scene->AddUi(id, ui);
+    }
+    return scene;
+}
@@ -0,0 +1,167 @@
+#include "spatialHash.hxx"
+
+SpatialHash::SpatialHash(float _cell_size) : cell_size(_cell_size), count(0)
+{
+}
+
+SpatialHash::Entry *SpatialHash::Find(SlotHandle handle)
+{
+    if (handle.index >= entries.size()) return nullptr;
+    Entry &entry = entries[handle.index];
+    if (entry.placement == Placement::NONE || entry.handle != handle) return nullptr;
+    return &entry;
+}
+
+void SpatialHash::Unlink(Entry &entry)
+{
+    uint32_t index = entry.handle.index;
+    switch (entry.placement)
+    {
+        case Placement::CELLS:
+            for (int y = entry.range.y0; y <= entry.range.y1; y++)
+            {
+                for (int x = entry.range.x0; x <= entry.range.x1; x++)
+                {
+                    auto it = cells.find(CellKey(x, y));
+                    std::vector<uint32_t> &cell = it->second;
+                    for (size_t i = 0; i < cell.size(); i++)
+                    {
+                        if (cell[i] != index) continue;
+                        cell[i] = cell.back();
+                        cell.pop_back();
+                        break;
+                    }
+                    if (cell.empty()) cells.erase(it);
+                }
+            }
+            break;
+        case Placement::LARGE:
+        case Placement::UNBOUNDED:
+        {
+            std::vector<uint32_t> &list = entry.placement == Placement::LARGE ? large : unbounded;
+            uint32_t moved = list.back();
+            list[entry.list_index]     = moved;
+            entries[moved].list_index = entry.list_index;
+            list.pop_back();
+            break;
+        }
+        default:
+            break;
+    }
+    entry.placement = Placement::NONE;
+}
+
+bool SpatialHash::Set(SlotHandle handle, const Rectangle &bounds)
+{
+    if (handle.index >= entries.size())
+        entries.resize(handle.index + 1, Entry{SlotHandle{}, Rectangle{}, CellRange{}, Placement::NONE, 0});
+
+    Entry &entry = entries[handle.index];
+    if (entry.placement != Placement::NONE && entry.handle != handle)
+    {
+        // Stale entry from a removed object whose slot got reused
+        Unlink(entry);
+        count--;
+    }
+
+    CellRange range = RangeOf(bounds);
+    Placement placement = range.Count() > MAX_CELLS ? Placement::LARGE : Placement::CELLS;
+    if (entry.placement == placement && (placement == Placement::LARGE || entry.range == range))
+    {
+        bool moved = entry.bounds.x != bounds.x || entry.bounds.y != bounds.y
+                  || entry.bounds.width != bounds.width || entry.bounds.height != bounds.height;
+        entry.bounds = bounds;
+        return moved;
+    }
+
+    if (entry.placement == Placement::NONE) count++;
+    else                                    Unlink(entry);
+
+    entry.handle    = handle;
+    entry.bounds    = bounds;
+    entry.range     = range;
+    entry.placement = placement;
+    if (placement == Placement::LARGE)
+    {
+        entry.list_index = (uint32_t)large.size();
+        large.push_back(handle.index);
+        return true;
+    }
+    for (int y = range.y0; y <= range.y1; y++)
+    {
+        for (int x = range.x0; x <= range.x1; x++)
+        {
+            cells[CellKey(x, y)].push_back(handle.index);
+        }
+    }
+    return true;
+}
+
+bool SpatialHash::SetUnbounded(SlotHandle handle)
+{
+    if (handle.index >= entries.size())
+        entries.resize(handle.index + 1, Entry{SlotHandle{}, Rectangle{}, CellRange{}, Placement::NONE, 0});
+
+    Entry &entry = entries[handle.index];
+    if (entry.placement == Placement::UNBOUNDED && entry.handle == handle) return false;
+    if (entry.placement != Placement::NONE)
+    {
+        Unlink(entry);
+        count--;
+    }
+    entry.handle     = handle;
+    entry.placement  = Placement::UNBOUNDED;
+    entry.list_index = (uint32_t)unbounded.size();
+    unbounded.push_back(handle.index);
+    count++;
+    return true;
+}
+
+void SpatialHash::Remove(SlotHandle handle)
+{
+    Entry *entry = Find(handle);
+    if (!entry) return;
+    Unlink(*entry);
+    count--;
+}
+
+bool SpatialHash::Contains(SlotHandle handle) const
+{
+    return handle.index < entries.size() && entries[handle.index].placement != Placement::NONE && entries[handle.index].handle == handle;
+}
+
+void SpatialHash::Clear()
+{
+    entries.clear();
+    cells.clear();
+    large.clear();
+    unbounded.clear();
+    count = 0;
+}
+
+bool SpatialHash::IsUnbounded(SlotHandle handle) const
+{
+    return Contains(handle) && entries[handle.index].placement == Placement::UNBOUNDED;
+}
+
+size_t SpatialHash::Size() const
+{
+    return count;
+}
+
+size_t SpatialHash::UnboundedCount() const
+{
+    return unbounded.size();
+}
+
+size_t SpatialHash::ReservedBytes() const
+{
+    // Every cell is a hash node holding it's key and vector, on top of the vector's own storage
+    size_t bytes = entries.capacity() * sizeof(Entry) + (large.capacity() + unbounded.capacity()) * sizeof(uint32_t);
+    bytes += cells.bucket_count() * sizeof(void*);
+    for (const auto &cell : cells)
+    {
+        bytes += sizeof(cell) + sizeof(void*) + cell.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,156 @@
+#include "spriteBatch.hxx"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+SpriteBatch sprite_batch;
+
+SpriteBatch::SpriteBatch() : depth(0), layer(0), shader{}
+{
+}
+
+void SpriteBatch::Begin()
+{
+    depth++;
+}
+
+void SpriteBatch::End()
+{
+    if (depth == 0) return;
+    if (--depth == 0)
+    {
+        Flush();
+        layer  = 0;
+        shader = Shader{};
+    }
+}
+
+bool SpriteBatch::IsActive() const
+{
+    return depth > 0;
+}
+
+void SpriteBatch::SetLayer(int _layer)
+{
+    layer = _layer;
+}
+
+void SpriteBatch::SetShader(Shader _shader)
+{
+    shader = _shader;
+}
+
+Shader SpriteBatch::GetShader() const
+{
+    return shader;
+}
+
+void SpriteBatch::Draw(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (texture.id == 0) return;
+
+    // Same conventions as DrawTexturePro()
+    bool flipX = false;
+    if (source.width  < 0) { flipX = true; source.width *= -1; }
+    if (source.height < 0) source.y -= source.height;
+    if (dest.width    < 0) dest.width  *= -1;
+    if (dest.height   < 0) dest.height *= -1;
+
+    Quad quad;
+    if (rotation == 0.0f)
+    {
+        float x = dest.x - origin.x;
+        float y = dest.y - origin.y;
+        quad.corners[0] = {x,              y};
+        quad.corners[1] = {x,              y + dest.height};
+        quad.corners[2] = {x + dest.width, y + dest.height};
+        quad.corners[3] = {x + dest.width, y};
+    }
+    else
+    {
+        float sinR = std::sin(rotation * DEG2RAD);
+        float cosR = std::cos(rotation * DEG2RAD);
+        float dx   = -origin.x;
+        float dy   = -origin.y;
+        quad.corners[0] = {dest.x + dx*cosR - dy*sinR,                                  dest.y + dx*sinR + dy*cosR};
+        quad.corners[1] = {dest.x + dx*cosR - (dy + dest.height)*sinR,                  dest.y + dx*sinR + (dy + dest.height)*cosR};
+        quad.corners[2] = {dest.x + (dx + dest.width)*cosR - (dy + dest.height)*sinR,   dest.y + (dx + dest.width)*sinR + (dy + dest.height)*cosR};
+        quad.corners[3] = {dest.x + (dx + dest.width)*cosR - dy*sinR,                   dest.y + (dx + dest.width)*sinR + dy*cosR};
+    }
+
+    float left   = source.x / texture.width;
+    float right  = (source.x + source.width) / texture.width;
+    quad.u0      = flipX ? right : left;
+    quad.u1      = flipX ? left  : right;
+    quad.v0      = source.y / texture.height;
+    quad.v1      = (source.y + source.height) / texture.height;
+    quad.tint    = tint;
+    quad.texture = texture.id;
+    quad.shader  = shader;
+    quad.layer   = layer;
+    quads.push_back(quad);
+}
+
+void SpriteBatch::Flush()
+{
+    if (quads.empty()) return;
+
+    order.resize(quads.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const Quad &qa = quads[a], &qb = quads[b];
+        if (qa.layer     != qb.layer)     return qa.layer     < qb.layer;
+        if (qa.shader.id != qb.shader.id) return qa.shader.id < qb.shader.id;
+        return qa.texture < qb.texture;
+    });
+
+    unsigned int active_shader  = 0;
+    unsigned int active_texture = 0;
+    bool         open           = false;
+    for (size_t index : order)
+    {
+        const Quad &quad = quads[index];
+        if (quad.shader.id != active_shader || quad.texture != active_texture)
+        {
+            if (open)
+            {
+                rlEnd();
+                rlSetTexture(0);
+                open = false;
+            }
+            if (quad.shader.id != active_shader)
+            {
+                if (active_shader != 0) EndShaderMode();
+                if (quad.shader.id != 0) BeginShaderMode(quad.shader);
+                active_shader = quad.shader.id;
+            }
+            active_texture = quad.texture;
+            rlSetTexture(active_texture);
+            rlBegin(RL_QUADS);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+            open = true;
+        }
+
+        rlColor4ub(quad.tint.r, quad.tint.g, quad.tint.b, quad.tint.a);
+        rlTexCoord2f(quad.u0, quad.v0); rlVertex2f(quad.corners[0].x, quad.corners[0].y);
+        rlTexCoord2f(quad.u0, quad.v1); rlVertex2f(quad.corners[1].x, quad.corners[1].y);
+        rlTexCoord2f(quad.u1, quad.v1); rlVertex2f(quad.corners[2].x, quad.corners[2].y);
+        rlTexCoord2f(quad.u1, quad.v0); rlVertex2f(quad.corners[3].x, quad.corners[3].y);
+    }
+    if (open)
+    {
+        rlEnd();
+        rlSetTexture(0);
+    }
+    if (active_shader != 0) EndShaderMode();
+
+    quads.clear();
+}
+
+void DrawSprite(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (sprite_batch.IsActive())
+        sprite_batch.Draw(texture, source, dest, origin, rotation, tint);
+    else
+        DrawTexturePro(texture, source, dest, origin, rotation, tint);
+}
@@ -0,0 +1,84 @@
+#include "streamingBudget.hxx"
+
+StreamingBudget streaming_budget;
+
+StreamingBudget::StreamingBudget() : budget(DEFAULT_BUDGET), resident(0)
+{
+}
+
+void StreamingBudget::SetBudget(size_t bytes)
+{
+    budget = bytes;
+}
+
+size_t StreamingBudget::GetBudget() const
+{
+    return budget;
+}
+
+size_t StreamingBudget::GetResident() const
+{
+    return resident;
+}
+
+bool StreamingBudget::Fits(size_t bytes) const
+{
+    return resident <= budget && bytes <= budget - resident;
+}
+
+bool StreamingBudget::IsExceeded() const
+{
+    return resident > budget;
+}
+
+void StreamingBudget::Charge(size_t bytes)
+{
+    resident += bytes;
+}
+
+void StreamingBudget::Discharge(size_t bytes)
+{
+    resident = bytes < resident ? resident - bytes : 0;
+}
+
+StreamingCharge::StreamingCharge() : bytes(0)
+{
+}
+
+StreamingCharge::StreamingCharge(const StreamingCharge &other) : bytes(0)
+{
+    Add(other.bytes);
+}
+
+StreamingCharge &StreamingCharge::operator=(const StreamingCharge &other)
+{
+    if (this != &other)
+    {
+        Remove(bytes);
+        Add(other.bytes);
+    }
+    return *this;
+}
+
+StreamingCharge::~StreamingCharge()
+{
+    Remove(bytes);
+}
+
+void StreamingCharge::Add(size_t _bytes)
+{
+    bytes += _bytes;
+    streaming_budget.Charge(_bytes);
+}
+
+void StreamingCharge::Remove(size_t _bytes)
+{
+    if (_bytes > bytes) _bytes = bytes;
+    bytes -= _bytes;
+    streaming_budget.Discharge(_bytes);
+}
+
+size_t StreamingCharge::Get() const
+{
+    return bytes;
+}
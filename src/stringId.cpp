@@ -0,0 +1,51 @@
+#include "stringId.hxx"
+#include "globals.hxx"
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef RGAME_STRING_ID_NAMES
+// Constructed on first use, so ids hashed during static initialization find it
+static std::mutex &NamesMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+static std::unordered_map<uint64_t, std::string> &Names()
+{
+    static std::unordered_map<uint64_t, std::string> names;
+    return names;
+}
+#endif
+
+StringId::StringId(const std::string &text) : hash(Hash(text.data(), text.size()))
+{
+#ifdef RGAME_STRING_ID_NAMES
+    std::lock_guard<std::mutex> lock(NamesMutex());
+    // Most identifiers are hashed again on every lookup, so they are only copied the first time
+    auto it = Names().find(hash);
+    if (it == Names().end())
+        Names().emplace(hash, text);
+    else if (it->second != text)
+        TraceLog(LOG_WARNING, "STRINGID: \"%s\" and \"%s\" share the same hash", it->second.c_str(), text.c_str());
+#endif
+}
+
+std::string StringId::GetName() const
+{
+#ifdef RGAME_STRING_ID_NAMES
+    {
+        std::lock_guard<std::mutex> lock(NamesMutex());
+        auto it = Names().find(hash);
+        if (it != Names().end()) return it->second;
+    }
+#endif
+    char name[18];
+    std::snprintf(name, sizeof(name), "#%016llx", (unsigned long long)hash);
+    return name;
+}
+
+void ThrowNotFoundException(StringId id)
+{
+    ThrowNotFoundException(id.GetName());
+}
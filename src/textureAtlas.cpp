@@ -0,0 +1,110 @@
+#include "textureAtlas.hxx"
+#include <algorithm>
+#include <cmath>
+
+TextureAtlas::TextureAtlas(int _padding) : texture{}, padding(_padding), built(false)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (Image &image : images)
+    {
+        UnloadImage(image);
+    }
+    if (built)
+    {
+        UnloadTexture(texture);
+    }
+}
+
+int TextureAtlas::AddImage(Image image)
+{
+    images.push_back(image);
+    regions.push_back(Rectangle{0, 0, (float)image.width, (float)image.height});
+    return (int)images.size() - 1;
+}
+
+bool TextureAtlas::Build(int max_size)
+{
+    if (built || images.empty()) return built;
+
+    // Tallest images first, so every shelf wastes as little height as possible
+    std::vector<int> order(images.size());
+    long long area  = 0;
+    int       width = 0;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        order[i] = (int)i;
+        area    += (long long)(images[i].width + padding) * (images[i].height + padding);
+        width    = std::max(width, images[i].width + padding * 2);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return images[a].height > images[b].height; });
+
+    int side = 1;
+    while ((long long)side * side < area) side *= 2;
+    width = std::max(width, side);
+    if (width > max_size)
+    {
+        TraceLog(LOG_WARNING, "ATLAS: Images do not fit in a %ix%i atlas", max_size, max_size);
+        return false;
+    }
+
+    // Shelf packing
+    int x = padding, y = padding, shelf_height = 0;
+    for (int index : order)
+    {
+        const Image &image = images[index];
+        if (x + image.width + padding > width)
+        {
+            x = padding;
+            y += shelf_height + padding;
+            shelf_height = 0;
+        }
+        regions[index].x = (float)x;
+        regions[index].y = (float)y;
+        x += image.width + padding;
+        shelf_height = std::max(shelf_height, image.height);
+    }
+    int height = 1;
+    while (height < y + shelf_height + padding) height *= 2;
+    if (height > max_size)
+    {
+        TraceLog(LOG_WARNING, "ATLAS: Images do not fit in a %ix%i atlas", max_size, max_size);
+        return false;
+    }
+
+    Image canvas = GenImageColor(width, height, BLANK);
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        Rectangle source = {0, 0, (float)images[i].width, (float)images[i].height};
+        ImageDraw(&canvas, images[i], source, regions[i], WHITE);
+        UnloadImage(images[i]);
+    }
+    images.clear();
+
+    texture = LoadTextureFromImage(canvas);
+    UnloadImage(canvas);
+    built = true;
+    return true;
+}
+
+bool TextureAtlas::IsBuilt() const
+{
+    return built;
+}
+
+Texture2D TextureAtlas::GetTexture() const
+{
+    return texture;
+}
+
+Rectangle TextureAtlas::GetRegion(int index) const
+{
+    return regions[index];
+}
+
+int TextureAtlas::GetRegionCount() const
+{
+    return (int)regions.size();
+}
@@ -0,0 +1,470 @@
+#include "transformStore.hxx"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRANSFORM_STORE_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TRANSFORM_STORE_NEON
+#endif
+
+namespace
+{
+    template <typename T>
+    void SwapPop(std::vector<T> &values, size_t index)
+    {
+        values[index] = values.back();
+        values.pop_back();
+    }
+
+    template <typename T>
+    void Permute(std::vector<T> &values, const std::vector<uint32_t> &order, std::vector<T> &scratch)
+    {
+        scratch.resize(order.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            scratch[i] = values[order[i]];
+        }
+        values.swap(scratch);
+    }
+}
+
+TransformStore::TransformStore() : free_head(SlotHandle::INVALID_INDEX), root_count(0), child_count(0), order_dirty(false)
+{
+}
+
+bool TransformStore::IsLive(Handle handle) const
+{
+    return handle.index < slots.size()
+        && slots[handle.index].generation == handle.generation
+        && slots[handle.index].dense < owners.size()
+        && owners[slots[handle.index].dense] == handle.index;
+}
+
+TransformStore::Handle TransformStore::Create(Transform2D local, Vector2 size, Vector2 pivot)
+{
+    uint32_t slot;
+    if (free_head != SlotHandle::INVALID_INDEX)
+    {
+        slot      = free_head;
+        free_head = slots[slot].dense;
+    }
+    else
+    {
+        slot = slots.size();
+        slots.push_back(Slot{0, 0});
+    }
+    uint32_t index    = owners.size();
+    slots[slot].dense = index;
+    owners.push_back(slot);
+    parents.push_back(NO_PARENT);
+    parent_index.push_back(NO_PARENT);
+
+    local_x.push_back(local.position.x);
+    local_y.push_back(local.position.y);
+    local_rotation.push_back(local.rotation);
+    local_scale.push_back(local.scale);
+    width.push_back(size.x);
+    height.push_back(size.y);
+    pivot_x.push_back(pivot.x);
+    pivot_y.push_back(pivot.y);
+
+    // Roots are their own world transform, so bounds are right away correct for objects indexed when created
+    world_x.push_back(local.position.x);
+    world_y.push_back(local.position.y);
+    world_rotation.push_back(local.rotation);
+    world_scale.push_back(local.scale);
+    world_cos.push_back(std::cos(local.rotation * DEG2RAD));
+    world_sin.push_back(std::sin(local.rotation * DEG2RAD));
+    min_x.push_back(0);
+    min_y.push_back(0);
+    max_x.push_back(0);
+    max_y.push_back(0);
+    ComputeBounds(index, index + 1);
+
+    // Roots must come before all children
+    if (child_count > 0) order_dirty = true;
+    return Handle{slot, slots[slot].generation};
+}
+
+void TransformStore::SwapRemove(uint32_t index)
+{
+    uint32_t moved = owners.back();
+    SwapPop(local_x, index);
+    SwapPop(local_y, index);
+    SwapPop(local_rotation, index);
+    SwapPop(local_scale, index);
+    SwapPop(width, index);
+    SwapPop(height, index);
+    SwapPop(pivot_x, index);
+    SwapPop(pivot_y, index);
+    SwapPop(world_x, index);
+    SwapPop(world_y, index);
+    SwapPop(world_rotation, index);
+    SwapPop(world_scale, index);
+    SwapPop(world_cos, index);
+    SwapPop(world_sin, index);
+    SwapPop(min_x, index);
+    SwapPop(min_y, index);
+    SwapPop(max_x, index);
+    SwapPop(max_y, index);
+    SwapPop(parents, index);
+    SwapPop(parent_index, index);
+    SwapPop(owners, index);
+    if (index < owners.size())
+        slots[moved].dense = index;
+}
+
+void TransformStore::Remove(Handle handle)
+{
+    if (!IsLive(handle)) return;
+    uint32_t index = slots[handle.index].dense;
+
+    if (parents[index] != NO_PARENT) child_count--;
+    if (child_count > 0)
+    {
+        for (uint32_t &parent : parents)
+        {
+            if (parent != handle.index) continue;
+            parent = NO_PARENT;
+            child_count--;
+        }
+    }
+    SwapRemove(index);
+
+    slots[handle.index].generation++;
+    slots[handle.index].dense = free_head;
+    free_head                 = handle.index;
+    order_dirty               = child_count > 0;
+}
+
+bool TransformStore::Contains(Handle handle) const
+{
+    return IsLive(handle);
+}
+
+size_t TransformStore::Size() const
+{
+    return owners.size();
+}
+
+size_t TransformStore::ReservedBytes() const
+{
+    size_t bytes = slots.capacity() * sizeof(Slot);
+    for (const std::vector<float> *array : {&local_x, &local_y, &local_rotation, &local_scale, &width, &height, &pivot_x, &pivot_y,
+                                            &world_x, &world_y, &world_rotation, &world_scale, &world_cos, &world_sin,
+                                            &min_x, &min_y, &max_x, &max_y, &scratch})
+    {
+        bytes += array->capacity() * sizeof(float);
+    }
+    for (const std::vector<uint32_t> *array : {&parents, &parent_index, &owners, &order, &depths})
+    {
+        bytes += array->capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+void TransformStore::Clear()
+{
+    for (uint32_t slot : owners)
+    {
+        slots[slot].generation++;
+        slots[slot].dense = free_head;
+        free_head         = slot;
+    }
+    for (std::vector<float> *array : {&local_x, &local_y, &local_rotation, &local_scale, &width, &height, &pivot_x, &pivot_y,
+                                      &world_x, &world_y, &world_rotation, &world_scale, &world_cos, &world_sin,
+                                      &min_x, &min_y, &max_x, &max_y})
+    {
+        array->clear();
+    }
+    parents.clear();
+    parent_index.clear();
+    owners.clear();
+    root_count  = 0;
+    child_count = 0;
+    order_dirty = false;
+}
+
+bool TransformStore::SetParent(Handle child, Handle parent)
+{
+    if (!IsLive(child)) return false;
+    if (parent.IsValid())
+    {
+        if (!IsLive(parent)) return false;
+        // Refuse cycles: the new parent can't be the child itself, nor any of it's descendants
+        for (uint32_t slot = parent.index; slot != NO_PARENT; slot = parents[slots[slot].dense])
+        {
+            if (slot == child.index) return false;
+        }
+    }
+
+    uint32_t &current = parents[slots[child.index].dense];
+    uint32_t  updated = parent.IsValid() ? parent.index : NO_PARENT;
+    if (current == updated) return true;
+    if (current == NO_PARENT) child_count++;
+    if (updated == NO_PARENT) child_count--;
+    current     = updated;
+    order_dirty = true;
+    return true;
+}
+
+TransformStore::Handle TransformStore::GetParent(Handle handle) const
+{
+    if (!IsLive(handle)) return Handle{};
+    uint32_t parent = parents[slots[handle.index].dense];
+    if (parent == NO_PARENT) return Handle{};
+    return Handle{parent, slots[parent].generation};
+}
+
+void TransformStore::SetLocal(Handle handle, Transform2D local)
+{
+    if (!IsLive(handle)) return;
+    uint32_t index        = slots[handle.index].dense;
+    local_x[index]        = local.position.x;
+    local_y[index]        = local.position.y;
+    local_rotation[index] = local.rotation;
+    local_scale[index]    = local.scale;
+}
+
+Transform2D TransformStore::GetLocal(Handle handle) const
+{
+    if (!IsLive(handle)) return Transform2D{};
+    uint32_t index = slots[handle.index].dense;
+    return Transform2D{{local_x[index], local_y[index]}, local_rotation[index], local_scale[index]};
+}
+
+void TransformStore::SetPosition(Handle handle, Vector2 position)
+{
+    if (!IsLive(handle)) return;
+    uint32_t index = slots[handle.index].dense;
+    local_x[index] = position.x;
+    local_y[index] = position.y;
+}
+
+void TransformStore::SetSize(Handle handle, Vector2 size, Vector2 pivot)
+{
+    if (!IsLive(handle)) return;
+    uint32_t index = slots[handle.index].dense;
+    width[index]   = size.x;
+    height[index]  = size.y;
+    pivot_x[index] = pivot.x;
+    pivot_y[index] = pivot.y;
+}
+
+Transform2D TransformStore::GetWorld(Handle handle) const
+{
+    if (!IsLive(handle)) return Transform2D{};
+    return GetWorldAt(slots[handle.index].dense);
+}
+
+Rectangle TransformStore::GetBounds(Handle handle) const
+{
+    if (!IsLive(handle)) return Rectangle{};
+    return GetBoundsAt(slots[handle.index].dense);
+}
+
+void TransformStore::GetDrawRect(Handle handle, Rectangle &dest, Vector2 &origin) const
+{
+    if (!IsLive(handle))
+    {
+        dest   = Rectangle{};
+        origin = Vector2{};
+        return;
+    }
+    uint32_t index = slots[handle.index].dense;
+    float    w     = width[index]  * world_scale[index];
+    float    h     = height[index] * world_scale[index];
+    dest   = Rectangle{world_x[index], world_y[index], w, h};
+    origin = Vector2{pivot_x[index] * w, pivot_y[index] * h};
+}
+
+size_t TransformStore::GetIndex(Handle handle) const
+{
+    return IsLive(handle) ? slots[handle.index].dense : owners.size();
+}
+
+TransformStore::Handle TransformStore::GetHandle(size_t index) const
+{
+    uint32_t slot = owners[index];
+    return Handle{slot, slots[slot].generation};
+}
+
+Transform2D TransformStore::GetWorldAt(size_t index) const
+{
+    return Transform2D{{world_x[index], world_y[index]}, world_rotation[index], world_scale[index]};
+}
+
+Rectangle TransformStore::GetBoundsAt(size_t index) const
+{
+    return Rectangle{min_x[index], min_y[index], max_x[index] - min_x[index], max_y[index] - min_y[index]};
+}
+
+void TransformStore::Sort()
+{
+    size_t count = owners.size();
+    // Depth of every entry, walking up to the first entry of known depth and assigning depths on the way back down
+    depths.assign(count, NO_PARENT);
+    uint32_t max_depth = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        order.clear();
+        uint32_t current = i;
+        while (depths[current] == NO_PARENT && parents[current] != NO_PARENT)
+        {
+            order.push_back(current);
+            current = slots[parents[current]].dense;
+        }
+        uint32_t depth = depths[current] == NO_PARENT ? 0 : depths[current];
+        depths[current] = depth;
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+        {
+            depths[*it] = ++depth;
+        }
+        max_depth = std::max(max_depth, depth);
+    }
+
+    // Stable counting sort by depth, so parents come before their children and roots keep their relative order
+    std::vector<uint32_t> offsets(max_depth + 2, 0);
+    for (uint32_t depth : depths)
+    {
+        offsets[depth + 1]++;
+    }
+    for (size_t depth = 1; depth < offsets.size(); depth++)
+    {
+        offsets[depth] += offsets[depth - 1];
+    }
+    root_count = offsets[1];
+    order.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        order[offsets[depths[i]]++] = i;
+    }
+
+    // World arrays are recomputed right after sorting, only inputs need to move
+    for (std::vector<float> *array : {&local_x, &local_y, &local_rotation, &local_scale, &width, &height, &pivot_x, &pivot_y})
+    {
+        Permute(*array, order, scratch);
+    }
+    Permute(parents, order, depths);
+    Permute(owners, order, depths);
+    for (size_t i = 0; i < count; i++)
+    {
+        slots[owners[i]].dense = i;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        parent_index[i] = parents[i] == NO_PARENT ? NO_PARENT : slots[parents[i]].dense;
+    }
+}
+
+void TransformStore::Update()
+{
+    size_t count = owners.size();
+    if (child_count == 0)
+    {
+        root_count  = count;
+        order_dirty = false;
+    }
+    else if (order_dirty)
+    {
+        Sort();
+        order_dirty = false;
+    }
+
+    // Roots are their own world transform
+    std::copy(local_x.begin(),        local_x.begin()        + root_count, world_x.begin());
+    std::copy(local_y.begin(),        local_y.begin()        + root_count, world_y.begin());
+    std::copy(local_rotation.begin(), local_rotation.begin() + root_count, world_rotation.begin());
+    std::copy(local_scale.begin(),    local_scale.begin()    + root_count, world_scale.begin());
+    for (size_t i = 0; i < root_count; i++)
+    {
+        world_cos[i] = std::cos(world_rotation[i] * DEG2RAD);
+        world_sin[i] = std::sin(world_rotation[i] * DEG2RAD);
+    }
+
+    // Children come after their parents, whose world transform is therefore already computed
+    for (size_t i = root_count; i < count; i++)
+    {
+        uint32_t parent = parent_index[i];
+        float    c      = world_cos[parent], s = world_sin[parent], scale = world_scale[parent];
+        world_x[i]        = world_x[parent] + scale * (c * local_x[i] - s * local_y[i]);
+        world_y[i]        = world_y[parent] + scale * (s * local_x[i] + c * local_y[i]);
+        world_rotation[i] = world_rotation[parent] + local_rotation[i];
+        world_scale[i]    = scale * local_scale[i];
+        world_cos[i]      = std::cos(world_rotation[i] * DEG2RAD);
+        world_sin[i]      = std::sin(world_rotation[i] * DEG2RAD);
+    }
+
+    ComputeBounds(0, count);
+}
+
+void TransformStore::ComputeBounds(size_t begin, size_t end)
+{
+    // The center of the rotated rectangle is found from the pivot, and it's half extents from the absolute cosine and sine
+    size_t i = begin;
+#if defined(TRANSFORM_STORE_SSE2)
+    const __m128 half     = _mm_set1_ps(0.5f);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 scale = _mm_loadu_ps(&world_scale[i]);
+        __m128 w     = _mm_mul_ps(_mm_loadu_ps(&width[i]),  scale);
+        __m128 h     = _mm_mul_ps(_mm_loadu_ps(&height[i]), scale);
+        __m128 c     = _mm_loadu_ps(&world_cos[i]);
+        __m128 s     = _mm_loadu_ps(&world_sin[i]);
+        __m128 ox    = _mm_mul_ps(_mm_sub_ps(half, _mm_loadu_ps(&pivot_x[i])), w);
+        __m128 oy    = _mm_mul_ps(_mm_sub_ps(half, _mm_loadu_ps(&pivot_y[i])), h);
+        __m128 cx    = _mm_add_ps(_mm_loadu_ps(&world_x[i]), _mm_sub_ps(_mm_mul_ps(c, ox), _mm_mul_ps(s, oy)));
+        __m128 cy    = _mm_add_ps(_mm_loadu_ps(&world_y[i]), _mm_add_ps(_mm_mul_ps(s, ox), _mm_mul_ps(c, oy)));
+        __m128 ac    = _mm_and_ps(c, abs_mask);
+        __m128 as    = _mm_and_ps(s, abs_mask);
+        __m128 ex    = _mm_and_ps(_mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(ac, w), _mm_mul_ps(as, h))), abs_mask);
+        __m128 ey    = _mm_and_ps(_mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(as, w), _mm_mul_ps(ac, h))), abs_mask);
+        _mm_storeu_ps(&min_x[i], _mm_sub_ps(cx, ex));
+        _mm_storeu_ps(&min_y[i], _mm_sub_ps(cy, ey));
+        _mm_storeu_ps(&max_x[i], _mm_add_ps(cx, ex));
+        _mm_storeu_ps(&max_y[i], _mm_add_ps(cy, ey));
+    }
+#elif defined(TRANSFORM_STORE_NEON)
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 4 <= end; i += 4)
+    {
+        float32x4_t scale = vld1q_f32(&world_scale[i]);
+        float32x4_t w     = vmulq_f32(vld1q_f32(&width[i]),  scale);
+        float32x4_t h     = vmulq_f32(vld1q_f32(&height[i]), scale);
+        float32x4_t c     = vld1q_f32(&world_cos[i]);
+        float32x4_t s     = vld1q_f32(&world_sin[i]);
+        float32x4_t ox    = vmulq_f32(vsubq_f32(half, vld1q_f32(&pivot_x[i])), w);
+        float32x4_t oy    = vmulq_f32(vsubq_f32(half, vld1q_f32(&pivot_y[i])), h);
+        float32x4_t cx    = vaddq_f32(vld1q_f32(&world_x[i]), vsubq_f32(vmulq_f32(c, ox), vmulq_f32(s, oy)));
+        float32x4_t cy    = vaddq_f32(vld1q_f32(&world_y[i]), vaddq_f32(vmulq_f32(s, ox), vmulq_f32(c, oy)));
+        float32x4_t ac    = vabsq_f32(c);
+        float32x4_t as    = vabsq_f32(s);
+        float32x4_t ex    = vabsq_f32(vmulq_f32(half, vaddq_f32(vmulq_f32(ac, w), vmulq_f32(as, h))));
+        float32x4_t ey    = vabsq_f32(vmulq_f32(half, vaddq_f32(vmulq_f32(as, w), vmulq_f32(ac, h))));
+        vst1q_f32(&min_x[i], vsubq_f32(cx, ex));
+        vst1q_f32(&min_y[i], vsubq_f32(cy, ey));
+        vst1q_f32(&max_x[i], vaddq_f32(cx, ex));
+        vst1q_f32(&max_y[i], vaddq_f32(cy, ey));
+    }
+#endif
+    for (; i < end; i++)
+    {
+        float w  = width[i]  * world_scale[i];
+        float h  = height[i] * world_scale[i];
+        float c  = world_cos[i], s = world_sin[i];
+        float ox = (0.5f - pivot_x[i]) * w;
+        float oy = (0.5f - pivot_y[i]) * h;
+        float cx = world_x[i] + c * ox - s * oy;
+        float cy = world_y[i] + s * ox + c * oy;
+        float ex = std::fabs(0.5f * (std::fabs(c) * w + std::fabs(s) * h));
+        float ey = std::fabs(0.5f * (std::fabs(s) * w + std::fabs(c) * h));
+        min_x[i] = cx - ex;
+        min_y[i] = cy - ey;
+        max_x[i] = cx + ex;
+        max_y[i] = cy + ey;
+    }
+}
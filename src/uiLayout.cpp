@@ -0,0 +1,332 @@
+#include "uiLayout.hxx"
+#include "UI.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Whether a node's size along one axis comes from it's content
+static bool FitsContent(const LayoutStyle &style, int axis)
+{
+    float size = axis == 0 ? style.size.x : style.size.y;
+    float fill = axis == 0 ? style.fill.x : style.fill.y;
+    return size <= 0 && fill <= 0;
+}
+
+static bool SameRect(const Rectangle &a, const Rectangle &b)
+{
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+UILayout::UILayout(SlotMap<OwnedPtr<UIElement>> &_elements) : elements(_elements), screen{}, updating(false), visited(0)
+{
+}
+
+UILayout::Handle UILayout::Insert(const LayoutStyle &style, Handle parent, SlotHandle element)
+{
+    if (parent.IsValid() && !nodes.Contains(parent))
+        return Handle{};
+
+    Handle handle = nodes.Insert(Node{style, parent, {}, element, Vector2{0, 0}, Rectangle{}, false, true, true});
+    if (parent.IsValid())
+    {
+        nodes.Get(parent)->children.push_back(handle);
+        MarkDirty(parent, true);
+    }
+    else
+    {
+        roots.push_back(handle);
+    }
+    return handle;
+}
+
+UILayout::Handle UILayout::Add(const LayoutStyle &style, Handle parent)
+{
+    return Insert(style, parent, SlotHandle{});
+}
+
+UILayout::Handle UILayout::Attach(SlotHandle element, const LayoutStyle &style, Handle parent)
+{
+    OwnedPtr<UIElement> *owned = elements.Get(element);
+    if (!owned || (parent.IsValid() && !nodes.Contains(parent)))
+        return Handle{};
+
+    Detach(owned->object->layout_node);
+    Handle handle = Insert(style, parent, element);
+    owned->object->layout_node = handle;
+    return handle;
+}
+
+void UILayout::Erase(Handle handle)
+{
+    Node *node = nodes.Get(handle);
+    if (!node) return;
+    for (Handle child : std::vector<Handle>(std::move(node->children)))
+    {
+        Erase(child);
+    }
+    node = nodes.Get(handle);
+    if (OwnedPtr<UIElement> *owned = elements.Get(node->element))
+        owned->object->layout_node = Handle{};
+    nodes.Erase(handle);
+}
+
+void UILayout::Remove(Handle handle)
+{
+    Node *node = nodes.Get(handle);
+    if (!node) return;
+
+    Handle parent = node->parent;
+    std::vector<Handle> &siblings = parent.IsValid() ? nodes.Get(parent)->children : roots;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), handle));
+    Erase(handle);
+    if (parent.IsValid()) MarkDirty(parent, true);
+}
+
+bool UILayout::Contains(Handle handle) const
+{
+    return nodes.Contains(handle);
+}
+
+size_t UILayout::Size() const
+{
+    return nodes.Size();
+}
+
+void UILayout::SetStyle(Handle handle, const LayoutStyle &style)
+{
+    Node *node = nodes.Get(handle);
+    if (!node) return;
+    node->style = style;
+    MarkDirty(handle, true);
+    // The node may move inside it's parent even if it's size did not change
+    if (node->parent.IsValid()) MarkDirty(node->parent, false);
+}
+
+const LayoutStyle &UILayout::GetStyle(Handle handle) const
+{
+    const Node *node = nodes.Get(handle);
+    if (!node)
+        ThrowNotFoundException("#" + std::to_string(handle.index));
+    return node->style;
+}
+
+Rectangle UILayout::GetRect(Handle handle) const
+{
+    const Node *node = nodes.Get(handle);
+    return node ? node->rect : Rectangle{};
+}
+
+void UILayout::Invalidate(Handle handle)
+{
+    MarkDirty(handle, true);
+}
+
+void UILayout::InvalidateAll()
+{
+    for (Node &node : nodes)
+    {
+        node.dirty         = true;
+        node.measure_dirty = true;
+    }
+}
+
+size_t UILayout::GetVisitedCount() const
+{
+    return visited;
+}
+
+void UILayout::MarkDirty(Handle handle, bool remeasure)
+{
+    // Ancestors of a dirty node are dirty too, so marking stops at the first one already flagged
+    for (Node *node = nodes.Get(handle); node; node = nodes.Get(node->parent))
+    {
+        if (node->dirty && (!remeasure || node->measure_dirty)) return;
+        node->dirty = true;
+        if (remeasure) node->measure_dirty = true;
+        // Nodes with a fixed size don't grow or shrink with their content, so their parent only has to rearrange them
+        remeasure = remeasure && (FitsContent(node->style, 0) || FitsContent(node->style, 1));
+    }
+}
+
+void UILayout::ContentChanged(Handle handle)
+{
+    if (!updating) MarkDirty(handle, true);
+}
+
+void UILayout::Detach(Handle handle)
+{
+    Node *node = nodes.Get(handle);
+    if (!node) return;
+    node->element = SlotHandle{};
+    MarkDirty(handle, true);
+}
+
+Vector2 UILayout::Measure(Handle handle)
+{
+    Node *node = nodes.Get(handle);
+    if (!node->measure_dirty) return node->measured;
+
+    const LayoutStyle &style = node->style;
+    Vector2 content = {0, 0};
+    if (OwnedPtr<UIElement> *owned = elements.Get(node->element))
+        content = owned->object->GetLayoutSize();
+
+    // Children are measured first, `node` stays valid since no node is added meanwhile
+    Vector2 stacked = {0, 0}, cell = {0, 0};
+    size_t  count   = node->children.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        Handle  child = node->children[i];
+        Vector2 size  = Measure(child);
+        Vector2 shift = nodes.Get(child)->style.offset;
+        switch (style.type)
+        {
+            case LayoutType::COLUMN:
+                stacked = Vector2{std::max(stacked.x, size.x), stacked.y + size.y};
+                break;
+            case LayoutType::ROW:
+                stacked = Vector2{stacked.x + size.x, std::max(stacked.y, size.y)};
+                break;
+            case LayoutType::GRID:
+                cell = Vector2{std::max(cell.x, size.x), std::max(cell.y, size.y)};
+                break;
+            default: // case LayoutType::ANCHOR:
+                stacked = Vector2{std::max(stacked.x, size.x + std::fabs(shift.x)), std::max(stacked.y, size.y + std::fabs(shift.y))};
+                break;
+        }
+    }
+    if (count > 0 && style.type == LayoutType::COLUMN) stacked.y += style.spacing * (count - 1);
+    if (count > 0 && style.type == LayoutType::ROW)    stacked.x += style.spacing * (count - 1);
+    if (count > 0 && style.type == LayoutType::GRID)
+    {
+        size_t columns = std::min(count, (size_t)std::max(1, style.columns));
+        size_t rows    = (count + columns - 1) / columns;
+        stacked = Vector2{cell.x * columns + style.spacing * (columns - 1), cell.y * rows + style.spacing * (rows - 1)};
+    }
+    content = Vector2{std::max(content.x, stacked.x) + style.padding * 2, std::max(content.y, stacked.y) + style.padding * 2};
+
+    // Filled axes depend on the parent, and don't count as content, so filled children can't make their parent grow
+    node->measured.x = style.fill.x > 0 ? 0 : style.size.x > 0 ? style.size.x : content.x;
+    node->measured.y = style.fill.y > 0 ? 0 : style.size.y > 0 ? style.size.y : content.y;
+    node->measure_dirty = false;
+    return node->measured;
+}
+
+Vector2 UILayout::SlotSize(const Node &node, Vector2 available) const
+{
+    return Vector2{node.style.fill.x > 0 ? node.style.fill.x * available.x : node.measured.x,
+                   node.style.fill.y > 0 ? node.style.fill.y * available.y : node.measured.y};
+}
+
+void UILayout::Arrange(Handle handle, Rectangle slot)
+{
+    Node *node = nodes.Get(handle);
+    bool moved = !node->arranged || !SameRect(node->rect, slot);
+    node->rect     = slot;
+    node->arranged = true;
+    visited++;
+    if (moved)
+    {
+        if (OwnedPtr<UIElement> *owned = elements.Get(node->element))
+            owned->object->Place(slot);
+    }
+    if (!moved && !node->dirty) return;
+    node->dirty = false;
+
+    // Slots are computed for every child, but only the ones that moved or changed are visited. Nodes are neither added nor removed
+    // during an update, so references to them stay valid
+    const LayoutStyle &style = node->style;
+    const std::vector<Handle> &children = node->children;
+    Rectangle inner = {slot.x + style.padding, slot.y + style.padding,
+                       std::max(0.0f, slot.width - style.padding * 2), std::max(0.0f, slot.height - style.padding * 2)};
+    // Nodes below a fixed size ancestor are not remeasured along with it
+    for (Handle child : children)
+    {
+        Measure(child);
+    }
+    Vector2 available = {inner.width, inner.height};
+    Vector2 cursor    = {inner.x, inner.y};
+
+    Vector2 total = {0, 0};
+    if (style.type == LayoutType::COLUMN || style.type == LayoutType::ROW)
+    {
+        for (Handle child : children)
+        {
+            Vector2 size = SlotSize(*nodes.Get(child), available);
+            total = Vector2{total.x + size.x, total.y + size.y};
+        }
+        float gaps = style.spacing * (children.empty() ? 0 : children.size() - 1);
+        if (style.type == LayoutType::COLUMN) cursor.y += (inner.height - total.y - gaps) * style.justify;
+        else                                  cursor.x += (inner.width  - total.x - gaps) * style.justify;
+    }
+
+    size_t columns = (size_t)std::max(1, style.columns);
+    Vector2 cell   = {(inner.width - style.spacing * (columns - 1)) / columns, 0};
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        const Node &child = *nodes.Get(children[i]);
+        const LayoutStyle &placement = child.style;
+        Vector2   size = SlotSize(child, available);
+        Rectangle next;
+        switch (style.type)
+        {
+            case LayoutType::COLUMN:
+                next = Rectangle{inner.x + (inner.width - size.x) * placement.anchor.x + placement.offset.x, cursor.y + placement.offset.y, size.x, size.y};
+                cursor.y += size.y + style.spacing;
+                break;
+            case LayoutType::ROW:
+                next = Rectangle{cursor.x + placement.offset.x, inner.y + (inner.height - size.y) * placement.anchor.y + placement.offset.y, size.x, size.y};
+                cursor.x += size.x + style.spacing;
+                break;
+            case LayoutType::GRID:
+            {
+                // Every row is as tall as it's tallest child
+                if (i % columns == 0)
+                {
+                    if (i > 0) cursor.y += cell.y + style.spacing;
+                    cell.y = 0;
+                    for (size_t j = i; j < std::min(children.size(), i + columns); j++)
+                    {
+                        cell.y = std::max(cell.y, SlotSize(*nodes.Get(children[j]), Vector2{cell.x, available.y}).y);
+                    }
+                }
+                size = SlotSize(child, Vector2{cell.x, cell.y});
+                float x = inner.x + (cell.x + style.spacing) * (i % columns);
+                next = Rectangle{x + (cell.x - size.x) * placement.anchor.x + placement.offset.x,
+                                 cursor.y + (cell.y - size.y) * placement.anchor.y + placement.offset.y, size.x, size.y};
+                break;
+            }
+            default: // case LayoutType::ANCHOR:
+                next = Rectangle{inner.x + (inner.width  - size.x) * placement.anchor.x + placement.offset.x,
+                                 inner.y + (inner.height - size.y) * placement.anchor.y + placement.offset.y, size.x, size.y};
+                break;
+        }
+        if (child.dirty || !child.arranged || !SameRect(child.rect, next))
+            Arrange(children[i], next);
+    }
+}
+
+void UILayout::Update(Rectangle _screen)
+{
+    visited = 0;
+    if (!SameRect(screen, _screen))
+    {
+        // Everything placed relative to the screen is laid out again in this single pass
+        screen = _screen;
+        for (Handle root : roots)
+        {
+            nodes.Get(root)->dirty = true;
+        }
+    }
+    updating = true;
+    Vector2 available = {screen.width, screen.height};
+    for (Handle root : roots)
+    {
+        if (!nodes.Get(root)->dirty) continue;
+        Measure(root);
+        const Node &node = *nodes.Get(root);
+        Vector2 size = SlotSize(node, available);
+        Arrange(root, Rectangle{screen.x + (screen.width  - size.x) * node.style.anchor.x + node.style.offset.x,
+                                screen.y + (screen.height - size.y) * node.style.anchor.y + node.style.offset.y, size.x, size.y});
+    }
+    updating = false;
+}
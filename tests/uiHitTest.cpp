@@ -0,0 +1,78 @@
+#include "UI.hpp"
+#include <cstdio>
+
+/* Pointer routing checks for `UIContainer`, built and run with `make test`.
+ * Opens a hidden window, moves the mouse over overlapping elements and checks which of them takes the pointer. Prints one line
+ * per check and exits with a non-zero status if any of them failed.
+ */
+
+namespace
+{
+    int failures = 0;
+
+    void Check(bool condition, const char *name)
+    {
+        std::printf("%s %s\n", condition ? "PASS" : "FAIL", name);
+        if (!condition) failures++;
+    }
+
+    /**
+     * @brief Invisible interactive element covering a rectangle, counting the pointer events it receives.
+     */
+    class Overlay : public UIElement {
+    private:
+        Rectangle area;
+    public:
+        int events = 0;
+
+        explicit Overlay(Rectangle _area) : area(_area) {}
+
+        bool IsInteractive() const override { return true; }
+        bool GetBounds(Rectangle &bounds) const override { bounds = area; return true; }
+        void OnPointerEvent(PointerEvent) override { events++; }
+        void Update() override {}
+        void Draw() const override {}
+    };
+
+    /**
+     * @brief Move the mouse to @p point and run one update of @p ui, like `SceneManager::Tick()` does.
+     */
+    void PointAt(UIContainer &ui, Vector2 point)
+    {
+        SetMousePosition((int)point.x, (int)point.y);
+        input_router.Sample();
+        ui.Update();
+        input_router.Consume();
+    }
+}
+
+int main()
+{
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(640, 480, "rgame tests");
+
+    {
+        // Elements at MAX_DRAW_ORDER are not drawn, so they must not steal the pointer from a visible button below them
+        UIContainer ui;
+        Image image = GenImageColor(32, 32, WHITE);
+        UI::Button *button = new UI::Button(LoadTextureFromImage(image), Transform2D{Vector2{100, 100}, 0.0f, 1.0f});
+        UnloadImage(image);
+        ui.AddElement(button);
+        Overlay *overlay = new Overlay(Rectangle{0, 0, 640, 480});
+        overlay->SetDrawOrder(MAX_DRAW_ORDER);
+        ui.AddElement(overlay);
+
+        PointAt(ui, Vector2{100, 100});
+        Check(button->IsHover(), "button under a MAX_DRAW_ORDER element is hovered");
+        Check(overlay->events == 0, "MAX_DRAW_ORDER element receives no pointer events");
+
+        // Once drawn, the overlay is on top and takes the pointer
+        overlay->SetDrawOrder(MAX_DRAW_ORDER - 1);
+        PointAt(ui, Vector2{101, 100});
+        Check(!button->IsHover(), "button under a drawn element is not hovered");
+        Check(overlay->events == 1, "drawn element on top receives the pointer");
+    }
+
+    CloseWindow();
+    return failures == 0 ? 0 : 1;
+}